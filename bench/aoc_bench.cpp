@@ -0,0 +1,63 @@
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../common/benchmark.hpp"
+#include "../common/solvers.hpp"
+
+constexpr int DEFAULT_NUM_WARMUPS = 1;
+constexpr int DEFAULT_NUM_REPETITIONS = 10;
+
+/**
+ * Find a solver by its name
+ * @param name The name of the solver (e.g. day15)
+ * @return SolveFunction The solver
+ * @throws std::invalid_argument if there is no solver with this name
+ */
+SolveFunction findSolver(const std::string &name) {
+	auto solverIt = std::find_if(SOLVERS.cbegin(), SOLVERS.cend(), [&name](const auto &solver) {
+		return solver.first == name;
+	});
+	if (solverIt == SOLVERS.cend()) {
+		throw std::invalid_argument("No solver named " + name);
+	}
+
+	return solverIt->second;
+}
+
+int main(int argc, char *argv[]) {
+	int numWarmups = DEFAULT_NUM_WARMUPS;
+	int numRepetitions = DEFAULT_NUM_REPETITIONS;
+	// Pairs of solver name and input file
+	std::vector<std::pair<std::string, std::string>> runs;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--warmup" && i + 1 < argc) {
+			numWarmups = std::stoi(argv[++i]);
+		} else if (arg == "--repetitions" && i + 1 < argc) {
+			numRepetitions = std::stoi(argv[++i]);
+		} else if (arg.find('=') != std::string::npos) {
+			auto equalsIndex = arg.find('=');
+			runs.emplace_back(arg.substr(0, equalsIndex), arg.substr(equalsIndex + 1));
+		} else {
+			runs.clear();
+			break;
+		}
+	}
+
+	if (runs.empty()) {
+		std::cerr << argv[0] << " [--warmup n] [--repetitions n] <solver>=<input_file>..." << std::endl;
+		std::cerr << "e.g. " << argv[0] << " day15=day15/input.txt day23=day23/input.txt" << std::endl;
+		return 1;
+	}
+
+	std::cout << "{\"warmup\": " << numWarmups << ", \"repetitions\": " << numRepetitions << ", \"results\": [";
+	for (auto it = runs.cbegin(); it != runs.cend(); ++it) {
+		std::cout << (it == runs.cbegin() ? "\n" : ",\n");
+		benchmarkSolver(std::cout, it->first, findSolver(it->first), it->second, numWarmups, numRepetitions);
+	}
+
+	std::cout << "\n]}" << std::endl;
+}
@@ -0,0 +1,357 @@
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../common/arena.hpp"
+#include "../common/json.hpp"
+#include "../common/perf_counters.hpp"
+#include "../common/solvers.hpp"
+#include "../common/timing.hpp"
+
+constexpr int DEFAULT_NUM_REPETITIONS = 3;
+// How often the huge pages of a running phase are sampled
+constexpr auto HUGE_PAGE_SAMPLE_INTERVAL = std::chrono::milliseconds(10);
+
+/**
+ * How a single phase ran, with or without huge pages
+ */
+class ArenaPhaseResult {
+ public:
+	ArenaPhaseResult(std::string name, double nanoseconds, std::optional<long> dTLBMisses, long peakHugePageKiB)
+		: name(std::move(name)),
+		  nanoseconds(nanoseconds),
+		  dTLBMisses(dTLBMisses),
+		  peakHugePageKiB(peakHugePageKiB) {
+	}
+
+	const std::string &getName() const {
+		return this->name;
+	}
+
+	double getNanoseconds() const {
+		return this->nanoseconds;
+	}
+
+	/**
+	 * @return const std::optional<long>& The dTLB read misses of the phase, if they could be counted
+	 */
+	const std::optional<long> &getDTLBMisses() const {
+		return this->dTLBMisses;
+	}
+
+	/**
+	 * @return long The most anonymous memory that was backed by huge pages at any point in the phase
+	 */
+	long getPeakHugePageKiB() const {
+		return this->peakHugePageKiB;
+	}
+
+ private:
+	std::string name;
+	double nanoseconds;
+	std::optional<long> dTLBMisses;
+	long peakHugePageKiB;
+};
+
+/**
+ * @return long How much of this process's anonymous memory is backed by huge pages, or 0 if that can't be read
+ */
+long readAnonHugePageKiB() {
+	std::ifstream smaps("/proc/self/smaps_rollup");
+	std::string field;
+	while (smaps >> field) {
+		if (field == "AnonHugePages:") {
+			long kib = 0;
+			smaps >> kib;
+			return kib;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * A PhaseRunner that runs each phase once, counting its dTLB misses, and sampling how much of its memory is backed by
+ * huge pages while it runs
+ */
+class ArenaRunner : public PhaseRunner {
+ public:
+	const std::vector<ArenaPhaseResult> &getPhaseResults() const {
+		return this->phaseResults;
+	}
+
+	bool isCountingPerThread() const override {
+		// The dTLB misses are only counted on the thread that runs the phase
+		return true;
+	}
+
+ protected:
+	void runPhase(const std::string &name, const std::function<void()> &body) override {
+		std::atomic<bool> done = false;
+		std::atomic<long> peakHugePageKiB = readAnonHugePageKiB();
+		std::thread sampler([&done, &peakHugePageKiB]() {
+			while (!done.load()) {
+				std::this_thread::sleep_for(HUGE_PAGE_SAMPLE_INTERVAL);
+				peakHugePageKiB.store(std::max(peakHugePageKiB.load(), readAnonHugePageKiB()));
+			}
+		});
+
+		this->perfCounters.start();
+		auto start = std::chrono::steady_clock::now();
+		try {
+			body();
+		} catch (...) {
+			done.store(true);
+			sampler.join();
+			throw;
+		}
+
+		std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+		PerfCounts counts = this->perfCounters.stop();
+		done.store(true);
+		sampler.join();
+
+		this->phaseResults.emplace_back(
+			name, elapsed.count(), counts.getCount(PerfEvent::DTLB_MISSES), peakHugePageKiB.load());
+	}
+
+	void recordAnswer(const std::string &name, const std::string &answer) override {
+	}
+
+ private:
+	PerfCounters perfCounters;
+	std::vector<ArenaPhaseResult> phaseResults;
+};
+
+/**
+ * Run a solver on an input in a child process, so that nothing either run maps (or leaves in the heap) is seen by the
+ * other
+ * @param solve The solver
+ * @param filename The input
+ * @param hugePages Whether the solver's arenas should ask for huge pages
+ * @return std::vector<ArenaPhaseResult> How each phase ran
+ * @throws std::runtime_error if the solver fails
+ */
+std::vector<ArenaPhaseResult> measureSolver(SolveFunction solve, const std::string &filename, bool hugePages) {
+	int resultPipe[2];
+	if (pipe(resultPipe) == -1) {
+		throw std::runtime_error("Could not create pipe");
+	}
+
+	pid_t pid = fork();
+	if (pid == -1) {
+		throw std::runtime_error("Could not fork");
+	} else if (pid == 0) {
+		close(resultPipe[0]);
+		arenaHugePagesEnabled = hugePages;
+		std::ostringstream result;
+		try {
+			ArenaRunner runner;
+			MappedInput input = runner.phase("read", [&filename]() { return MappedInput(filename); });
+			solve(runner, input);
+			for (const ArenaPhaseResult &phaseResult : runner.getPhaseResults()) {
+				result << phaseResult.getName() << '\t' << phaseResult.getNanoseconds() << '\t'
+					   << phaseResult.getDTLBMisses().value_or(-1) << '\t' << phaseResult.getPeakHugePageKiB() << '\n';
+			}
+		} catch (const std::exception &e) {
+			result.str("");
+			result << "error\t" << e.what() << '\n';
+		} catch (...) {
+			// Some of the solvers throw pointers to exceptions, which can't be inspected without leaking them
+			result.str("");
+			result << "error\tunknown\n";
+		}
+
+		std::string resultText = result.str();
+		write(resultPipe[1], resultText.data(), resultText.size());
+		_exit(0);
+	}
+
+	close(resultPipe[1]);
+	std::string resultText;
+	char buffer[4096];
+	ssize_t numRead;
+	while ((numRead = read(resultPipe[0], buffer, sizeof(buffer))) > 0) {
+		resultText.append(buffer, numRead);
+	}
+
+	close(resultPipe[0]);
+	int status;
+	waitpid(pid, &status, 0);
+
+	std::vector<ArenaPhaseResult> phaseResults;
+	for (std::string_view line : MappedInput::splitLines(resultText)) {
+		std::vector<std::string> fields;
+		std::istringstream lineStream{std::string(line)};
+		std::string field;
+		while (std::getline(lineStream, field, '\t')) {
+			fields.push_back(field);
+		}
+
+		if (fields.at(0) == "error") {
+			throw std::runtime_error(fields.at(1));
+		}
+
+		long dTLBMisses = std::stol(fields.at(2));
+		phaseResults.emplace_back(
+			fields.at(0),
+			std::stod(fields.at(1)),
+			dTLBMisses < 0 ? std::nullopt : std::optional<long>(dTLBMisses),
+			std::stol(fields.at(3)));
+	}
+
+	if (phaseResults.empty()) {
+		throw std::runtime_error("The solver crashed");
+	}
+
+	return phaseResults;
+}
+
+/**
+ * Find the median of a number of runs of the same phase
+ * @param runs Every run of the solver, each of which must have run the same phases
+ * @param phaseIndex The index of the phase
+ * @return ArenaPhaseResult The median time, dTLB misses (if every run counted them), and peak huge pages of the phase
+ */
+ArenaPhaseResult findMedianResult(const std::vector<std::vector<ArenaPhaseResult>> &runs, std::size_t phaseIndex) {
+	std::vector<double> nanoseconds;
+	std::vector<long> dTLBMisses;
+	std::vector<long> peakHugePageKiB;
+	for (const std::vector<ArenaPhaseResult> &run : runs) {
+		const ArenaPhaseResult &phaseResult = run.at(phaseIndex);
+		nanoseconds.push_back(phaseResult.getNanoseconds());
+		if (phaseResult.getDTLBMisses()) {
+			dTLBMisses.push_back(*phaseResult.getDTLBMisses());
+		}
+		peakHugePageKiB.push_back(phaseResult.getPeakHugePageKiB());
+	}
+
+	auto median = [](auto values) {
+		std::sort(values.begin(), values.end());
+		return values.at(values.size() / 2);
+	};
+
+	return ArenaPhaseResult(
+		runs.front().at(phaseIndex).getName(),
+		median(nanoseconds),
+		dTLBMisses.size() == runs.size() ? std::optional<long>(median(dTLBMisses)) : std::nullopt,
+		median(peakHugePageKiB));
+}
+
+/**
+ * Write a phase's result as a JSON object
+ * @param os The stream to write to
+ * @param phaseResult The result
+ */
+void writePhaseResult(std::ostream &os, const ArenaPhaseResult &phaseResult) {
+	os << "{\"median_ns\": " << phaseResult.getNanoseconds() << ", \"dtlb_misses\": ";
+	writeJSONNumber(os, phaseResult.getDTLBMisses());
+	os << ", \"peak_huge_page_kib\": " << phaseResult.getPeakHugePageKiB() << "}";
+}
+
+/**
+ * Benchmark a solver against a single input, with and without huge pages, writing the results as a JSON object
+ * @param os The stream to write to
+ * @param solverName The name of the solver
+ * @param solve The solver
+ * @param filename The input file
+ * @param numRepetitions The number of runs with and without huge pages
+ */
+void benchmarkArenas(
+	std::ostream &os,
+	const std::string &solverName,
+	SolveFunction solve,
+	const std::string &filename,
+	int numRepetitions) {
+	// Alternate between the two, so that neither is favoured by anything else the machine happens to be doing
+	std::vector<std::vector<ArenaPhaseResult>> smallPageRuns;
+	std::vector<std::vector<ArenaPhaseResult>> hugePageRuns;
+	for (int i = 0; i < numRepetitions; i++) {
+		smallPageRuns.push_back(measureSolver(solve, filename, false));
+		hugePageRuns.push_back(measureSolver(solve, filename, true));
+	}
+
+	os << "{\"solver\": " << toJSONString(solverName) << ", \"input\": " << toJSONString(filename) << ", \"phases\": [";
+	for (std::size_t i = 0; i < smallPageRuns.front().size(); i++) {
+		ArenaPhaseResult smallPages = findMedianResult(smallPageRuns, i);
+		ArenaPhaseResult hugePages = findMedianResult(hugePageRuns, i);
+		os << (i == 0 ? "" : ", ") << "{\"name\": " << toJSONString(smallPages.getName()) << ", \"small_pages\": ";
+		writePhaseResult(os, smallPages);
+		os << ", \"huge_pages\": ";
+		writePhaseResult(os, hugePages);
+		os << ", \"dtlb_miss_ratio\": ";
+		if (smallPages.getDTLBMisses() && hugePages.getDTLBMisses() && *smallPages.getDTLBMisses() > 0) {
+			os << static_cast<double>(*hugePages.getDTLBMisses()) / *smallPages.getDTLBMisses();
+		} else {
+			os << "null";
+		}
+
+		double speedup = hugePages.getNanoseconds() > 0 ? smallPages.getNanoseconds() / hugePages.getNanoseconds() : 0;
+		os << ", \"speedup\": " << speedup << "}";
+	}
+
+	os << "]}";
+}
+
+/**
+ * Find a solver by its name
+ * @param name The name of the solver (e.g. day15)
+ * @return SolveFunction The solver
+ * @throws std::invalid_argument if there is no solver with this name
+ */
+SolveFunction findSolver(const std::string &name) {
+	auto solverIt = std::find_if(SOLVERS.cbegin(), SOLVERS.cend(), [&name](const auto &solver) {
+		return solver.first == name;
+	});
+	if (solverIt == SOLVERS.cend()) {
+		throw std::invalid_argument("No solver named " + name);
+	}
+
+	return solverIt->second;
+}
+
+int main(int argc, char *argv[]) {
+	int numRepetitions = DEFAULT_NUM_REPETITIONS;
+	// Pairs of solver name and input file
+	std::vector<std::pair<std::string, std::string>> runs;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--repetitions" && i + 1 < argc) {
+			numRepetitions = std::stoi(argv[++i]);
+		} else if (arg.find('=') != std::string::npos) {
+			auto equalsIndex = arg.find('=');
+			runs.emplace_back(arg.substr(0, equalsIndex), arg.substr(equalsIndex + 1));
+		} else {
+			runs.clear();
+			break;
+		}
+	}
+
+	if (runs.empty() || numRepetitions < 1) {
+		std::cerr << argv[0] << " [--repetitions n] <solver>=<input_file>..." << std::endl;
+		std::cerr << "e.g. " << argv[0] << " day15=day15/input.txt day23=day23/input.txt" << std::endl;
+		return 1;
+	}
+
+	std::cout << "{\"repetitions\": " << numRepetitions << ", \"results\": [";
+	for (auto it = runs.cbegin(); it != runs.cend(); ++it) {
+		std::cout << (it == runs.cbegin() ? "\n" : ",\n");
+		benchmarkArenas(std::cout, it->first, findSolver(it->first), it->second, numRepetitions);
+	}
+
+	std::cout << "\n]}" << std::endl;
+}
@@ -0,0 +1,999 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+constexpr std::uint64_t DEFAULT_SEED = 2020;
+constexpr int DAY1_TARGET = 2020;
+constexpr int DAY3_WIDTH = 31;
+constexpr int DAY5_NUM_SEATS = 1024;
+constexpr int DAY7_NUM_LEVELS = 8;
+constexpr int DAY7_SHINY_GOLD_LEVEL = 4;
+constexpr int DAY9_PREAMBLE_SIZE = 25;
+constexpr int DAY9_VALUE_BOUND = 1000;
+constexpr int DAY13_NUM_BUSSES = 8;
+constexpr int DAY14_MAX_FLOATING_BITS = 8;
+constexpr int DAY16_NUM_FIELDS = 20;
+constexpr int DAY16_BAND_WIDTH = 40;
+constexpr int DAY20_MIN_TILE_SIZE = 10;
+constexpr int DAY23_NUM_CUPS = 9;
+constexpr int DAY25_DIVIDEND = 20201227;
+constexpr int DAY25_SUBJECT_NUMBER = 7;
+const std::vector<std::string> DAY4_EYE_COLORS{"amb", "blu", "brn", "gry", "grn", "hzl", "oth", "xry"};
+const std::vector<std::string> DAY20_MONSTER{
+	"                  # ",
+	"#    ##    ##    ###",
+	" #  #  #  #  #  #   ",
+};
+const std::vector<std::string> DAY21_ALLERGENS{
+	"dairy", "eggs", "fish", "nuts", "peanuts", "sesame", "shellfish", "soy", "wheat"};
+const std::vector<std::string> DAY24_DIRECTIONS{"e", "w", "se", "sw", "nw", "ne"};
+// The example grammar from the day 19 puzzle, which already has the rule 8/rule 11 structure part 2 relies on
+constexpr auto DAY19_GRAMMAR = 1 + R"(
+42: 9 14 | 10 1
+9: 14 27 | 1 26
+10: 23 14 | 28 1
+1: "a"
+11: 42 31
+5: 1 14 | 15 1
+19: 14 1 | 14 14
+12: 24 14 | 19 1
+16: 15 1 | 14 14
+31: 14 17 | 1 13
+6: 14 14 | 1 14
+2: 1 24 | 14 4
+0: 8 11
+13: 14 3 | 1 12
+15: 1 | 14
+17: 14 2 | 1 7
+23: 25 1 | 22 14
+28: 16 1
+4: 1 1
+20: 14 14 | 1 15
+3: 5 14 | 16 1
+27: 1 6 | 14 18
+14: "b"
+21: 14 1 | 1 14
+25: 1 1 | 1 14
+22: 14 14
+8: 42
+26: 14 22 | 1 20
+18: 15 15
+7: 14 5 | 1 21
+24: 14 1)";
+
+/**
+ * A small, seedable random number generator (splitmix64). The standard library's distributions are not guaranteed to
+ * produce the same values across implementations, so this is used to make sure the same seed always produces the same
+ * input.
+ */
+class Random {
+ public:
+	Random(std::uint64_t seed) : state(seed) {
+	}
+
+	std::uint64_t next() {
+		std::uint64_t z = (this->state += 0x9e3779b97f4a7c15);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+		return z ^ (z >> 31);
+	}
+
+	/**
+	 * @param min The minimum value to generate
+	 * @param max The maximum value to generate
+	 * @return long A value in [min, max]
+	 */
+	long between(long min, long max) {
+		return min + static_cast<long>(this->next() % static_cast<std::uint64_t>(max - min + 1));
+	}
+
+	/**
+	 * @param probability The probability of returning true
+	 * @return bool true with the given probability
+	 */
+	bool chance(double probability) {
+		return (this->next() >> 11) * 0x1.0p-53 < probability;
+	}
+
+	template <typename T>
+	const T &choose(const std::vector<T> &items) {
+		return items.at(this->between(0, items.size() - 1));
+	}
+
+	template <typename T>
+	void shuffle(std::vector<T> &items) {
+		for (std::size_t i = items.size(); i > 1; i--) {
+			std::swap(items.at(i - 1), items.at(this->between(0, i - 1)));
+		}
+	}
+
+	/**
+	 * @param length The length of the word
+	 * @return std::string A random lowercase word
+	 */
+	std::string word(int length) {
+		std::string res;
+		for (int i = 0; i < length; i++) {
+			res += static_cast<char>('a' + this->between(0, 25));
+		}
+
+		return res;
+	}
+
+ private:
+	std::uint64_t state;
+};
+
+/**
+ * Generate a word that has not been generated before
+ * @param random The random generator
+ * @param used All words that have been generated so far. The new word is added to this.
+ * @return std::string The new word
+ */
+std::string uniqueWord(Random &random, std::set<std::string> &used) {
+	int length = 4;
+	for (int attempt = 0;; attempt++) {
+		// Long words take a while to show up at random, so make it easier to find an unused word as we run out
+		std::string candidate = random.word(length + attempt / 8);
+		if (used.insert(candidate).second) {
+			return candidate;
+		}
+	}
+}
+
+// Each of these writes a valid input for its day, of about the given size, to the stream
+using Generator = std::function<void(std::ostream &, Random &, long)>;
+
+/**
+ * size is the number of expenses. Exactly one pair and one triple sum to 2020; everything else is too big to.
+ */
+void generateDay1(std::ostream &os, Random &random, long size) {
+	// 1003 + 1017 and 500 + 511 + 1009 are the only ways to make 2020 (even reusing a number)
+	std::vector<long> expenses{1003, 1017, 500, 511, 1009};
+	while (static_cast<long>(expenses.size()) < size) {
+		expenses.push_back(random.between(DAY1_TARGET + 1, 1'000'000'000));
+	}
+
+	random.shuffle(expenses);
+	for (long expense : expenses) {
+		os << expense << '\n';
+	}
+}
+
+/**
+ * size is the number of password entries
+ */
+void generateDay2(std::ostream &os, Random &random, long size) {
+	for (long i = 0; i < size; i++) {
+		int min = random.between(1, 10);
+		int max = random.between(min + 1, 20);
+		char letter = 'a' + random.between(0, 25);
+		std::string password;
+		int length = random.between(max, max + 6);
+		for (int j = 0; j < length; j++) {
+			password += random.chance(0.4) ? letter : static_cast<char>('a' + random.between(0, 25));
+		}
+
+		os << min << '-' << max << ' ' << letter << ": " << password << '\n';
+	}
+}
+
+/**
+ * size is the number of rows of the slope
+ */
+void generateDay3(std::ostream &os, Random &random, long size) {
+	for (long i = 0; i < size; i++) {
+		std::string row;
+		for (int j = 0; j < DAY3_WIDTH; j++) {
+			row += random.chance(0.25) ? '#' : '.';
+		}
+
+		os << row << '\n';
+	}
+}
+
+/**
+ * size is the number of passports. About half of them have every field valid.
+ */
+void generateDay4(std::ostream &os, Random &random, long size) {
+	for (long i = 0; i < size; i++) {
+		bool valid = random.chance(0.5);
+		std::vector<std::string> fields;
+		auto year = [&random, valid](int min, int max) {
+			return std::to_string(valid ? random.between(min, max) : random.between(1900, 2040));
+		};
+		fields.push_back("byr:" + year(1920, 2002));
+		fields.push_back("iyr:" + year(2010, 2020));
+		fields.push_back("eyr:" + year(2020, 2030));
+		if (valid || random.chance(0.5)) {
+			fields.push_back("hgt:" + std::to_string(random.between(150, 193)) + "cm");
+		} else {
+			fields.push_back("hgt:" + std::to_string(random.between(40, 90)) + "in");
+		}
+
+		std::string hairColor = "#";
+		for (int j = 0; j < 6; j++) {
+			hairColor += "0123456789abcdef"[random.between(0, valid ? 15 : 20) % 16];
+		}
+		fields.push_back("hcl:" + hairColor);
+		fields.push_back("ecl:" + (valid ? DAY4_EYE_COLORS.at(random.between(0, 6)) : random.choose(DAY4_EYE_COLORS)));
+		fields.push_back("pid:" + std::to_string(random.between(100'000'000, valid ? 999'999'999 : 9'999'999'999)));
+		if (random.chance(0.5)) {
+			fields.push_back("cid:" + std::to_string(random.between(1, 999)));
+		}
+		// Some invalid passports are just missing a field
+		if (!valid && random.chance(0.3)) {
+			fields.erase(fields.begin() + random.between(0, 6));
+		}
+
+		random.shuffle(fields);
+		// Passports may span several lines
+		for (std::size_t j = 0; j < fields.size(); j++) {
+			bool lastField = j + 1 == fields.size();
+			os << fields.at(j) << (lastField || random.chance(0.3) ? '\n' : ' ');
+		}
+
+		if (i + 1 != size) {
+			os << '\n';
+		}
+	}
+}
+
+/**
+ * size is the number of boarding passes, which is capped by the size of the plane. Exactly one seat with a neighbor on
+ * either side is left out.
+ */
+void generateDay5(std::ostream &os, Random &random, long size) {
+	long numSeats = std::max(3L, std::min(size + 1, static_cast<long>(DAY5_NUM_SEATS)));
+	long firstSeat = random.between(0, DAY5_NUM_SEATS - numSeats);
+	long missingSeat = random.between(firstSeat + 1, firstSeat + numSeats - 2);
+	std::vector<long> seats;
+	for (long seat = firstSeat; seat < firstSeat + numSeats; seat++) {
+		if (seat != missingSeat) {
+			seats.push_back(seat);
+		}
+	}
+
+	random.shuffle(seats);
+	for (long seat : seats) {
+		for (int bit = 9; bit >= 0; bit--) {
+			bool set = (seat >> bit) & 1;
+			os << (bit >= 3 ? (set ? 'B' : 'F') : (set ? 'R' : 'L'));
+		}
+
+		os << '\n';
+	}
+}
+
+/**
+ * size is the number of groups
+ */
+void generateDay6(std::ostream &os, Random &random, long size) {
+	for (long i = 0; i < size; i++) {
+		int numPeople = random.between(1, 5);
+		for (int j = 0; j < numPeople; j++) {
+			std::string answers;
+			for (char answer = 'a'; answer <= 'z'; answer++) {
+				if (random.chance(0.4)) {
+					answers += answer;
+				}
+			}
+
+			os << (answers.empty() ? "x" : answers) << '\n';
+		}
+
+		if (i + 1 != size) {
+			os << '\n';
+		}
+	}
+}
+
+/**
+ * size is the number of bag rules. The bags are split into levels, and bags only hold bags from the level below, so
+ * that the number of paths through the graph (which both parts are exponential in) stays bounded like the real input.
+ */
+void generateDay7(std::ostream &os, Random &random, long size) {
+	long numBags = std::max(static_cast<long>(DAY7_NUM_LEVELS), size);
+	std::set<std::string> usedNames{"gold"};
+	std::vector<std::vector<std::string>> levels(DAY7_NUM_LEVELS);
+	levels.at(DAY7_SHINY_GOLD_LEVEL).push_back("shiny gold");
+	for (long i = 1; i < numBags; i++) {
+		// Make sure every level has at least one bag
+		int level = i < DAY7_NUM_LEVELS ? (i + DAY7_SHINY_GOLD_LEVEL) % DAY7_NUM_LEVELS
+										: random.between(0, DAY7_NUM_LEVELS - 1);
+		levels.at(level).push_back(random.word(5) + " " + uniqueWord(random, usedNames));
+	}
+
+	std::vector<std::string> rules;
+	for (int level = 0; level < DAY7_NUM_LEVELS; level++) {
+		for (const std::string &name : levels.at(level)) {
+			std::set<std::string> children;
+			if (level + 1 < DAY7_NUM_LEVELS) {
+				// Everything above shiny gold holds something, so that there's a chance of reaching it
+				int numChildren = random.between(level < DAY7_SHINY_GOLD_LEVEL ? 1 : 0, 3);
+				for (int i = 0; i < numChildren; i++) {
+					children.insert(random.choose(levels.at(level + 1)));
+				}
+				if (level + 1 == DAY7_SHINY_GOLD_LEVEL && name == levels.at(level).front()) {
+					children.insert("shiny gold");
+				}
+			}
+
+			std::ostringstream rule;
+			rule << name << " bags contain ";
+			if (children.empty()) {
+				rule << "no other bags";
+			}
+			for (auto it = children.cbegin(); it != children.cend(); ++it) {
+				int quantity = random.between(1, 5);
+				rule << (it == children.cbegin() ? "" : ", ") << quantity << " " << *it
+					 << (quantity == 1 ? " bag" : " bags");
+			}
+
+			rule << ".";
+			rules.push_back(rule.str());
+		}
+	}
+
+	random.shuffle(rules);
+	for (const std::string &rule : rules) {
+		os << rule << '\n';
+	}
+}
+
+/**
+ * size is the number of instructions. The program always loops back to the start from its last line, so that last
+ * jmp is the one instruction that must be flipped.
+ */
+void generateDay8(std::ostream &os, Random &random, long size) {
+	long numInstructions = std::max(2L, size);
+	for (long i = 0; i + 1 < numInstructions; i++) {
+		long remaining = numInstructions - 1 - i;
+		long offset = random.between(1, std::min(4L, remaining));
+		switch (random.between(0, 2)) {
+			case 0:
+				os << "acc " << std::showpos << random.between(-50, 50) << std::noshowpos << '\n';
+				break;
+			case 1:
+				// A nop that stays within the program, so flipping it can't escape the loop
+				os << "nop " << std::showpos << random.between(0, remaining - 1) << std::noshowpos << '\n';
+				break;
+			default:
+				os << "jmp " << std::showpos << offset << std::noshowpos << '\n';
+		}
+	}
+
+	os << "jmp " << std::showpos << -(numInstructions - 1) << std::noshowpos << '\n';
+}
+
+/**
+ * size is the number of numbers. Every number after the preamble is a sum of two of the 25 before it, except the last.
+ */
+void generateDay9(std::ostream &os, Random &random, long size) {
+	// The first two numbers are reserved for planting a part 2 answer, so they must be out of the last number's window
+	long numNumbers = std::max(static_cast<long>(DAY9_PREAMBLE_SIZE) + 3, size);
+	std::vector<long> numbers;
+	for (int i = 0; i < DAY9_PREAMBLE_SIZE; i++) {
+		numbers.push_back(random.between(-DAY9_VALUE_BOUND, DAY9_VALUE_BOUND));
+	}
+
+	std::vector<long> window;
+	while (static_cast<long>(numbers.size()) < numNumbers - 1) {
+		// Pick the pair that sums closest to a random target, which keeps the numbers from growing without bound.
+		long windowStart = std::max(2L, static_cast<long>(numbers.size()) - DAY9_PREAMBLE_SIZE);
+		window.assign(numbers.cbegin() + windowStart, numbers.cend());
+		std::sort(window.begin(), window.end());
+		long target = random.between(-DAY9_VALUE_BOUND, DAY9_VALUE_BOUND);
+		long best = window.front() + window.back();
+		for (auto low = window.cbegin(), high = window.cend() - 1; low < high;) {
+			long sum = *low + *high;
+			best = std::abs(sum - target) < std::abs(best - target) ? sum : best;
+			sum < target ? ++low : --high;
+		}
+
+		numbers.push_back(best);
+	}
+
+	// The invalid number is the sum of the contiguous range with the largest sum, so part 2 has an answer, as long as
+	// that is more than any pair in the window can sum to.
+	long bestSum = 0;
+	long runningSum = 0;
+	for (long number : numbers) {
+		runningSum = std::max(number, runningSum + number);
+		bestSum = std::max(bestSum, runningSum);
+	}
+
+	long maxNumber = *std::max_element(numbers.cend() - DAY9_PREAMBLE_SIZE, numbers.cend());
+	if (bestSum <= 2 * maxNumber) {
+		// Not a big enough range at random; plant one at the start of the preamble instead
+		bestSum = 2 * maxNumber + 1;
+		numbers.at(0) = bestSum - numbers.at(1);
+	}
+
+	numbers.push_back(bestSum);
+	for (long number : numbers) {
+		os << number << '\n';
+	}
+}
+
+/**
+ * size is the number of adapters. Note that part 2's answer overflows for more than a couple hundred adapters.
+ */
+void generateDay10(std::ostream &os, Random &random, long size) {
+	std::vector<long> adapters;
+	long joltage = 0;
+	for (long i = 0; i < size; i++) {
+		joltage += random.chance(0.7) ? 1 : 3;
+		adapters.push_back(joltage);
+	}
+
+	random.shuffle(adapters);
+	for (long adapter : adapters) {
+		os << adapter << '\n';
+	}
+}
+
+/**
+ * size is the side length of the (square) seat layout
+ */
+void generateDay11(std::ostream &os, Random &random, long size) {
+	for (long i = 0; i < size; i++) {
+		std::string row;
+		for (long j = 0; j < size; j++) {
+			row += random.chance(0.8) ? 'L' : '.';
+		}
+
+		os << row << '\n';
+	}
+}
+
+/**
+ * size is the number of navigation instructions
+ */
+void generateDay12(std::ostream &os, Random &random, long size) {
+	const std::string moves = "NSEWF";
+	for (long i = 0; i < size; i++) {
+		if (random.chance(0.2)) {
+			os << (random.chance(0.5) ? 'L' : 'R') << 90 * random.between(1, 3) << '\n';
+		} else {
+			os << moves.at(random.between(0, moves.size() - 1)) << random.between(1, 100) << '\n';
+		}
+	}
+}
+
+/**
+ * size is the number of entries in the bus list. Only a handful are real busses (distinct primes, so that their product
+ * fits in a long); the rest are out of service.
+ */
+void generateDay13(std::ostream &os, Random &random, long size) {
+	std::vector<long> primes;
+	for (long candidate = 13; candidate < 100; candidate++) {
+		bool prime = true;
+		for (long divisor = 2; divisor * divisor <= candidate; divisor++) {
+			prime = prime && candidate % divisor != 0;
+		}
+		if (prime) {
+			primes.push_back(candidate);
+		}
+	}
+
+	random.shuffle(primes);
+	long numEntries = std::max(1L, size);
+	long numBusses = std::min(numEntries, static_cast<long>(DAY13_NUM_BUSSES));
+	std::vector<std::string> entries(numEntries, "x");
+	// The first entry must be a bus
+	std::vector<long> positions{0};
+	while (static_cast<long>(positions.size()) < numBusses) {
+		long position = random.between(1, numEntries - 1);
+		if (std::find(positions.cbegin(), positions.cend(), position) == positions.cend()) {
+			positions.push_back(position);
+		}
+	}
+	for (std::size_t i = 0; i < positions.size(); i++) {
+		entries.at(positions.at(i)) = std::to_string(primes.at(i));
+	}
+
+	os << random.between(100'000, 1'000'000) << '\n';
+	for (long i = 0; i < numEntries; i++) {
+		os << (i == 0 ? "" : ",") << entries.at(i);
+	}
+
+	os << '\n';
+}
+
+/**
+ * size is the number of lines in the program. Masks have at most a few floating bits, so part 2 stays tractable.
+ */
+void generateDay14(std::ostream &os, Random &random, long size) {
+	for (long i = 0; i < size; i++) {
+		if (i == 0 || random.chance(0.2)) {
+			std::string mask(36, 'X');
+			int numFloating = 0;
+			for (char &maskChar : mask) {
+				if (numFloating < DAY14_MAX_FLOATING_BITS && random.chance(0.1)) {
+					numFloating++;
+				} else {
+					maskChar = random.chance(0.5) ? '1' : '0';
+				}
+			}
+
+			os << "mask = " << mask << '\n';
+		} else {
+			os << "mem[" << random.between(0, 65535) << "] = " << random.between(0, 1'000'000'000) << '\n';
+		}
+	}
+}
+
+/**
+ * size is the number of (distinct) starting numbers. The number of turns is fixed by the puzzle.
+ */
+void generateDay15(std::ostream &os, Random &random, long size) {
+	std::vector<long> numbers(std::max(1L, size));
+	std::iota(numbers.begin(), numbers.end(), 0);
+	random.shuffle(numbers);
+	for (std::size_t i = 0; i < numbers.size(); i++) {
+		os << (i == 0 ? "" : ",") << numbers.at(i);
+	}
+
+	os << '\n';
+}
+
+/**
+ * size is the number of nearby tickets. Each field accepts the values of its own position and every position "above"
+ * it, which forms the staircase of candidates that part 2 needs to untangle.
+ */
+void generateDay16(std::ostream &os, Random &random, long size) {
+	std::vector<int> positions(DAY16_NUM_FIELDS);
+	std::iota(positions.begin(), positions.end(), 0);
+	random.shuffle(positions);
+	int maxValue = DAY16_NUM_FIELDS * DAY16_BAND_WIDTH;
+	for (int field = 0; field < DAY16_NUM_FIELDS; field++) {
+		std::string name = (field % 3 == 0 ? "departure " : "arrival ") + std::string(1, 'a' + field);
+		int extraValue = maxValue + 10 + field;
+		os << name << ": " << field * DAY16_BAND_WIDTH + 1 << '-' << maxValue << " or " << extraValue << '-'
+		   << extraValue << '\n';
+	}
+
+	// Field f goes at positions[f], so the value at positions[f] must come from band f
+	auto makeTicket = [&random, &positions](bool valid) {
+		std::vector<int> ticket(DAY16_NUM_FIELDS);
+		for (int field = 0; field < DAY16_NUM_FIELDS; field++) {
+			ticket.at(positions.at(field)) =
+				field * DAY16_BAND_WIDTH + random.between(1, DAY16_BAND_WIDTH);
+		}
+		if (!valid) {
+			ticket.at(random.between(0, DAY16_NUM_FIELDS - 1)) = random.chance(0.5) ? 0 : 5000 + random.between(0, 99);
+		}
+
+		std::ostringstream rawTicket;
+		for (int i = 0; i < DAY16_NUM_FIELDS; i++) {
+			rawTicket << (i == 0 ? "" : ",") << ticket.at(i);
+		}
+
+		return rawTicket.str();
+	};
+
+	os << "\nyour ticket:\n" << makeTicket(true) << "\n\nnearby tickets:\n";
+	for (long i = 0; i < size; i++) {
+		os << makeTicket(!random.chance(0.25)) << '\n';
+	}
+}
+
+/**
+ * size is the side length of the initial (square) slice
+ */
+void generateDay17(std::ostream &os, Random &random, long size) {
+	for (long i = 0; i < size; i++) {
+		std::string row;
+		for (long j = 0; j < size; j++) {
+			row += random.chance(0.4) ? '#' : '.';
+		}
+
+		os << row << '\n';
+	}
+}
+
+/**
+ * Generate a random expression for day 18
+ * @param random The random generator
+ * @param depth How many more parentheticals may be nested in this one
+ * @return std::string The expression
+ */
+std::string generateExpression(Random &random, int depth) {
+	int numOperands = random.between(2, 4);
+	std::string expression;
+	for (int i = 0; i < numOperands; i++) {
+		if (i != 0) {
+			expression += random.chance(0.5) ? " + " : " * ";
+		}
+		if (depth > 0 && random.chance(0.3)) {
+			expression += "(" + generateExpression(random, depth - 1) + ")";
+		} else {
+			expression += std::to_string(random.between(1, 9));
+		}
+	}
+
+	return expression;
+}
+
+/**
+ * size is the number of expressions
+ */
+void generateDay18(std::ostream &os, Random &random, long size) {
+	for (long i = 0; i < size; i++) {
+		os << generateExpression(random, 2) << '\n';
+	}
+}
+
+/**
+ * Generate a random string that matches a grammar rule
+ * @param grammar The grammar, as rule number to its alternatives
+ * @param random The random generator
+ * @param rule The rule to match
+ * @return std::string The string
+ */
+std::string generateFromRule(
+	const std::map<int, std::vector<std::vector<std::string>>> &grammar, Random &random, int rule) {
+	const std::vector<std::string> &alternative = random.choose(grammar.at(rule));
+	std::string res;
+	for (const std::string &component : alternative) {
+		if (component.front() == '"') {
+			res += component.substr(1, 1);
+		} else {
+			res += generateFromRule(grammar, random, std::stoi(component));
+		}
+	}
+
+	return res;
+}
+
+/**
+ * size is the number of messages. Messages are built as 42^n 31^m, which matches part 1's grammar when n = 2 and
+ * m = 1, and part 2's when n > m; about a third are corrupted by a single character.
+ */
+void generateDay19(std::ostream &os, Random &random, long size) {
+	std::map<int, std::vector<std::vector<std::string>>> grammar;
+	std::istringstream rawGrammar(DAY19_GRAMMAR);
+	std::string line;
+	while (std::getline(rawGrammar, line)) {
+		int rule = std::stoi(line.substr(0, line.find(':')));
+		std::istringstream rawAlternatives(line.substr(line.find(':') + 2));
+		std::string component;
+		grammar[rule].emplace_back();
+		while (rawAlternatives >> component) {
+			if (component == "|") {
+				grammar[rule].emplace_back();
+			} else {
+				grammar[rule].back().push_back(component);
+			}
+		}
+	}
+
+	os << DAY19_GRAMMAR << "\n\n";
+	for (long i = 0; i < size; i++) {
+		int num31 = random.between(1, 3);
+		int num42 = random.between(num31 + (random.chance(0.2) ? -1 : 1), num31 + 3);
+		std::string message;
+		for (int j = 0; j < num42; j++) {
+			message += generateFromRule(grammar, random, 42);
+		}
+		for (int j = 0; j < num31; j++) {
+			message += generateFromRule(grammar, random, 31);
+		}
+		if (random.chance(0.3)) {
+			char &corrupted = message.at(random.between(0, message.size() - 1));
+			corrupted = corrupted == 'a' ? 'b' : 'a';
+		}
+
+		os << message << '\n';
+	}
+}
+
+/**
+ * size is the side length of the mosaic, in tiles. Every tile edge is unique (even when flipped), so there is exactly
+ * one arrangement, and the image contains sea monsters. Tiles grow beyond 10x10 when the mosaic is too big for 10-bit
+ * edges to be unique.
+ */
+void generateDay20(std::ostream &os, Random &random, long size) {
+	long numTiles = std::max(1L, size);
+	// Every tile has four edges, each of which must be unique when reversed as well
+	int tileSize = DAY20_MIN_TILE_SIZE;
+	while (std::pow(2.0, tileSize - 2) < 16.0 * numTiles * (numTiles + 1)) {
+		tileSize++;
+	}
+
+	// Corners are shared between the four tiles that meet there, so pick those first, and then the rest of each edge
+	std::vector<std::vector<char>> corners(numTiles + 1, std::vector<char>(numTiles + 1));
+	for (auto &cornerRow : corners) {
+		for (char &corner : cornerRow) {
+			corner = random.chance(0.5) ? '#' : '.';
+		}
+	}
+
+	std::set<std::string> usedEdges;
+	auto makeEdge = [&random, &usedEdges, tileSize](char start, char end) {
+		while (true) {
+			std::string edge(1, start);
+			for (int i = 0; i < tileSize - 2; i++) {
+				edge += random.chance(0.5) ? '#' : '.';
+			}
+			edge += end;
+
+			std::string reversed(edge.rbegin(), edge.rend());
+			if (edge != reversed && usedEdges.count(edge) == 0 && usedEdges.count(reversed) == 0) {
+				usedEdges.insert(edge);
+				usedEdges.insert(reversed);
+				return edge;
+			}
+		}
+	};
+
+	// topEdges[r][c] is the top edge of tile (r, c), or the bottom edge of tile (r - 1, c); leftEdges likewise.
+	std::vector<std::vector<std::string>> topEdges(numTiles + 1);
+	std::vector<std::vector<std::string>> leftEdges(numTiles);
+	for (long row = 0; row <= numTiles; row++) {
+		for (long col = 0; col < numTiles; col++) {
+			topEdges.at(row).push_back(makeEdge(corners.at(row).at(col), corners.at(row).at(col + 1)));
+		}
+	}
+	for (long row = 0; row < numTiles; row++) {
+		for (long col = 0; col <= numTiles; col++) {
+			leftEdges.at(row).push_back(makeEdge(corners.at(row).at(col), corners.at(row + 1).at(col)));
+		}
+	}
+
+	// The image is what remains once the borders are removed; put some monsters in it.
+	long imageSize = numTiles * (tileSize - 2);
+	std::vector<std::string> image(imageSize, std::string(imageSize, '.'));
+	for (std::string &imageRow : image) {
+		for (char &pixel : imageRow) {
+			pixel = random.chance(0.25) ? '#' : '.';
+		}
+	}
+
+	long monsterWidth = DAY20_MONSTER.front().size();
+	long monsterHeight = DAY20_MONSTER.size();
+	long numMonsters = std::max(1L, imageSize * imageSize / 400);
+	for (long i = 0; i < numMonsters && imageSize >= monsterWidth; i++) {
+		long monsterRow = random.between(0, imageSize - monsterHeight);
+		long monsterCol = random.between(0, imageSize - monsterWidth);
+		for (long row = 0; row < monsterHeight; row++) {
+			for (long col = 0; col < monsterWidth; col++) {
+				if (DAY20_MONSTER.at(row).at(col) == '#') {
+					image.at(monsterRow + row).at(monsterCol + col) = '#';
+				}
+			}
+		}
+	}
+
+	std::set<std::string> usedIDs;
+	std::vector<std::string> tiles;
+	for (long row = 0; row < numTiles; row++) {
+		for (long col = 0; col < numTiles; col++) {
+			std::vector<std::string> tile(tileSize, std::string(tileSize, '.'));
+			for (int i = 0; i < tileSize; i++) {
+				tile.front().at(i) = topEdges.at(row).at(col).at(i);
+				tile.back().at(i) = topEdges.at(row + 1).at(col).at(i);
+				tile.at(i).front() = leftEdges.at(row).at(col).at(i);
+				tile.at(i).back() = leftEdges.at(row).at(col + 1).at(i);
+			}
+			for (int i = 1; i < tileSize - 1; i++) {
+				for (int j = 1; j < tileSize - 1; j++) {
+					tile.at(i).at(j) = image.at(row * (tileSize - 2) + i - 1).at(col * (tileSize - 2) + j - 1);
+				}
+			}
+
+			// Scramble the orientation of the tile
+			for (int rotations = random.between(0, 3); rotations > 0; rotations--) {
+				std::vector<std::string> rotated(tile);
+				for (int i = 0; i < tileSize; i++) {
+					for (int j = 0; j < tileSize; j++) {
+						rotated.at(j).at(tileSize - 1 - i) = tile.at(i).at(j);
+					}
+				}
+
+				tile = std::move(rotated);
+			}
+			if (random.chance(0.5)) {
+				std::reverse(tile.begin(), tile.end());
+			}
+
+			std::string id;
+			do {
+				id = std::to_string(random.between(1000, 9999 + numTiles * numTiles));
+			} while (!usedIDs.insert(id).second);
+
+			std::string rawTile = "Tile " + id + ":\n";
+			for (const std::string &tileRow : tile) {
+				rawTile += tileRow + "\n";
+			}
+
+			tiles.push_back(std::move(rawTile));
+		}
+	}
+
+	random.shuffle(tiles);
+	for (std::size_t i = 0; i < tiles.size(); i++) {
+		os << (i == 0 ? "" : "\n") << tiles.at(i);
+	}
+}
+
+/**
+ * size is the number of foods. Every allergen gets two foods of its own that pin it to a single ingredient, so the
+ * elimination in part 2 always terminates.
+ */
+void generateDay21(std::ostream &os, Random &random, long size) {
+	std::set<std::string> usedNames;
+	std::vector<std::string> allergenIngredients;
+	for (std::size_t i = 0; i < DAY21_ALLERGENS.size(); i++) {
+		allergenIngredients.push_back(uniqueWord(random, usedNames));
+	}
+
+	std::vector<std::string> safeIngredients;
+	for (int i = 0; i < 200; i++) {
+		safeIngredients.push_back(uniqueWord(random, usedNames));
+	}
+
+	auto writeFood = [&os, &random, &allergenIngredients, &safeIngredients](const std::vector<std::size_t> &allergens) {
+		std::set<std::string> ingredients;
+		for (std::size_t allergen : allergens) {
+			ingredients.insert(allergenIngredients.at(allergen));
+		}
+		for (int i = 0; i < 8; i++) {
+			ingredients.insert(random.choose(safeIngredients));
+		}
+
+		std::vector<std::string> shuffledIngredients(ingredients.cbegin(), ingredients.cend());
+		random.shuffle(shuffledIngredients);
+		for (const std::string &ingredient : shuffledIngredients) {
+			os << ingredient << ' ';
+		}
+
+		os << "(contains ";
+		for (std::size_t i = 0; i < allergens.size(); i++) {
+			os << (i == 0 ? "" : ", ") << DAY21_ALLERGENS.at(allergens.at(i));
+		}
+
+		os << ")\n";
+	};
+
+	long numFoods = 0;
+	for (std::size_t allergen = 0; allergen < DAY21_ALLERGENS.size(); allergen++) {
+		writeFood({allergen});
+		writeFood({allergen});
+		numFoods += 2;
+	}
+	for (; numFoods < size; numFoods++) {
+		std::vector<std::size_t> allergens;
+		for (std::size_t allergen = 0; allergen < DAY21_ALLERGENS.size(); allergen++) {
+			if (random.chance(0.2)) {
+				allergens.push_back(allergen);
+			}
+		}
+		if (allergens.empty()) {
+			allergens.push_back(random.between(0, DAY21_ALLERGENS.size() - 1));
+		}
+
+		writeFood(allergens);
+	}
+}
+
+/**
+ * size is the total number of cards across both decks
+ */
+void generateDay22(std::ostream &os, Random &random, long size) {
+	std::vector<long> cards(std::max(2L, size));
+	std::iota(cards.begin(), cards.end(), 1);
+	random.shuffle(cards);
+	std::size_t half = cards.size() / 2;
+	os << "Player 1:\n";
+	for (std::size_t i = 0; i < half; i++) {
+		os << cards.at(i) << '\n';
+	}
+
+	os << "\nPlayer 2:\n";
+	for (std::size_t i = half; i < cards.size(); i++) {
+		os << cards.at(i) << '\n';
+	}
+}
+
+/**
+ * The input is always nine single-digit cups, so size is ignored; both parts scale with constants in the solver.
+ */
+void generateDay23(std::ostream &os, Random &random, long size) {
+	std::vector<int> cups(DAY23_NUM_CUPS);
+	std::iota(cups.begin(), cups.end(), 1);
+	random.shuffle(cups);
+	for (int cup : cups) {
+		os << cup;
+	}
+
+	os << '\n';
+}
+
+/**
+ * size is the number of tiles to flip
+ */
+void generateDay24(std::ostream &os, Random &random, long size) {
+	for (long i = 0; i < size; i++) {
+		int length = random.between(1, 20);
+		for (int j = 0; j < length; j++) {
+			os << random.choose(DAY24_DIRECTIONS);
+		}
+
+		os << '\n';
+	}
+}
+
+/**
+ * size is the largest loop size that may be used, which is what the brute force in part 1 scales with
+ */
+void generateDay25(std::ostream &os, Random &random, long size) {
+	auto transform = [](long loopSize) {
+		long value = 1;
+		for (long i = 0; i < loopSize; i++) {
+			value = value * DAY25_SUBJECT_NUMBER % DAY25_DIVIDEND;
+		}
+
+		return value;
+	};
+
+	long maxLoopSize = std::max(1L, size);
+	os << transform(random.between(1, maxLoopSize)) << '\n' << transform(random.between(1, maxLoopSize)) << '\n';
+}
+
+const std::map<std::string, Generator> GENERATORS{
+	{"day1", generateDay1},
+	{"day2", generateDay2},
+	{"day3", generateDay3},
+	{"day4", generateDay4},
+	{"day5", generateDay5},
+	{"day6", generateDay6},
+	{"day7", generateDay7},
+	{"day8", generateDay8},
+	{"day9", generateDay9},
+	{"day10", generateDay10},
+	{"day11", generateDay11},
+	{"day12", generateDay12},
+	{"day13", generateDay13},
+	{"day14", generateDay14},
+	{"day15", generateDay15},
+	{"day16", generateDay16},
+	{"day17", generateDay17},
+	{"day18", generateDay18},
+	{"day19", generateDay19},
+	{"day20", generateDay20},
+	{"day21", generateDay21},
+	{"day22", generateDay22},
+	{"day23", generateDay23},
+	{"day24", generateDay24},
+	{"day25", generateDay25},
+};
+
+int main(int argc, char *argv[]) {
+	if (argc != 3 && argc != 4) {
+		std::cerr << argv[0] << " <day> <size> [seed]" << std::endl;
+		std::cerr << "e.g. " << argv[0] << " day20 12 > day20.txt" << std::endl;
+		return 1;
+	}
+
+	auto generator = GENERATORS.find(argv[1]);
+	if (generator == GENERATORS.end()) {
+		std::cerr << "No generator for " << argv[1] << std::endl;
+		return 1;
+	}
+
+	long size = std::stol(argv[2]);
+	Random random(argc == 4 ? std::stoull(argv[3]) : DEFAULT_SEED);
+	// The output can be huge, so don't let cout flush on every newline
+	std::ios::sync_with_stdio(false);
+	generator->second(std::cout, random, size);
+}
@@ -0,0 +1,123 @@
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../common/input.hpp"
+
+// A typical line from the day 2 input; most inputs have lines of about this length
+constexpr auto BENCH_LINE = "3-11 z: zzzzzdzzzzlzz";
+const std::vector<long> DEFAULT_LINE_COUNTS{1'000'000, 10'000'000, 100'000'000};
+
+/**
+ * The readInput that every day used before MappedInput, kept here as the baseline
+ * @param filename The file to read
+ * @return std::vector<std::string> The lines of the file
+ */
+std::vector<std::string> readInput(const std::string &filename) {
+	std::vector<std::string> input;
+	std::string line;
+	std::ifstream file(filename);
+	while (std::getline(file, line)) {
+		input.push_back(line);
+	}
+
+	return input;
+}
+
+/**
+ * Write a bench file of the given number of lines
+ * @param filename The file to write to
+ * @param numLines The number of lines to write
+ */
+void writeBenchFile(const std::string &filename, long numLines) {
+	std::ofstream file(filename);
+	for (long i = 0; i < numLines; i++) {
+		file << BENCH_LINE << '\n';
+	}
+}
+
+/**
+ * Run a loader in a child process, so its peak RSS is not polluted by any other loader
+ * @param loader The loader to run. It should return the number of lines loaded
+ * @return std::pair<double, long> The time taken to load, in seconds, and the peak RSS of the child, in KiB
+ */
+std::pair<double, long> measureLoader(const std::function<std::size_t()> &loader) {
+	int timingPipe[2];
+	if (pipe(timingPipe) == -1) {
+		throw std::runtime_error("Could not create pipe");
+	}
+
+	pid_t pid = fork();
+	if (pid == -1) {
+		throw std::runtime_error("Could not fork");
+	} else if (pid == 0) {
+		close(timingPipe[0]);
+		auto start = std::chrono::steady_clock::now();
+		std::size_t numLines = loader();
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		double seconds = elapsed.count();
+		// Make sure the load can't be optimized away
+		if (numLines == 0) {
+			seconds = -1;
+		}
+
+		write(timingPipe[1], &seconds, sizeof(seconds));
+		_exit(0);
+	}
+
+	close(timingPipe[1]);
+	double seconds = -1;
+	read(timingPipe[0], &seconds, sizeof(seconds));
+	close(timingPipe[0]);
+
+	int status;
+	struct rusage usage;
+	wait4(pid, &status, 0, &usage);
+
+	return std::make_pair(seconds, usage.ru_maxrss);
+}
+
+int main(int argc, char *argv[]) {
+	if (argc < 2) {
+		std::cerr << argv[0] << " <scratch_file> [line_count...]" << std::endl;
+		return 1;
+	}
+
+	std::string filename = argv[1];
+	std::vector<long> lineCounts;
+	for (int i = 2; i < argc; i++) {
+		lineCounts.push_back(std::stol(argv[i]));
+	}
+	if (lineCounts.empty()) {
+		lineCounts = DEFAULT_LINE_COUNTS;
+	}
+
+	std::cout << std::left << std::setw(12) << "lines" << std::setw(14) << "loader" << std::setw(12) << "time (s)"
+			  << "peak RSS (MiB)" << std::endl;
+	for (long numLines : lineCounts) {
+		writeBenchFile(filename, numLines);
+		auto oldResult = measureLoader([&filename]() { return readInput(filename).size(); });
+		auto newResult = measureLoader([&filename]() {
+			MappedInput input(filename);
+			return input.getLines().size();
+		});
+
+		std::cout << std::fixed << std::setprecision(3);
+		std::cout << std::setw(12) << numLines << std::setw(14) << "readInput" << std::setw(12) << oldResult.first
+				  << oldResult.second / 1024.0 << std::endl;
+		std::cout << std::setw(12) << numLines << std::setw(14) << "MappedInput" << std::setw(12) << newResult.first
+				  << newResult.second / 1024.0 << std::endl;
+	}
+
+	std::remove(filename.c_str());
+}
@@ -0,0 +1,80 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../common/ksum.hpp"
+#include "../common/thread_pool.hpp"
+
+constexpr long DEFAULT_NUM_ENTRIES = 20'000;
+constexpr unsigned int DEFAULT_SEED = 1;
+const std::vector<int> DEFAULT_THREAD_COUNTS{1, 2, 4, 8, 16, 32, 64};
+// Every entry is even and below this, and the target is odd, so no three entries ever add up to it, and the search
+// has to try every first entry up to a third of it
+constexpr long ENTRY_RANGE = 1'000'000'000;
+constexpr long TARGET = ENTRY_RANGE + 1;
+
+/**
+ * Generate an expense report that has no three entries adding up to TARGET
+ * @param numEntries The number of entries
+ * @param seed The seed for the entries
+ * @return std::vector<long> The entries
+ */
+std::vector<long> generateEntries(long numEntries, unsigned int seed) {
+	std::mt19937_64 rng(seed);
+	std::uniform_int_distribution<long> distribution(0, ENTRY_RANGE / 2 - 1);
+	std::vector<long> entries;
+	entries.reserve(numEntries);
+	for (long i = 0; i < numEntries; i++) {
+		entries.push_back(distribution(rng) * 2);
+	}
+
+	return entries;
+}
+
+int main(int argc, char *argv[]) {
+	long numEntries = DEFAULT_NUM_ENTRIES;
+	unsigned int seed = DEFAULT_SEED;
+	std::vector<int> threadCounts;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--entries" && i + 1 < argc) {
+			numEntries = std::stol(argv[++i]);
+		} else if (arg == "--seed" && i + 1 < argc) {
+			seed = std::stoul(argv[++i]);
+		} else if (arg.rfind("--", 0) != 0 && std::stoi(arg) > 0) {
+			threadCounts.push_back(std::stoi(arg));
+		} else {
+			std::cerr << argv[0] << " [--entries n] [--seed n] [thread_count...]" << std::endl;
+			return 1;
+		}
+	}
+	if (threadCounts.empty()) {
+		threadCounts = DEFAULT_THREAD_COUNTS;
+	}
+
+	KSumEngine engine(generateEntries(numEntries, seed));
+	std::cout << std::left << std::setw(10) << "threads" << std::setw(12) << "time (s)"
+			  << "speedup" << std::endl;
+	double baselineSeconds = 0;
+	for (int numThreads : threadCounts) {
+		ThreadPool pool(numThreads);
+		auto start = std::chrono::steady_clock::now();
+		bool found = engine.findFirst(TARGET, 3, pool).has_value();
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		if (found) {
+			std::cerr << "Found a triple that can't exist" << std::endl;
+			return 1;
+		}
+
+		// Speedups are relative to the first thread count given
+		if (baselineSeconds == 0) {
+			baselineSeconds = elapsed.count();
+		}
+
+		std::cout << std::fixed << std::setprecision(3) << std::setw(10) << numThreads << std::setw(12)
+				  << elapsed.count() << baselineSeconds / elapsed.count() << std::endl;
+	}
+}
@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../common/input.hpp"
+
+// Day 2's own main would collide with this one
+#define AOC_NO_MAIN
+#include "../day2/day2.cpp"
+
+constexpr int DEFAULT_REPETITIONS = 5;
+
+/**
+ * The getNumValidPasswords that day 2 used before its validators were batched, kept here as the baseline
+ * @param entries The entries of the input
+ * @param valid A function that checks whether or not the password matches the policy
+ * @return int The number of matching passwords
+ */
+int getNumValidPasswords(const day2::EntryBatch &entries, const std::function<bool(const day2::Entry &)> &valid) {
+	int total = 0;
+	for (std::size_t i = 0; i < entries.size(); i++) {
+		total += valid(entries.getEntry(i));
+	}
+
+	return total;
+}
+
+// The chunk sizes that the chunked validator is checked with, as well as its default: the smaller ones give a small
+// input plenty of chunk boundaries to get wrong
+const std::vector<std::size_t> CHECKED_CHUNK_SIZES{4 * 1024, 64 * 1024};
+
+// A name, and a function that counts the passwords that are valid for each part
+using Validator = std::pair<std::string, std::function<std::pair<long, long>()>>;
+
+/**
+ * Time a validator, taking the fastest of several runs
+ * @param repetitions The number of times to run it
+ * @param validate Counts the passwords that are valid for each part
+ * @return std::pair<double, std::pair<long, long>> The fastest time in seconds, and the counts
+ * @throws std::runtime_error if the counts aren't the same on every run
+ */
+std::pair<double, std::pair<long, long>> measureValidator(
+	int repetitions, const std::function<std::pair<long, long>()> &validate) {
+	double fastest = 0;
+	std::pair<long, long> numValid;
+	for (int i = 0; i < repetitions; i++) {
+		auto start = std::chrono::steady_clock::now();
+		std::pair<long, long> runValid = validate();
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		if (i > 0 && runValid != numValid) {
+			throw std::runtime_error("counted differently on different runs");
+		}
+
+		numValid = runValid;
+		fastest = i == 0 ? elapsed.count() : std::min(fastest, elapsed.count());
+	}
+
+	return {fastest, numValid};
+}
+
+/**
+ * Time each of a set of validators, and print a table of how they compare to the first of them
+ * @param validators The validators, which must all count the same passwords as the first
+ * @param repetitions The number of times to run each of them
+ * @param numEntries The number of entries they check
+ * @param numBytes The size of the input they check
+ * @return bool Whether all of them agreed
+ */
+bool compareValidators(
+	const std::vector<Validator> &validators, int repetitions, std::size_t numEntries, std::size_t numBytes) {
+	std::cout << std::left << std::setw(16) << "validator" << std::setw(12) << "time (s)" << std::setw(10) << "speedup"
+			  << std::setw(14) << "entries/s"
+			  << "GB/s" << std::endl;
+	double baselineSeconds = 0;
+	std::pair<long, long> baselineValid;
+	for (const auto &[name, validate] : validators) {
+		std::pair<double, std::pair<long, long>> measurement;
+		try {
+			measurement = measureValidator(repetitions, validate);
+		} catch (const std::exception &e) {
+			std::cerr << name << " " << e.what() << std::endl;
+			return false;
+		}
+
+		auto [seconds, numValid] = measurement;
+		if (baselineSeconds == 0) {
+			baselineSeconds = seconds;
+			baselineValid = numValid;
+		} else if (numValid != baselineValid) {
+			std::cerr << name << " counted " << numValid.first << " and " << numValid.second << " valid passwords, not "
+					  << baselineValid.first << " and " << baselineValid.second << std::endl;
+			return false;
+		}
+
+		std::cout << std::fixed << std::setprecision(3) << std::setw(16) << name << std::setw(12) << seconds
+				  << std::setw(10) << baselineSeconds / seconds << std::setprecision(0) << std::setw(14)
+				  << numEntries / seconds << std::setprecision(2) << numBytes / seconds / 1e9 << std::endl;
+	}
+
+	return true;
+}
+
+int main(int argc, char *argv[]) {
+	int repetitions = DEFAULT_REPETITIONS;
+	std::string filename;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--repetitions" && i + 1 < argc && std::stoi(argv[i + 1]) > 0) {
+			repetitions = std::stoi(argv[++i]);
+		} else if (arg.rfind("--", 0) != 0 && filename.empty()) {
+			filename = arg;
+		} else {
+			filename.clear();
+			break;
+		}
+	}
+	if (filename.empty()) {
+		std::cerr << argv[0] << " [--repetitions n] <day2_input>" << std::endl;
+		return 1;
+	}
+
+	MappedInput input(filename);
+	std::string_view text = input.getContents();
+	day2::EntryBatch entries = day2::EntryBatch::parse(text);
+
+	// The validators of a batch that's already been parsed, relative to the per-entry ones they replaced
+	std::vector<Validator> batchValidators{
+		{"per-entry",
+		 [&entries]() {
+			 return std::make_pair<long, long>(
+				 getNumValidPasswords(entries, day2::isValidForPart1),
+				 getNumValidPasswords(entries, day2::isValidForPart2));
+		 }},
+		{"scalar", [&entries]() { return day2::countValidPasswordsScalar(entries); }},
+	};
+#if defined(__x86_64__)
+	if (__builtin_cpu_supports("avx2")) {
+		batchValidators.emplace_back("avx2", [&entries]() { return day2::countValidPasswordsAVX2(entries); });
+	}
+#endif
+
+	// Parsing and checking the whole input, on one thread and in chunks on every core, which must count the same
+	// passwords however the input is chunked
+	std::vector<Validator> inputValidators{
+		{"sequential", [text]() { return day2::countValidPasswords(day2::EntryBatch::parse(text)); }},
+		{"chunked", [text]() { return day2::countValidPasswordsInChunks(text, true); }},
+		{"chunked serial", [text]() { return day2::countValidPasswordsInChunks(text, false); }},
+	};
+	for (std::size_t chunkSize : CHECKED_CHUNK_SIZES) {
+		inputValidators.emplace_back("chunked (" + std::to_string(chunkSize / 1024) + "K)", [text, chunkSize]() {
+			return day2::countValidPasswordsInChunks(text, true, chunkSize);
+		});
+	}
+
+	// Both comparisons always run, so that a disagreement in one doesn't hide the other
+	bool batchesAgreed = compareValidators(batchValidators, repetitions, entries.size(), text.size());
+	std::cout << std::endl;
+	bool inputsAgreed = compareValidators(inputValidators, repetitions, entries.size(), text.size());
+
+	return batchesAgreed && inputsAgreed ? 0 : 1;
+}
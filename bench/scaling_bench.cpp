@@ -0,0 +1,421 @@
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../common/benchmark.hpp"
+#include "../common/solvers.hpp"
+
+constexpr int DEFAULT_NUM_STEPS = 5;
+constexpr double DEFAULT_GROWTH_FACTOR = 2;
+constexpr int DEFAULT_NUM_REPETITIONS = 3;
+// A run that takes longer than this (in seconds) is killed, and the sizes stop growing there
+constexpr int DEFAULT_TIME_LIMIT = 60;
+// Phases faster than this at every size are mostly timer noise, so no exponent is fit for them
+constexpr double MIN_FIT_NANOSECONDS = 50'000;
+// An exponent above this is flagged as super-linear. It leaves room for the log factor of sorting and tree lookups.
+constexpr double SUPER_LINEAR_EXPONENT = 1.2;
+// Memory that grows by less than this over the whole run is too close to the allocator's noise to fit
+constexpr long MIN_FIT_RSS_GROWTH_KIB = 1024;
+
+// The median time of each phase of a run, in nanoseconds, in the order the phases ran
+using PhaseTimes = std::vector<std::pair<std::string, double>>;
+
+/**
+ * The measurements of one run of a solver, on an input of one size
+ */
+class ScalingSample {
+ public:
+	ScalingSample(long size, long inputBytes, PhaseTimes phaseNanoseconds, long rssGrowthKiB)
+		: size(size),
+		  inputBytes(inputBytes),
+		  phaseNanoseconds(std::move(phaseNanoseconds)),
+		  rssGrowthKiB(rssGrowthKiB) {
+	}
+
+	/**
+	 * @return long The size the input was generated with
+	 */
+	long getSize() const {
+		return this->size;
+	}
+
+	long getInputBytes() const {
+		return this->inputBytes;
+	}
+
+	/**
+	 * @return const PhaseTimes& The median time of each phase, in the order they ran
+	 */
+	const PhaseTimes &getPhaseNanoseconds() const {
+		return this->phaseNanoseconds;
+	}
+
+	/**
+	 * @return long How much the peak RSS grew over the whole run, beyond what it was before the input was read
+	 */
+	long getRSSGrowthKiB() const {
+		return this->rssGrowthKiB;
+	}
+
+ private:
+	long size;
+	long inputBytes;
+	PhaseTimes phaseNanoseconds;
+	long rssGrowthKiB;
+};
+
+/**
+ * Fit y = c * x^k to some points by least squares on their logs
+ * @param points The (x, y) points, all of which must be positive
+ * @return std::optional<double> The exponent k, if there are at least two distinct x values to fit to
+ */
+std::optional<double> fitExponent(const std::vector<std::pair<double, double>> &points) {
+	double meanX = 0;
+	double meanY = 0;
+	for (const auto &[x, y] : points) {
+		meanX += std::log(x) / points.size();
+		meanY += std::log(y) / points.size();
+	}
+
+	double covariance = 0;
+	double variance = 0;
+	for (const auto &[x, y] : points) {
+		covariance += (std::log(x) - meanX) * (std::log(y) - meanY);
+		variance += (std::log(x) - meanX) * (std::log(x) - meanX);
+	}
+
+	if (points.size() < 2 || variance == 0) {
+		return std::nullopt;
+	}
+
+	return covariance / variance;
+}
+
+/**
+ * Write a generated input to a file, using the generate_input binary
+ * @param generatorPath The generate_input binary
+ * @param solverName The solver to generate an input for (e.g. day15)
+ * @param size The size of the input
+ * @param filename The file to write the input to
+ * @throws std::runtime_error if the generator fails
+ */
+void generateInput(
+	const std::string &generatorPath, const std::string &solverName, long size, const std::string &filename) {
+	// Both parts of day 17 share the one generator
+	std::string generatorName = solverName.rfind("day17", 0) == 0 ? "day17" : solverName;
+	pid_t pid = fork();
+	if (pid == -1) {
+		throw std::runtime_error("Could not fork");
+	} else if (pid == 0) {
+		int fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if (fd == -1 || dup2(fd, STDOUT_FILENO) == -1) {
+			_exit(1);
+		}
+
+		std::string sizeArg = std::to_string(size);
+		execl(generatorPath.c_str(), generatorPath.c_str(), generatorName.c_str(), sizeArg.c_str(), nullptr);
+		_exit(1);
+	}
+
+	int status;
+	waitpid(pid, &status, 0);
+	if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+		throw std::runtime_error("Could not generate a " + generatorName + " input of size " + std::to_string(size));
+	}
+}
+
+/**
+ * Run a solver on an input in a child process, so that its peak RSS is its own, and no size's run can leave anything
+ * behind (cached, or in the heap) for the next
+ * @param solve The solver
+ * @param filename The input
+ * @param numRepetitions The number of timed runs of each phase
+ * @param timeLimit The longest the whole run may take, in seconds
+ * @return std::optional<std::pair<PhaseTimes, long>> The median time of each phase, and how much the peak RSS of the
+ * child grew, unless the run took too long
+ * @throws std::runtime_error if the solver fails
+ */
+std::optional<std::pair<PhaseTimes, long>> measureSolver(
+	SolveFunction solve, const std::string &filename, int numRepetitions, int timeLimit) {
+	int resultPipe[2];
+	if (pipe(resultPipe) == -1) {
+		throw std::runtime_error("Could not create pipe");
+	}
+
+	pid_t pid = fork();
+	if (pid == -1) {
+		throw std::runtime_error("Could not fork");
+	} else if (pid == 0) {
+		close(resultPipe[0]);
+		alarm(timeLimit);
+		std::ostringstream result;
+		try {
+			struct rusage usage;
+			getrusage(RUSAGE_SELF, &usage);
+			long baselineRSSKiB = usage.ru_maxrss;
+
+			BenchmarkRunner runner(0, numRepetitions);
+			MappedInput input = runner.phase("read", [&filename]() { return MappedInput(filename); });
+			solve(runner, input);
+			for (const PhaseSamples &samples : runner.getPhaseSamples()) {
+				result << samples.getName() << '\t' << samples.getPercentile(50) << '\n';
+			}
+
+			getrusage(RUSAGE_SELF, &usage);
+			result << "rss\t" << usage.ru_maxrss - baselineRSSKiB << '\n';
+		} catch (const std::exception &e) {
+			result.str("");
+			result << "error\t" << e.what() << '\n';
+		} catch (...) {
+			// Some of the solvers throw pointers to exceptions, which can't be inspected without leaking them
+			result.str("");
+			result << "error\tunknown\n";
+		}
+
+		std::string resultText = result.str();
+		write(resultPipe[1], resultText.data(), resultText.size());
+		_exit(0);
+	}
+
+	close(resultPipe[1]);
+	std::string resultText;
+	char buffer[4096];
+	ssize_t numRead;
+	while ((numRead = read(resultPipe[0], buffer, sizeof(buffer))) > 0) {
+		resultText.append(buffer, numRead);
+	}
+
+	close(resultPipe[0]);
+	int status;
+	waitpid(pid, &status, 0);
+	if (WIFSIGNALED(status) && WTERMSIG(status) == SIGALRM) {
+		return std::nullopt;
+	}
+
+	PhaseTimes phaseNanoseconds;
+	long rssGrowthKiB = -1;
+	for (std::string_view line : MappedInput::splitLines(resultText)) {
+		std::size_t tab = line.find('\t');
+		std::string name(line.substr(0, tab));
+		std::string value(line.substr(tab + 1));
+		if (name == "error") {
+			throw std::runtime_error(value);
+		} else if (name == "rss") {
+			rssGrowthKiB = std::stol(value);
+		} else {
+			phaseNanoseconds.emplace_back(name, std::stod(value));
+		}
+	}
+
+	if (rssGrowthKiB < 0) {
+		throw std::runtime_error("The solver crashed");
+	}
+
+	return std::make_pair(phaseNanoseconds, rssGrowthKiB);
+}
+
+/**
+ * Write one row of the report
+ * @param os The stream to write to
+ * @param fields The fields of the row
+ * @param markdown Whether to write a Markdown table row, rather than CSV
+ */
+void writeRow(std::ostream &os, const std::vector<std::string> &fields, bool markdown) {
+	for (std::size_t i = 0; i < fields.size(); i++) {
+		os << (markdown ? "| " : (i == 0 ? "" : ",")) << fields.at(i) << (markdown ? " " : "");
+	}
+
+	os << (markdown ? "|" : "") << '\n';
+}
+
+std::string formatNumber(std::optional<double> value, int precision) {
+	if (!value) {
+		return "";
+	}
+
+	std::ostringstream formatted;
+	formatted << std::fixed << std::setprecision(precision) << *value;
+
+	return formatted.str();
+}
+
+/**
+ * Write the report for one solver: a row per phase, with the exponents fit to its time (and the solver's memory)
+ * @param os The stream to write to
+ * @param solverName The name of the solver
+ * @param samples The samples of the solver, in increasing order of size
+ * @param markdown Whether to write Markdown table rows, rather than CSV
+ */
+void writeSolverReport(
+	std::ostream &os, const std::string &solverName, const std::vector<ScalingSample> &samples, bool markdown) {
+	std::vector<std::pair<double, double>> memoryPoints;
+	for (const ScalingSample &sample : samples) {
+		if (sample.getRSSGrowthKiB() >= MIN_FIT_RSS_GROWTH_KIB) {
+			memoryPoints.emplace_back(sample.getSize(), sample.getRSSGrowthKiB());
+		}
+	}
+
+	std::optional<double> memoryExponent = fitExponent(memoryPoints);
+	const ScalingSample &largest = samples.back();
+	for (const auto &[phaseName, largestNanoseconds] : largest.getPhaseNanoseconds()) {
+		std::vector<std::pair<double, double>> timePoints;
+		for (const ScalingSample &sample : samples) {
+			const PhaseTimes &phaseNanoseconds = sample.getPhaseNanoseconds();
+			auto nanoseconds = std::find_if(phaseNanoseconds.cbegin(), phaseNanoseconds.cend(), [&](const auto &phase) {
+				return phase.first == phaseName;
+			});
+			if (nanoseconds != phaseNanoseconds.cend() && nanoseconds->second >= MIN_FIT_NANOSECONDS) {
+				timePoints.emplace_back(sample.getSize(), nanoseconds->second);
+			}
+		}
+
+		std::optional<double> timeExponent = fitExponent(timePoints);
+		std::string flag;
+		if (timeExponent && *timeExponent > SUPER_LINEAR_EXPONENT) {
+			flag = "super-linear time";
+		}
+		if (memoryExponent && *memoryExponent > SUPER_LINEAR_EXPONENT) {
+			flag += flag.empty() ? "super-linear memory" : ", memory";
+		}
+
+		writeRow(
+			os,
+			{solverName,
+			 phaseName,
+			 std::to_string(samples.front().getSize()) + "-" + std::to_string(largest.getSize()),
+			 std::to_string(largest.getInputBytes()),
+			 formatNumber(largestNanoseconds / 1e6, 3),
+			 formatNumber(timeExponent, 2),
+			 formatNumber(memoryExponent, 2),
+			 flag},
+			markdown);
+	}
+}
+
+/**
+ * Find a solver by its name
+ * @param name The name of the solver (e.g. day15)
+ * @return SolveFunction The solver
+ * @throws std::invalid_argument if there is no solver with this name
+ */
+SolveFunction findSolver(const std::string &name) {
+	auto solverIt = std::find_if(SOLVERS.cbegin(), SOLVERS.cend(), [&name](const auto &solver) {
+		return solver.first == name;
+	});
+	if (solverIt == SOLVERS.cend()) {
+		throw std::invalid_argument("No solver named " + name);
+	}
+
+	return solverIt->second;
+}
+
+int main(int argc, char *argv[]) {
+	// By default, the generator is the one built alongside this binary
+	std::string generatorPath =
+		(std::filesystem::read_symlink("/proc/self/exe").parent_path() / "generate_input").string();
+	int numSteps = DEFAULT_NUM_STEPS;
+	double growthFactor = DEFAULT_GROWTH_FACTOR;
+	int numRepetitions = DEFAULT_NUM_REPETITIONS;
+	int timeLimit = DEFAULT_TIME_LIMIT;
+	bool markdown = false;
+	// Pairs of solver name and the size of its smallest input
+	std::vector<std::pair<std::string, long>> solvers;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--generator" && i + 1 < argc) {
+			generatorPath = argv[++i];
+		} else if (arg == "--steps" && i + 1 < argc) {
+			numSteps = std::stoi(argv[++i]);
+		} else if (arg == "--factor" && i + 1 < argc) {
+			growthFactor = std::stod(argv[++i]);
+		} else if (arg == "--repetitions" && i + 1 < argc) {
+			numRepetitions = std::stoi(argv[++i]);
+		} else if (arg == "--time-limit" && i + 1 < argc) {
+			timeLimit = std::stoi(argv[++i]);
+		} else if (arg == "--markdown") {
+			markdown = true;
+		} else if (arg.find('=') != std::string::npos) {
+			auto equalsIndex = arg.find('=');
+			solvers.emplace_back(arg.substr(0, equalsIndex), std::stol(arg.substr(equalsIndex + 1)));
+		} else {
+			solvers.clear();
+			break;
+		}
+	}
+
+	if (solvers.empty() || numSteps < 2 || growthFactor <= 1 || timeLimit < 1) {
+		std::cerr << argv[0] << " [--generator path] [--steps n] [--factor f] [--repetitions n] [--time-limit seconds]"
+				  << " [--markdown] <solver>=<start_size>..." << std::endl;
+		std::cerr << "e.g. " << argv[0] << " --markdown day7=500 day9=1000 day16=100" << std::endl;
+		return 1;
+	}
+
+	std::string scratchFilename =
+		std::filesystem::temp_directory_path() / ("scaling_bench." + std::to_string(getpid()));
+	writeRow(
+		std::cout,
+		{"solver",
+		 "phase",
+		 "sizes",
+		 "largest_input_bytes",
+		 "largest_median_ms",
+		 "time_exponent",
+		 "memory_exponent",
+		 "flag"},
+		markdown);
+	if (markdown) {
+		writeRow(std::cout, std::vector<std::string>(8, "---"), markdown);
+	}
+
+	bool allMeasured = true;
+	for (const auto &[solverName, startSize] : solvers) {
+		try {
+			SolveFunction solve = findSolver(solverName);
+			std::vector<ScalingSample> samples;
+			double size = startSize;
+			for (int step = 0; step < numSteps; step++, size *= growthFactor) {
+				long roundedSize = std::lround(size);
+				generateInput(generatorPath, solverName, roundedSize, scratchFilename);
+				auto measurement = measureSolver(solve, scratchFilename, numRepetitions, timeLimit);
+				if (!measurement) {
+					std::cerr << solverName << " took over " << timeLimit << "s at size " << roundedSize
+							  << ", so no larger sizes were run" << std::endl;
+					break;
+				}
+
+				long inputBytes = std::filesystem::file_size(scratchFilename);
+				samples.emplace_back(roundedSize, inputBytes, std::move(measurement->first), measurement->second);
+			}
+
+			if (samples.size() < 2) {
+				throw std::runtime_error("Too few sizes ran in time to fit anything to");
+			}
+
+			writeSolverReport(std::cout, solverName, samples, markdown);
+		} catch (const std::exception &e) {
+			std::cerr << "Could not measure " << solverName << ": " << e.what() << std::endl;
+			allMeasured = false;
+		}
+
+		std::cout.flush();
+	}
+
+	std::remove(scratchFilename.c_str());
+
+	return allMeasured ? 0 : 1;
+}
@@ -0,0 +1,241 @@
+#ifndef COMMON_ALLOCATIONS_HPP
+#define COMMON_ALLOCATIONS_HPP
+
+#include <malloc.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+/**
+ * The heap traffic of a single phase of a solution
+ */
+class AllocationCounts {
+ public:
+	AllocationCounts(long numAllocations, long allocatedBytes, long peakLiveBytes)
+		: numAllocations(numAllocations), allocatedBytes(allocatedBytes), peakLiveBytes(peakLiveBytes) {
+	}
+
+	long getNumAllocations() const {
+		return this->numAllocations;
+	}
+
+	/**
+	 * @return long The total number of bytes requested by the phase's allocations, whether or not they were freed
+	 */
+	long getAllocatedBytes() const {
+		return this->allocatedBytes;
+	}
+
+	/**
+	 * @return long The most heap memory that was live at once during the phase, including anything that was already
+	 * live when it started
+	 */
+	long getPeakLiveBytes() const {
+		return this->peakLiveBytes;
+	}
+
+ private:
+	long numAllocations;
+	long allocatedBytes;
+	long peakLiveBytes;
+};
+
+// Counting is off unless a run asks for it, so that the hooks below cost a normal run a single load. It should be
+// turned on once, before the run starts; memory allocated before then is never counted as live, even once it is freed.
+inline std::atomic<bool> allocationCountingEnabled = false;
+
+// The running totals of the current thread. A solver's phases all run on one thread, so keeping these per thread keeps
+// the counts of concurrent solvers apart, and keeps the hooks free of contention. Live bytes are tracked using the
+// allocator's usable size, since unsized deletes don't say how much they free.
+struct AllocationTotals {
+	long numAllocations;
+	long allocatedBytes;
+	long liveBytes;
+	long peakLiveBytes;
+};
+inline thread_local AllocationTotals allocationTotals{};
+
+/**
+ * Counts the allocations made on this thread for as long as it is in scope
+ */
+class ScopedAllocationCounter {
+ public:
+	ScopedAllocationCounter()
+		: startNumAllocations(allocationTotals.numAllocations),
+		  startAllocatedBytes(allocationTotals.allocatedBytes),
+		  outerPeakLiveBytes(allocationTotals.peakLiveBytes) {
+		// The peak is reset so that this scope only sees its own, and it is put back together when the scope ends
+		allocationTotals.peakLiveBytes = allocationTotals.liveBytes;
+	}
+
+	ScopedAllocationCounter(const ScopedAllocationCounter &) = delete;
+	ScopedAllocationCounter &operator=(const ScopedAllocationCounter &) = delete;
+
+	~ScopedAllocationCounter() {
+		allocationTotals.peakLiveBytes = std::max(allocationTotals.peakLiveBytes, this->outerPeakLiveBytes);
+	}
+
+	/**
+	 * @return AllocationCounts The allocations made since this counter was created
+	 */
+	AllocationCounts getCounts() const {
+		return AllocationCounts(
+			allocationTotals.numAllocations - this->startNumAllocations,
+			allocationTotals.allocatedBytes - this->startAllocatedBytes,
+			allocationTotals.peakLiveBytes);
+	}
+
+ private:
+	long startNumAllocations;
+	long startAllocatedBytes;
+	long outerPeakLiveBytes;
+};
+
+// The hooks can only be defined once per program, so they are left out of the solvers that get linked into a shared
+// binary (see AOC_NO_MAIN), and are defined only alongside main
+#ifndef AOC_NO_MAIN
+namespace allocation_hooks {
+/**
+ * Allocate memory, counting the allocation if counting is enabled
+ * @param size The number of bytes to allocate
+ * @param alignment The alignment of the memory, or zero for the default alignment
+ * @return void* The memory, or nullptr if it could not be allocated
+ */
+inline void *allocate(std::size_t size, std::size_t alignment) {
+	void *ptr = nullptr;
+	if (alignment == 0) {
+		// malloc(0) may return nullptr, but operator new must not
+		ptr = std::malloc(size == 0 ? 1 : size);
+	} else if (posix_memalign(&ptr, alignment, size == 0 ? 1 : size) != 0) {
+		ptr = nullptr;
+	}
+
+	if (ptr != nullptr && allocationCountingEnabled.load(std::memory_order_relaxed)) {
+		allocationTotals.numAllocations++;
+		allocationTotals.allocatedBytes += size;
+		allocationTotals.liveBytes += malloc_usable_size(ptr);
+		allocationTotals.peakLiveBytes = std::max(allocationTotals.peakLiveBytes, allocationTotals.liveBytes);
+	}
+
+	return ptr;
+}
+
+/**
+ * Allocate memory, as the throwing forms of operator new do
+ * @param size The number of bytes to allocate
+ * @param alignment The alignment of the memory, or zero for the default alignment
+ * @return void* The memory
+ * @throws std::bad_alloc if the memory could not be allocated
+ */
+inline void *allocateOrThrow(std::size_t size, std::size_t alignment) {
+	void *ptr = allocate(size, alignment);
+	if (ptr == nullptr) {
+		throw std::bad_alloc();
+	}
+
+	return ptr;
+}
+
+/**
+ * Free memory from allocate
+ * @param ptr The memory to free
+ */
+inline void deallocate(void *ptr) {
+	if (ptr == nullptr) {
+		return;
+	}
+
+	if (allocationCountingEnabled.load(std::memory_order_relaxed)) {
+		// Freeing something that was allocated before counting began would otherwise take this below zero
+		long liveBytes = allocationTotals.liveBytes - static_cast<long>(malloc_usable_size(ptr));
+		allocationTotals.liveBytes = std::max(0L, liveBytes);
+	}
+
+	std::free(ptr);
+}
+}  // namespace allocation_hooks
+
+void *operator new(std::size_t size) {
+	return allocation_hooks::allocateOrThrow(size, 0);
+}
+
+void *operator new[](std::size_t size) {
+	return allocation_hooks::allocateOrThrow(size, 0);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+	return allocation_hooks::allocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+	return allocation_hooks::allocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+	return allocation_hooks::allocate(size, 0);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+	return allocation_hooks::allocate(size, 0);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+	return allocation_hooks::allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+	return allocation_hooks::allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *ptr) noexcept {
+	allocation_hooks::deallocate(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+	allocation_hooks::deallocate(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+	allocation_hooks::deallocate(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept {
+	allocation_hooks::deallocate(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept {
+	allocation_hooks::deallocate(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t) noexcept {
+	allocation_hooks::deallocate(ptr);
+}
+
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept {
+	allocation_hooks::deallocate(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept {
+	allocation_hooks::deallocate(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+	allocation_hooks::deallocate(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+	allocation_hooks::deallocate(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t, const std::nothrow_t &) noexcept {
+	allocation_hooks::deallocate(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t, const std::nothrow_t &) noexcept {
+	allocation_hooks::deallocate(ptr);
+}
+#endif
+
+#endif
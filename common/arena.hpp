@@ -0,0 +1,240 @@
+#ifndef COMMON_ARENA_HPP
+#define COMMON_ARENA_HPP
+
+#include <linux/mempolicy.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace arena_detail {
+// The size of a transparent huge page, which is what every region is aligned to and rounded up to
+constexpr std::size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+// Small blocks are carved out of chunks of this size, which holds a good number of huge pages
+constexpr std::size_t CHUNK_SIZE = 16 * HUGE_PAGE_SIZE;
+// Blocks at least this large get a region of their own, which is unmapped as soon as they are freed
+constexpr std::size_t LARGE_BLOCK_SIZE = HUGE_PAGE_SIZE;
+// Blocks are handed out in multiples of this, which is also the most alignment a block gets
+constexpr std::size_t BLOCK_ALIGNMENT = 16;
+// Freed blocks up to this size are kept on a free list for their size, to be reused by the next block of that size
+constexpr std::size_t MAX_POOLED_SIZE = 512;
+constexpr std::size_t NUM_POOLS = MAX_POOLED_SIZE / BLOCK_ALIGNMENT;
+
+/**
+ * Map a region, and ask for it to be backed by huge pages and placed on a NUMA node. Both of those are only advice,
+ * which the kernel (or a container) is free to ignore.
+ * @param size The size of the region, which must be a multiple of HUGE_PAGE_SIZE
+ * @param hugePages Whether to ask for huge pages
+ * @param numaNode The NUMA node to place the region on, or -1 to leave that to the kernel
+ * @return void* The region, which is aligned to HUGE_PAGE_SIZE
+ * @throws std::bad_alloc if the region can't be mapped
+ */
+inline void *mapRegion(std::size_t size, bool hugePages, int numaNode) {
+	// A huge page can only back an aligned range of addresses, so map extra, and trim it off around an aligned region
+	std::size_t mappedSize = size + HUGE_PAGE_SIZE;
+	void *mapping =
+		mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (mapping == MAP_FAILED) {
+		throw std::bad_alloc();
+	}
+
+	std::uintptr_t mappingStart = reinterpret_cast<std::uintptr_t>(mapping);
+	std::uintptr_t regionStart = (mappingStart + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+	if (regionStart != mappingStart) {
+		munmap(mapping, regionStart - mappingStart);
+	}
+	if (regionStart + size != mappingStart + mappedSize) {
+		munmap(reinterpret_cast<void *>(regionStart + size), mappingStart + mappedSize - (regionStart + size));
+	}
+
+	void *region = reinterpret_cast<void *>(regionStart);
+	madvise(region, size, hugePages ? MADV_HUGEPAGE : MADV_NOHUGEPAGE);
+	if (numaNode >= 0 && numaNode < static_cast<int>(sizeof(unsigned long) * 8)) {
+		// Preferred, rather than bound, so that a full node spills over onto the others instead of failing
+		unsigned long nodeMask = 1UL << numaNode;
+		syscall(SYS_mbind, region, size, MPOL_PREFERRED, &nodeMask, sizeof(nodeMask) * 8, 0);
+	}
+
+	return region;
+}
+
+/**
+ * @return int The NUMA node of the CPU the calling thread is running on, or -1 if it can't be found
+ */
+inline int findLocalNUMANode() {
+	unsigned int cpu;
+	unsigned int node;
+	if (syscall(SYS_getcpu, &cpu, &node, nullptr) == -1) {
+		return -1;
+	}
+
+	return node;
+}
+}  // namespace arena_detail
+
+// Whether new arenas ask for huge pages. This is only ever turned off to measure what they save.
+inline bool arenaHugePagesEnabled = true;
+
+/**
+ * An arena for containers that hold a lot of state, whose memory is backed by transparent huge pages (so that it takes
+ * far fewer TLB entries to cover), and placed on the NUMA node of the thread that made the arena. Small blocks (like
+ * the nodes of a map) are carved out of large chunks, and are reused by later blocks of the same size once they're
+ * freed. Large blocks (like a vector's storage) each get a region of their own, which is unmapped when they're freed.
+ * Blocks in between are only given back when the arena is destroyed, so an arena suits a container that grows
+ * geometrically, not one that churns through blocks of every size. An arena is not thread-safe, and the memory it hands
+ * out isn't seen by --allocations, which only counts operator new.
+ */
+class HugePageArena {
+ public:
+	/**
+	 * @param hugePages Whether to ask for huge pages
+	 */
+	explicit HugePageArena(bool hugePages = arenaHugePagesEnabled)
+		: hugePages(hugePages), numaNode(arena_detail::findLocalNUMANode()) {
+	}
+
+	HugePageArena(const HugePageArena &) = delete;
+	HugePageArena &operator=(const HugePageArena &) = delete;
+
+	~HugePageArena() {
+		for (const auto &[region, size] : this->chunks) {
+			munmap(region, size);
+		}
+	}
+
+	bool getHugePages() const {
+		return this->hugePages;
+	}
+
+	/**
+	 * @return int The NUMA node the arena's memory is placed on, or -1 if it's left to the kernel
+	 */
+	int getNUMANode() const {
+		return this->numaNode;
+	}
+
+	/**
+	 * Allocate a block
+	 * @param size The size of the block
+	 * @return void* The block, which is aligned to arena_detail::BLOCK_ALIGNMENT
+	 * @throws std::bad_alloc if there's no memory left for it
+	 */
+	void *allocate(std::size_t size) {
+		using namespace arena_detail;
+		std::size_t blockSize = roundUp(std::max<std::size_t>(size, 1), BLOCK_ALIGNMENT);
+		if (blockSize >= LARGE_BLOCK_SIZE) {
+			return mapRegion(roundUp(blockSize, HUGE_PAGE_SIZE), this->hugePages, this->numaNode);
+		} else if (blockSize <= MAX_POOLED_SIZE) {
+			FreeBlock *&freeList = this->freeLists.at(blockSize / BLOCK_ALIGNMENT - 1);
+			if (freeList != nullptr) {
+				FreeBlock *block = freeList;
+				freeList = block->next;
+				return block;
+			}
+		}
+
+		if (this->chunkRemaining < blockSize) {
+			this->chunkCursor = static_cast<char *>(mapRegion(CHUNK_SIZE, this->hugePages, this->numaNode));
+			this->chunkRemaining = CHUNK_SIZE;
+			this->chunks.emplace_back(this->chunkCursor, CHUNK_SIZE);
+		}
+
+		void *block = this->chunkCursor;
+		this->chunkCursor += blockSize;
+		this->chunkRemaining -= blockSize;
+
+		return block;
+	}
+
+	/**
+	 * Free a block
+	 * @param block The block, which must have come from this arena
+	 * @param size The size the block was allocated with
+	 */
+	void deallocate(void *block, std::size_t size) {
+		using namespace arena_detail;
+		std::size_t blockSize = roundUp(std::max<std::size_t>(size, 1), BLOCK_ALIGNMENT);
+		if (blockSize >= LARGE_BLOCK_SIZE) {
+			munmap(block, roundUp(blockSize, HUGE_PAGE_SIZE));
+		} else if (blockSize <= MAX_POOLED_SIZE) {
+			FreeBlock *&freeList = this->freeLists.at(blockSize / BLOCK_ALIGNMENT - 1);
+			freeList = new (block) FreeBlock{freeList};
+		}
+	}
+
+ private:
+	// A freed block, which holds the next free block of its size in the space it no longer needs
+	struct FreeBlock {
+		FreeBlock *next;
+	};
+
+	bool hugePages;
+	int numaNode;
+	// Every chunk, and its size, to unmap once the arena is destroyed
+	std::vector<std::pair<void *, std::size_t>> chunks;
+	char *chunkCursor = nullptr;
+	std::size_t chunkRemaining = 0;
+	std::array<FreeBlock *, arena_detail::NUM_POOLS> freeLists{};
+
+	static std::size_t roundUp(std::size_t size, std::size_t multiple) {
+		return (size + multiple - 1) / multiple * multiple;
+	}
+};
+
+/**
+ * A standard allocator that allocates from a HugePageArena, so that any standard container can be backed by one. The
+ * arena must outlive every container that uses it.
+ * @tparam T The type to allocate
+ */
+template <typename T>
+class ArenaAllocator {
+ public:
+	using value_type = T;
+	// Containers that are moved or swapped keep the arena their memory came from
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+
+	explicit ArenaAllocator(HugePageArena &arena) : arena(&arena) {
+	}
+
+	template <typename U>
+	ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.getArena()) {
+	}
+
+	HugePageArena *getArena() const {
+		return this->arena;
+	}
+
+	T *allocate(std::size_t n) {
+		static_assert(alignof(T) <= arena_detail::BLOCK_ALIGNMENT, "The arena can't align blocks that strictly");
+		return static_cast<T *>(this->arena->allocate(n * sizeof(T)));
+	}
+
+	void deallocate(T *block, std::size_t n) {
+		this->arena->deallocate(block, n * sizeof(T));
+	}
+
+	template <typename U>
+	bool operator==(const ArenaAllocator<U> &other) const {
+		return this->arena == other.getArena();
+	}
+
+	template <typename U>
+	bool operator!=(const ArenaAllocator<U> &other) const {
+		return this->arena != other.getArena();
+	}
+
+ private:
+	HugePageArena *arena;
+};
+
+#endif
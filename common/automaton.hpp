@@ -0,0 +1,524 @@
+#ifndef COMMON_AUTOMATON_HPP
+#define COMMON_AUTOMATON_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "arena.hpp"
+
+namespace automaton_detail {
+constexpr int WORD_BITS = 64;
+// The number of words that are updated at once. GCC's vector extensions turn each operation on a block into as few SIMD
+// instructions as the target has room for (e.g. one with AVX2, two with SSE2). Blocks are only ever passed around by
+// reference, since passing them by value has a different calling convention with and without AVX.
+constexpr int BLOCK_WORDS = 4;
+using Block = std::uint64_t __attribute__((vector_size(BLOCK_WORDS * sizeof(std::uint64_t))));
+
+__attribute__((always_inline)) inline void loadBlock(Block &block, const std::uint64_t *words) {
+	std::memcpy(&block, words, sizeof(block));
+}
+
+__attribute__((always_inline)) inline void storeBlock(std::uint64_t *words, const Block &block) {
+	std::memcpy(words, &block, sizeof(block));
+}
+
+constexpr int power(int base, int exponent) {
+	return exponent == 0 ? 1 : base * power(base, exponent - 1);
+}
+
+constexpr int bitWidth(int value) {
+	return value == 0 ? 0 : 1 + bitWidth(value >> 1);
+}
+}  // namespace automaton_detail
+
+/**
+ * The rules of a life-like automaton: how many live neighbors bring a dead cell to life, and how many keep a live cell
+ * alive. Every other cell dies (or stays dead).
+ */
+class AutomatonRule {
+ public:
+	AutomatonRule(std::vector<int> birthCounts, std::vector<int> survivalCounts)
+		: birthCounts(std::move(birthCounts)), survivalCounts(std::move(survivalCounts)) {
+	}
+
+	const std::vector<int> &getBirthCounts() const {
+		return this->birthCounts;
+	}
+
+	const std::vector<int> &getSurvivalCounts() const {
+		return this->survivalCounts;
+	}
+
+ private:
+	std::vector<int> birthCounts;
+	std::vector<int> survivalCounts;
+};
+
+/**
+ * The shape of a cell's neighborhood, as the offsets from a cell to each of its neighbors. Every neighbor must be
+ * adjacent along every axis (i.e. each component of an offset is -1, 0, or 1).
+ * @tparam Dimensions The number of dimensions of the grid
+ */
+template <int Dimensions>
+class Topology {
+ public:
+	using Offset = std::array<int, Dimensions>;
+
+	/**
+	 * @param offsets The offsets from a cell to each of its neighbors
+	 * @throws std::invalid_argument if an offset doesn't lead to an adjacent cell
+	 */
+	explicit Topology(std::vector<Offset> offsets) : offsets(std::move(offsets)) {
+		for (const Offset &offset : this->offsets) {
+			bool isAdjacent = std::all_of(offset.cbegin(), offset.cend(), [](int component) {
+				return component >= -1 && component <= 1;
+			});
+			bool isSelf = std::all_of(offset.cbegin(), offset.cend(), [](int component) { return component == 0; });
+			if (!isAdjacent || isSelf) {
+				throw std::invalid_argument("Neighbors must be adjacent cells");
+			}
+		}
+	}
+
+	/**
+	 * @return Topology Every cell that touches a cell, even at a corner (e.g. the 8 surrounding cells of a square grid)
+	 */
+	static Topology moore() {
+		std::vector<Offset> offsets;
+		for (int i = 0; i < automaton_detail::power(3, Dimensions); i++) {
+			Offset offset;
+			int remaining = i;
+			for (int &component : offset) {
+				component = remaining % 3 - 1;
+				remaining /= 3;
+			}
+
+			if (std::any_of(offset.cbegin(), offset.cend(), [](int component) { return component != 0; })) {
+				offsets.push_back(offset);
+			}
+		}
+
+		return Topology(std::move(offsets));
+	}
+
+	/**
+	 * @return Topology The six neighbors of a hexagonal grid, in axial coordinates. That is, the neighbors are at
+	 * (±1, 0), (0, ±1), (1, 1), and (-1, -1).
+	 */
+	static Topology hex() {
+		static_assert(Dimensions == 2, "A hex grid is two dimensional");
+		return Topology({{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {-1, -1}});
+	}
+
+	const std::vector<Offset> &getOffsets() const {
+		return this->offsets;
+	}
+
+ private:
+	std::vector<Offset> offsets;
+};
+
+/**
+ * A life-like cellular automaton on a bounded grid of any number of dimensions. Cells are packed 64 to a word along the
+ * last axis, and two copies of the grid are kept, so that each generation is written into the one the last wasn't. The
+ * neighbors of a block of words are counted all at once, by adding up shifted copies of the neighboring words in
+ * bit-sliced counters, with AVX2 when the machine supports it. Cells outside of the grid are always dead.
+ * @tparam Dimensions The number of dimensions of the grid
+ */
+template <int Dimensions>
+class CellularAutomaton {
+ public:
+	using Coordinates = std::array<int, Dimensions>;
+
+	/**
+	 * @param size The size of the grid along each axis. The last axis is the one that is packed, so it should be the
+	 * largest.
+	 * @param topology The neighbors of each cell
+	 * @param rule The rules to update each cell with
+	 * @throws std::invalid_argument if the grid is empty
+	 */
+	CellularAutomaton(Coordinates size, const Topology<Dimensions> &topology, AutomatonRule rule)
+		: size(size), rule(std::move(rule)) {
+		if (std::any_of(size.cbegin(), size.cend(), [](int length) { return length < 1; })) {
+			throw std::invalid_argument("Grid must have at least one cell along each axis");
+		}
+
+		// Rows are made up of whole blocks, with an empty word on either side, so that the words at their ends have
+		// neighbors like any other
+		int numBlockBits = automaton_detail::WORD_BITS * automaton_detail::BLOCK_WORDS;
+		this->wordsPerRow = (size.back() + numBlockBits - 1) / numBlockBits * automaton_detail::BLOCK_WORDS;
+		this->rowStride = this->wordsPerRow + 2;
+		this->numRows = 1;
+		for (int axis = 0; axis < Dimensions - 1; axis++) {
+			this->numRows *= size.at(axis);
+		}
+
+		std::size_t numWords = this->numRows * this->rowStride;
+		this->cells.resize(numWords);
+		this->nextCells.resize(numWords);
+		// Every cell can live until told otherwise, except for the padding around each row
+		this->livable.resize(numWords);
+		int numFullWords = size.back() / automaton_detail::WORD_BITS;
+		int tailBits = size.back() % automaton_detail::WORD_BITS;
+		for (std::size_t row = 0; row < this->numRows; row++) {
+			auto rowStart = this->livable.begin() + row * this->rowStride + 1;
+			std::fill(rowStart, rowStart + numFullWords, ~std::uint64_t(0));
+			if (tailBits != 0) {
+				*(rowStart + numFullWords) = (std::uint64_t(1) << tailBits) - 1;
+			}
+		}
+
+		// Every neighbor in the same row (i.e. the same position along every axis but the last) can be counted from the
+		// same words
+		std::map<RowOffset, std::array<std::uint64_t, 3>> innerShiftsByRow;
+		for (const auto &offset : topology.getOffsets()) {
+			RowOffset rowOffset;
+			std::copy(offset.cbegin(), offset.cend() - 1, rowOffset.begin());
+			innerShiftsByRow[rowOffset].at(offset.back() + 1) = ~std::uint64_t(0);
+		}
+		for (const auto &entry : innerShiftsByRow) {
+			this->neighborRows.push_back(NeighborRow{entry.first, entry.second});
+		}
+	}
+
+	CellularAutomaton(CellularAutomaton &&) = default;
+	// Assigning would replace the arena (freeing the old one) before the grids could give their memory back to it
+	CellularAutomaton &operator=(CellularAutomaton &&) = delete;
+
+	const Coordinates &getSize() const {
+		return this->size;
+	}
+
+	/**
+	 * @param position The position of the cell
+	 * @return bool Whether the cell is alive. Cells outside of the grid are never alive.
+	 */
+	bool isAlive(const Coordinates &position) const {
+		if (!this->isInBounds(position)) {
+			return false;
+		}
+
+		auto location = this->locate(position);
+		return (this->cells.at(location.first) & location.second) != 0;
+	}
+
+	/**
+	 * Bring a cell to life, or kill it. A cell that can't live will stay dead.
+	 * @param position The position of the cell
+	 * @param alive Whether the cell should be alive
+	 * @throws std::out_of_range if the cell is outside of the grid
+	 */
+	void setAlive(const Coordinates &position, bool alive = true) {
+		auto location = this->checkedLocate(position);
+		std::uint64_t &word = this->cells.at(location.first);
+		word = alive ? (word | location.second) : (word & ~location.second);
+		word &= this->livable.at(location.first);
+	}
+
+	/**
+	 * Set whether a cell can ever be alive (e.g. because it's a wall), killing it if it can't
+	 * @param position The position of the cell
+	 * @param livable Whether the cell can be alive
+	 * @throws std::out_of_range if the cell is outside of the grid
+	 */
+	void setLivable(const Coordinates &position, bool livable) {
+		auto location = this->checkedLocate(position);
+		std::uint64_t &word = this->livable.at(location.first);
+		word = livable ? (word | location.second) : (word & ~location.second);
+		this->cells.at(location.first) &= word;
+	}
+
+	/**
+	 * Advance every cell by one generation
+	 * @return bool Whether any cell changed
+	 */
+	bool step() {
+		std::uint64_t changed = 0;
+		RowOffset rowPosition{};
+		std::vector<RowSource> sources;
+		sources.reserve(this->neighborRows.size());
+		for (std::size_t row = 0; row < this->numRows; row++) {
+			sources.clear();
+			for (const NeighborRow &neighborRow : this->neighborRows) {
+				std::optional<std::size_t> neighborRowIndex = this->getRowIndex(rowPosition, neighborRow.offset);
+				if (neighborRowIndex) {
+					sources.push_back(RowSource{
+						this->cells.data() + *neighborRowIndex * this->rowStride, neighborRow.innerShiftMasks});
+				}
+			}
+
+			changed |= this->stepRow(row, sources);
+			this->advanceRowPosition(rowPosition);
+		}
+
+		std::swap(this->cells, this->nextCells);
+
+		return changed != 0;
+	}
+
+	/**
+	 * Advance every cell until nothing changes
+	 * @return long The number of generations that changed something
+	 */
+	long stepUntilStable() {
+		long numGenerations = 0;
+		while (this->step()) {
+			numGenerations++;
+		}
+
+		return numGenerations;
+	}
+
+	/**
+	 * @return long The number of live cells in the grid
+	 */
+	long countAlive() const {
+		long numAlive = 0;
+		for (std::uint64_t word : this->cells) {
+			numAlive += __builtin_popcountll(word);
+		}
+
+		return numAlive;
+	}
+
+ private:
+	// A position, or an offset between positions, along every axis but the last
+	using RowOffset = std::array<int, Dimensions - 1>;
+
+	/**
+	 * The neighbors of a cell that are in one row
+	 */
+	struct NeighborRow {
+		// The offset from the cell's row to the neighbors' row
+		RowOffset offset;
+		// Whether the neighbors are at -1, 0, and 1 along the last axis, respectively, as masks of all or none of the
+		// bits, so that counting them doesn't need to branch
+		std::array<std::uint64_t, 3> innerShiftMasks;
+	};
+
+	/**
+	 * A row that neighbors the row being updated
+	 */
+	struct RowSource {
+		const std::uint64_t *words;
+		std::array<std::uint64_t, 3> innerShiftMasks;
+	};
+
+	// The number of bits needed to count every neighbor of a cell, in the worst case (the Moore neighborhood)
+	static constexpr int NUM_COUNT_BITS = automaton_detail::bitWidth(automaton_detail::power(3, Dimensions) - 1);
+
+	Coordinates size;
+	AutomatonRule rule;
+	std::vector<NeighborRow> neighborRows;
+	std::size_t numRows;
+	std::size_t wordsPerRow;
+	std::size_t rowStride;
+	// Each step sweeps all three grids, which are kept on huge pages. The arena lives on the heap, so that moving the
+	// automaton doesn't leave the grids' allocators pointing at the old one.
+	std::unique_ptr<HugePageArena> arena = std::make_unique<HugePageArena>();
+	std::vector<std::uint64_t, ArenaAllocator<std::uint64_t>> cells{ArenaAllocator<std::uint64_t>(*this->arena)};
+	std::vector<std::uint64_t, ArenaAllocator<std::uint64_t>> nextCells{ArenaAllocator<std::uint64_t>(*this->arena)};
+	std::vector<std::uint64_t, ArenaAllocator<std::uint64_t>> livable{ArenaAllocator<std::uint64_t>(*this->arena)};
+
+	bool isInBounds(const Coordinates &position) const {
+		for (int axis = 0; axis < Dimensions; axis++) {
+			if (position.at(axis) < 0 || position.at(axis) >= this->size.at(axis)) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/**
+	 * Find the word that holds a cell
+	 * @param position The position of the cell, which must be in bounds
+	 * @return std::pair<std::size_t, std::uint64_t> The index of the word, and the cell's bit in it
+	 */
+	std::pair<std::size_t, std::uint64_t> locate(const Coordinates &position) const {
+		std::size_t row = 0;
+		for (int axis = 0; axis < Dimensions - 1; axis++) {
+			row = row * this->size.at(axis) + position.at(axis);
+		}
+
+		int column = position.back();
+		return std::make_pair(
+			row * this->rowStride + 1 + column / automaton_detail::WORD_BITS,
+			std::uint64_t(1) << (column % automaton_detail::WORD_BITS));
+	}
+
+	std::pair<std::size_t, std::uint64_t> checkedLocate(const Coordinates &position) const {
+		if (!this->isInBounds(position)) {
+			throw std::out_of_range("Cell is outside of the grid");
+		}
+
+		return this->locate(position);
+	}
+
+	/**
+	 * Find the row at an offset from another
+	 * @param rowPosition The position of the row
+	 * @param offset The offset to the other row
+	 * @return std::optional<std::size_t> The index of the other row, if it is in the grid
+	 */
+	std::optional<std::size_t> getRowIndex(const RowOffset &rowPosition, const RowOffset &offset) const {
+		std::size_t row = 0;
+		for (int axis = 0; axis < Dimensions - 1; axis++) {
+			int component = rowPosition.at(axis) + offset.at(axis);
+			if (component < 0 || component >= this->size.at(axis)) {
+				return std::nullopt;
+			}
+
+			row = row * this->size.at(axis) + component;
+		}
+
+		return row;
+	}
+
+	/**
+	 * Move a row position on to the next row, in the order the rows are stored
+	 * @param rowPosition The position to move
+	 */
+	void advanceRowPosition(RowOffset &rowPosition) const {
+		for (int axis = Dimensions - 2; axis >= 0; axis--) {
+			if (++rowPosition.at(axis) < this->size.at(axis)) {
+				return;
+			}
+
+			rowPosition.at(axis) = 0;
+		}
+	}
+
+	// The bit planes of the counts of a block of cells, least significant first
+	using BlockCounts = std::array<automaton_detail::Block, NUM_COUNT_BITS>;
+
+	/**
+	 * Add a bit to the count of each cell in a block
+	 * @param counts The counts to add to
+	 * @param place The place value of the bit that is being added (i.e. the first plane to add it to)
+	 * @param bits The bit to add to each cell's count
+	 */
+	__attribute__((always_inline)) static void addToCount(BlockCounts &counts, int place, const automaton_detail::Block &bits) {
+		automaton_detail::Block carry = bits;
+#pragma GCC unroll 8
+		for (int plane = place; plane < NUM_COUNT_BITS; plane++) {
+			automaton_detail::Block nextCarry = counts[plane] & carry;
+			counts[plane] ^= carry;
+			carry = nextCarry;
+		}
+	}
+
+	/**
+	 * Find the cells in a block whose count is exactly the given count
+	 * @param matches The block to add the matching cells to
+	 * @param counts The counts of the cells
+	 * @param count The count to match
+	 */
+	__attribute__((always_inline)) static void addMatches(
+		automaton_detail::Block &matches, const BlockCounts &counts, int count) {
+		automaton_detail::Block countMatches = ~automaton_detail::Block{};
+#pragma GCC unroll 8
+		for (int plane = 0; plane < NUM_COUNT_BITS; plane++) {
+			countMatches &= (count >> plane) & 1 ? counts[plane] : ~counts[plane];
+		}
+
+		matches |= countMatches;
+	}
+
+	/**
+	 * Write the next generation of a row, a block at a time. This is always inlined into its callers, so that it gets
+	 * compiled for whatever instruction set each of them targets.
+	 * @param row The index of the row
+	 * @param sources The rows that neighbor it
+	 * @return std::uint64_t Nonzero if any cell in the row changed
+	 */
+	__attribute__((always_inline)) std::uint64_t stepRowBlocks(std::size_t row, const std::vector<RowSource> &sources) {
+		using automaton_detail::Block;
+		using automaton_detail::loadBlock;
+
+		Block changed{};
+		std::size_t rowStart = row * this->rowStride;
+		for (std::size_t word = 1; word <= this->wordsPerRow; word += automaton_detail::BLOCK_WORDS) {
+			BlockCounts counts{};
+			for (const RowSource &source : sources) {
+				Block previous, center, next;
+				loadBlock(previous, source.words + word - 1);
+				loadBlock(center, source.words + word);
+				loadBlock(next, source.words + word + 1);
+				// Each cell's neighbor one to the left is one bit lower, carrying in from the previous word, and
+				// likewise for the right
+				Block left = ((center << 1) | (previous >> (automaton_detail::WORD_BITS - 1))) & source.innerShiftMasks[0];
+				Block right = ((center >> 1) | (next << (automaton_detail::WORD_BITS - 1))) & source.innerShiftMasks[2];
+				center &= source.innerShiftMasks[1];
+
+				// A full adder turns the three neighbors into a two bit count, which is then added into the counts
+				Block lowBit = left ^ center ^ right;
+				Block highBit = (left & center) | (right & (left ^ center));
+				addToCount(counts, 0, lowBit);
+				addToCount(counts, 1, highBit);
+			}
+
+			Block born{};
+			for (int count : this->rule.getBirthCounts()) {
+				addMatches(born, counts, count);
+			}
+
+			Block survived{};
+			for (int count : this->rule.getSurvivalCounts()) {
+				addMatches(survived, counts, count);
+			}
+
+			std::size_t index = rowStart + word;
+			Block current, livable;
+			loadBlock(current, this->cells.data() + index);
+			loadBlock(livable, this->livable.data() + index);
+			Block next = ((current & survived) | (~current & born)) & livable;
+			automaton_detail::storeBlock(this->nextCells.data() + index, next);
+			changed |= next ^ current;
+		}
+
+		std::uint64_t anyChanged = 0;
+		for (int lane = 0; lane < automaton_detail::BLOCK_WORDS; lane++) {
+			anyChanged |= changed[lane];
+		}
+
+		return anyChanged;
+	}
+
+	std::uint64_t stepRowDefault(std::size_t row, const std::vector<RowSource> &sources) {
+		return this->stepRowBlocks(row, sources);
+	}
+
+#if defined(__x86_64__)
+	__attribute__((target("avx2"))) std::uint64_t stepRowAVX2(std::size_t row, const std::vector<RowSource> &sources) {
+		return this->stepRowBlocks(row, sources);
+	}
+#endif
+
+	/**
+	 * Write the next generation of a row, with AVX2 when the machine supports it
+	 * @param row The index of the row
+	 * @param sources The rows that neighbor it
+	 * @return std::uint64_t Nonzero if any cell in the row changed
+	 */
+	std::uint64_t stepRow(std::size_t row, const std::vector<RowSource> &sources) {
+#if defined(__x86_64__)
+		static const bool hasAVX2 = __builtin_cpu_supports("avx2");
+		if (hasAVX2) {
+			return this->stepRowAVX2(row, sources);
+		}
+#endif
+
+		return this->stepRowDefault(row, sources);
+	}
+};
+
+#endif
@@ -0,0 +1,148 @@
+#ifndef COMMON_BENCHMARK_HPP
+#define COMMON_BENCHMARK_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "json.hpp"
+#include "solver.hpp"
+
+/**
+ * The timings of every repetition of a single phase
+ */
+class PhaseSamples {
+ public:
+	PhaseSamples(std::string name) : name(std::move(name)) {
+	}
+
+	const std::string &getName() const {
+		return this->name;
+	}
+
+	void addSample(double nanoseconds) {
+		this->samples.push_back(nanoseconds);
+	}
+
+	std::size_t getNumSamples() const {
+		return this->samples.size();
+	}
+
+	/**
+	 * Get a percentile of the samples, using the nearest-rank method
+	 * @param percentile The percentile to get, in (0, 100]
+	 * @return double The percentile, in nanoseconds
+	 */
+	double getPercentile(double percentile) const {
+		if (this->samples.empty()) {
+			throw std::logic_error("No samples to get a percentile of");
+		}
+
+		std::vector<double> sorted(this->samples);
+		std::sort(sorted.begin(), sorted.end());
+		std::size_t rank = std::ceil(percentile / 100 * sorted.size());
+
+		return sorted.at(std::max<std::size_t>(rank, 1) - 1);
+	}
+
+ private:
+	std::string name;
+	std::vector<double> samples;
+};
+
+/**
+ * A PhaseRunner that runs each phase a number of times to warm up, and then a number of times that are timed
+ */
+class BenchmarkRunner : public PhaseRunner {
+ public:
+	BenchmarkRunner(int numWarmups, int numRepetitions) : numWarmups(numWarmups), numRepetitions(numRepetitions) {
+		if (numRepetitions < 1) {
+			throw std::invalid_argument("Must run at least one repetition");
+		}
+	}
+
+	const std::vector<PhaseSamples> &getPhaseSamples() const {
+		return this->phaseSamples;
+	}
+
+	const std::vector<std::pair<std::string, std::string>> &getAnswers() const {
+		return this->answers;
+	}
+
+ protected:
+	void runPhase(const std::string &name, const std::function<void()> &body) override {
+		for (int i = 0; i < this->numWarmups; i++) {
+			body();
+		}
+
+		PhaseSamples samples(name);
+		for (int i = 0; i < this->numRepetitions; i++) {
+			auto start = std::chrono::steady_clock::now();
+			body();
+			std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+			samples.addSample(elapsed.count());
+		}
+
+		this->phaseSamples.push_back(std::move(samples));
+	}
+
+	void recordAnswer(const std::string &name, const std::string &answer) override {
+		this->answers.emplace_back(name, answer);
+	}
+
+ private:
+	int numWarmups;
+	int numRepetitions;
+	std::vector<PhaseSamples> phaseSamples;
+	std::vector<std::pair<std::string, std::string>> answers;
+};
+
+/**
+ * Benchmark a solver against a single input, writing the results as a JSON object
+ * @param os The stream to write to
+ * @param solverName The name of the solver
+ * @param solve The solver
+ * @param filename The input file
+ * @param numWarmups The number of untimed runs of each phase
+ * @param numRepetitions The number of timed runs of each phase
+ */
+inline void benchmarkSolver(
+	std::ostream &os,
+	const std::string &solverName,
+	SolveFunction solve,
+	const std::string &filename,
+	int numWarmups,
+	int numRepetitions) {
+	BenchmarkRunner runner(numWarmups, numRepetitions);
+	MappedInput input = runner.phase("read", [&filename]() { return MappedInput(filename); });
+	solve(runner, input);
+
+	double inputBytes = input.getContents().size();
+	os << "{\"solver\": " << toJSONString(solverName) << ", \"input\": " << toJSONString(filename)
+	   << ", \"input_bytes\": " << input.getContents().size() << ", \"phases\": [";
+	const std::vector<PhaseSamples> &phaseSamples = runner.getPhaseSamples();
+	for (auto it = phaseSamples.cbegin(); it != phaseSamples.cend(); ++it) {
+		double median = it->getPercentile(50);
+		os << (it == phaseSamples.cbegin() ? "" : ", ") << "{\"name\": " << toJSONString(it->getName())
+		   << ", \"repetitions\": " << it->getNumSamples() << ", \"median_ns\": " << median
+		   << ", \"p99_ns\": " << it->getPercentile(99)
+		   << ", \"bytes_per_second\": " << (median > 0 ? inputBytes / (median / 1e9) : 0) << "}";
+	}
+
+	os << "], \"answers\": [";
+	const std::vector<std::pair<std::string, std::string>> &answers = runner.getAnswers();
+	for (auto it = answers.cbegin(); it != answers.cend(); ++it) {
+		os << (it == answers.cbegin() ? "" : ", ") << "{\"name\": " << toJSONString(it->first)
+		   << ", \"value\": " << toJSONString(it->second) << "}";
+	}
+
+	os << "]}";
+}
+
+#endif
@@ -0,0 +1,219 @@
+#ifndef COMMON_CACHE_HPP
+#define COMMON_CACHE_HPP
+
+#include <fcntl.h>
+#include <link.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "hash.hpp"
+#include "input.hpp"
+
+namespace cache_detail {
+/**
+ * Find the GNU build ID of the running executable, which the linker derives from everything that went into it
+ * @return std::string The build ID, in hex, or an empty string if the executable doesn't have one
+ */
+inline std::string findBuildID() {
+	std::string buildID;
+	dl_iterate_phdr(
+		[](dl_phdr_info *info, std::size_t, void *data) {
+			std::string &buildID = *static_cast<std::string *>(data);
+			for (int i = 0; i < info->dlpi_phnum; i++) {
+				const ElfW(Phdr) &header = info->dlpi_phdr[i];
+				if (header.p_type != PT_NOTE) {
+					continue;
+				}
+
+				const char *notes = reinterpret_cast<const char *>(info->dlpi_addr + header.p_vaddr);
+				std::size_t cursor = 0;
+				// Each note's name and description are padded out to four bytes
+				while (cursor + sizeof(ElfW(Nhdr)) <= header.p_memsz) {
+					const ElfW(Nhdr) *note = reinterpret_cast<const ElfW(Nhdr) *>(notes + cursor);
+					const char *name = notes + cursor + sizeof(ElfW(Nhdr));
+					const unsigned char *description =
+						reinterpret_cast<const unsigned char *>(name + ((note->n_namesz + 3) & ~3U));
+					if (note->n_type == NT_GNU_BUILD_ID && note->n_namesz == 4 && std::memcmp(name, "GNU", 4) == 0) {
+						for (unsigned int j = 0; j < note->n_descsz; j++) {
+							char hexByte[3];
+							std::snprintf(hexByte, sizeof(hexByte), "%02x", description[j]);
+							buildID += hexByte;
+						}
+
+						return 1;
+					}
+
+					cursor += sizeof(ElfW(Nhdr)) + ((note->n_namesz + 3) & ~3U) + ((note->n_descsz + 3) & ~3U);
+				}
+			}
+
+			// The executable always comes first, so there is no need to look at any of the libraries
+			return 1;
+		},
+		&buildID);
+
+	return buildID;
+}
+
+/**
+ * Identify the build of the running executable, so that cached answers never outlive the code that produced them
+ * @return std::string The build ID, or if there isn't one, the size and modification time of the executable
+ * @throws std::runtime_error if neither can be found
+ */
+inline std::string findBuildVersion() {
+	std::string buildID = findBuildID();
+	if (!buildID.empty()) {
+		return buildID;
+	}
+
+	struct stat executableStat;
+	if (stat("/proc/self/exe", &executableStat) == -1) {
+		throw std::runtime_error(std::string("Could not identify the executable: ") + std::strerror(errno));
+	}
+
+	return std::to_string(executableStat.st_size) + "-" + std::to_string(executableStat.st_mtim.tv_sec) + "." +
+		   std::to_string(executableStat.st_mtim.tv_nsec);
+}
+}  // namespace cache_detail
+
+/**
+ * An on-disk cache of the answers to inputs, so that an input that has been solved before is answered without being
+ * parsed, let alone solved. Each entry is a file of its own, named for a hash of everything the answers depend on: the
+ * bytes of the input, the name of the solver, and the build of the executable (so that changing a solver never reuses
+ * its old answers). The first line of an entry repeats all but the input itself, and the answers follow, one per line.
+ * Entries are read by mapping them, and written by mapping a temporary file that then atomically replaces the entry,
+ * so any number of runs can share a cache, and none of them ever sees an entry half written.
+ */
+class ResultCache {
+ public:
+	/**
+	 * @param directory The directory to keep the entries in, which is created if it doesn't exist
+	 * @param solverName The name of the solver whose answers are cached (e.g. "day15")
+	 * @throws std::filesystem::filesystem_error if the directory can't be created
+	 * @throws std::runtime_error if the build of the executable can't be identified
+	 */
+	ResultCache(const std::string &directory, const std::string &solverName)
+		: directory(directory), solverName(solverName), buildVersion(cache_detail::findBuildVersion()) {
+		std::filesystem::create_directories(this->directory);
+		this->seed = hashBytes(this->solverName + '\0' + this->buildVersion);
+	}
+
+	/**
+	 * Look up the answers to an input
+	 * @param input The contents of the input
+	 * @return std::optional<std::vector<std::string>> The answers, in the order they were found, if they are cached
+	 */
+	std::optional<std::vector<std::string>> lookup(std::string_view input) const {
+		std::optional<MappedInput> entry;
+		try {
+			entry.emplace(this->findEntryPath(input).string());
+		} catch (const std::runtime_error &) {
+			// Most likely, there's no entry yet
+			return std::nullopt;
+		}
+
+		std::vector<std::string_view> lines = entry->getLines();
+		if (lines.empty() || lines.front() != this->makeHeader(input, lines.size() - 1)) {
+			return std::nullopt;
+		}
+
+		return std::vector<std::string>(lines.cbegin() + 1, lines.cend());
+	}
+
+	/**
+	 * Store the answers to an input, replacing any that are already stored
+	 * @param input The contents of the input
+	 * @param answers The answers, in the order they were found
+	 * @throws std::runtime_error if an answer has a newline in it, or if the entry can't be written
+	 */
+	void store(std::string_view input, const std::vector<std::string> &answers) const {
+		std::string contents = this->makeHeader(input, answers.size()) + '\n';
+		for (const std::string &answer : answers) {
+			if (answer.find('\n') != std::string::npos) {
+				throw std::runtime_error("Answers with newlines can't be cached");
+			}
+
+			contents += answer + '\n';
+		}
+
+		std::filesystem::path entryPath = this->findEntryPath(input);
+		std::string temporaryPath = entryPath.string() + ".XXXXXX";
+		int fd = mkstemp(temporaryPath.data());
+		if (fd == -1) {
+			throw std::runtime_error("Could not create " + temporaryPath + ": " + std::strerror(errno));
+		}
+
+		void *mapping = MAP_FAILED;
+		if (ftruncate(fd, contents.size()) == 0) {
+			mapping = mmap(nullptr, contents.size(), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		}
+		if (mapping == MAP_FAILED) {
+			int error = errno;
+			close(fd);
+			unlink(temporaryPath.c_str());
+			throw std::runtime_error("Could not map " + temporaryPath + ": " + std::strerror(error));
+		}
+
+		std::memcpy(mapping, contents.data(), contents.size());
+		munmap(mapping, contents.size());
+		close(fd);
+
+		// Readers have either the old entry or the new one mapped, never a mix of the two
+		if (rename(temporaryPath.c_str(), entryPath.c_str()) == -1) {
+			int error = errno;
+			unlink(temporaryPath.c_str());
+			throw std::runtime_error("Could not replace " + entryPath.string() + ": " + std::strerror(error));
+		}
+	}
+
+	const std::filesystem::path &getDirectory() const {
+		return this->directory;
+	}
+
+	const std::string &getSolverName() const {
+		return this->solverName;
+	}
+
+	const std::string &getBuildVersion() const {
+		return this->buildVersion;
+	}
+
+ private:
+	std::filesystem::path directory;
+	std::string solverName;
+	std::string buildVersion;
+	// Mixes the solver and build into the hash of every input
+	std::uint64_t seed;
+
+	std::filesystem::path findEntryPath(std::string_view input) const {
+		char entryName[17];
+		unsigned long long hash = hashBytes(input, this->seed);
+		std::snprintf(entryName, sizeof(entryName), "%016llx", hash);
+
+		return this->directory / entryName;
+	}
+
+	/**
+	 * Make the first line of an entry, which must match exactly for the entry to be used
+	 * @param input The contents of the input
+	 * @param numAnswers The number of answers in the entry
+	 * @return std::string The header, without a newline
+	 */
+	std::string makeHeader(std::string_view input, std::size_t numAnswers) const {
+		return this->solverName + '\t' + this->buildVersion + '\t' + std::to_string(input.size()) + '\t' +
+			   std::to_string(numAnswers);
+	}
+};
+
+#endif
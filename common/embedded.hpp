@@ -0,0 +1,129 @@
+#ifndef COMMON_EMBEDDED_HPP
+#define COMMON_EMBEDDED_HPP
+
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+/*
+ * Helpers for solving an input that is embedded in the binary, entirely at compile time. An embedded build defines
+ * AOC_EMBEDDED_INPUT as the path of a generated header, which holds the input as
+ * `constexpr std::string_view EMBEDDED_INPUT`. None of the other input helpers can run at compile time (they map files,
+ * allocate, or use intrinsics), so these are constexpr stand-ins for the few that the embedded days need. Anything they
+ * throw while being evaluated at compile time is a compile error.
+ */
+
+/**
+ * Call a function on each line of some text, as MappedInput::splitLines would split them
+ * @param text The text
+ * @param func Called with each line, without its newline
+ */
+template <typename Func>
+constexpr void forEachLineConstexpr(std::string_view text, Func &&func) {
+	std::string_view::size_type cursor = 0;
+	while (cursor < text.size()) {
+		auto newline = text.find('\n', cursor);
+		if (newline == std::string_view::npos) {
+			newline = text.size();
+		}
+
+		func(text.substr(cursor, newline - cursor));
+		cursor = newline + 1;
+	}
+}
+
+/**
+ * Count the lines of some text, as forEachLineConstexpr would split them
+ * @param text The text
+ * @return std::size_t The number of lines
+ */
+constexpr std::size_t countLinesConstexpr(std::string_view text) {
+	std::size_t numLines = 0;
+	forEachLineConstexpr(text, [&numLines](std::string_view) { numLines++; });
+
+	return numLines;
+}
+
+/**
+ * Split the first lines off of some text, as MappedInput::splitLines would
+ * @tparam N The number of lines to split off
+ * @param text The text
+ * @return std::array<std::string_view, N> The first N lines of the text, without newlines
+ * @throws std::invalid_argument if the text has fewer than N lines
+ */
+template <std::size_t N>
+constexpr std::array<std::string_view, N> splitLinesConstexpr(std::string_view text) {
+	std::array<std::string_view, N> lines{};
+	std::string_view::size_type cursor = 0;
+	for (std::size_t i = 0; i < N; i++) {
+		if (cursor >= text.size()) {
+			throw std::invalid_argument("Too few lines");
+		}
+
+		auto newline = text.find('\n', cursor);
+		if (newline == std::string_view::npos) {
+			newline = text.size();
+		}
+
+		lines[i] = text.substr(cursor, newline - cursor);
+		cursor = newline + 1;
+	}
+
+	return lines;
+}
+
+/**
+ * Parse a single integer, which must be nothing but an optional minus sign and its digits, as parseInteger would
+ * @tparam T The integer type to parse into
+ * @param token The integer to parse
+ * @return T The integer
+ * @throws std::invalid_argument if the token isn't an integer
+ * @throws std::out_of_range if the integer doesn't fit in a T
+ */
+template <typename T>
+constexpr T parseIntegerConstexpr(std::string_view token) {
+	static_assert(std::is_signed_v<T>, "Only signed integers can be parsed at compile time");
+	bool negative = !token.empty() && token.front() == '-';
+	std::string_view digits = negative ? token.substr(1) : token;
+	if (digits.empty()) {
+		throw std::invalid_argument("Invalid integer");
+	}
+
+	// Accumulating towards the negative end covers the most negative value as well
+	T value = 0;
+	for (char digit : digits) {
+		if (digit < '0' || digit > '9') {
+			throw std::invalid_argument("Invalid integer");
+		} else if (value < (std::numeric_limits<T>::min() + (digit - '0')) / 10) {
+			throw std::out_of_range("Integer out of range");
+		}
+
+		value = value * 10 - (digit - '0');
+	}
+
+	if (!negative && value == std::numeric_limits<T>::min()) {
+		throw std::out_of_range("Integer out of range");
+	}
+
+	return negative ? value : -value;
+}
+
+/**
+ * Print the answers that were found at compile time, just as a normal run prints its answers
+ * @param answers The answers, in order
+ * @return int The exit code
+ */
+template <typename T, std::size_t N>
+int printEmbeddedAnswers(const std::array<T, N> &answers) {
+	for (const T &answer : answers) {
+		std::cout << answer << std::endl;
+	}
+
+	return 0;
+}
+
+#endif
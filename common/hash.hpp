@@ -0,0 +1,107 @@
+#ifndef COMMON_HASH_HPP
+#define COMMON_HASH_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace hash_detail {
+// The bytes are read a stripe at a time, one word into each of the lanes, and scrambled once every block of stripes
+constexpr std::size_t NUM_LANES = 8;
+constexpr std::size_t STRIPE_SIZE = NUM_LANES * sizeof(std::uint64_t);
+constexpr std::size_t STRIPES_PER_BLOCK = 16;
+// Odd constants with well mixed bits (the primes from xxHash)
+constexpr std::uint64_t PRIME_1 = 0x9E3779B185EBCA87;
+constexpr std::uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4F;
+constexpr std::uint32_t PRIME_32 = 0x9E3779B1;
+constexpr std::uint64_t LANE_KEYS[NUM_LANES] = {
+	0x165667B19E3779F9,
+	0x85EBCA77C2B2AE63,
+	0x27D4EB2F165667C5,
+	0xBE4BA423396CFEB8,
+	0x1CAD21F72C81017C,
+	0xDB979083E96DD4DE,
+	0x1F67B3B7A4A44072,
+	0x78E5C0CC4EE679CB};
+
+/**
+ * Multiply two words into 128 bits, and fold the halves of the product together. Every bit of the result depends on
+ * nearly every bit of both words.
+ */
+__attribute__((always_inline)) inline std::uint64_t multiplyFold(std::uint64_t a, std::uint64_t b) {
+	unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+	return static_cast<std::uint64_t>(product) ^ static_cast<std::uint64_t>(product >> 64);
+}
+
+/**
+ * Add one stripe into the lanes. Each lane multiplies the two halves of its keyed word together, and since no lane's
+ * next multiply waits on its last one, the multiplies of consecutive stripes overlap.
+ * @param lanes The state of each lane
+ * @param stripe The start of the stripe, which must have STRIPE_SIZE bytes
+ * @param stripeKey Mixed into the key of every lane, so that the same stripe adds something different at each
+ * position in a block
+ */
+__attribute__((always_inline)) inline void accumulateStripe(
+	std::uint64_t *lanes, const char *stripe, std::uint64_t stripeKey) {
+	std::uint64_t words[NUM_LANES];
+	std::memcpy(words, stripe, sizeof(words));
+#pragma GCC unroll 8
+	for (std::size_t lane = 0; lane < NUM_LANES; lane++) {
+		std::uint64_t keyed = words[lane] ^ (LANE_KEYS[lane] + stripeKey);
+		// Each word is also added to the neighbouring lane unchanged, so that none of it is lost to the multiply
+		lanes[lane ^ 1] += words[lane];
+		lanes[lane] += (keyed & 0xFFFFFFFF) * (keyed >> 32);
+	}
+}
+
+/**
+ * Spread the bits of every lane after each block, so that what the block added can't be cancelled out by a later one
+ */
+__attribute__((always_inline)) inline void scrambleLanes(std::uint64_t *lanes) {
+	for (std::size_t lane = 0; lane < NUM_LANES; lane++) {
+		lanes[lane] = ((lanes[lane] ^ (lanes[lane] >> 47)) ^ LANE_KEYS[lane]) * PRIME_32;
+	}
+}
+}  // namespace hash_detail
+
+/**
+ * Hash some bytes into 64 bits, in the style of xxh3: the bytes are read a word at a time into eight lanes that don't
+ * depend on each other, so a hash runs at several gigabytes per second. This is only meant to tell inputs apart, and
+ * is in no way cryptographic.
+ * @param bytes The bytes to hash
+ * @param seed A seed to mix into the hash, so that the same bytes hash differently for different purposes
+ * @return std::uint64_t The hash
+ */
+inline std::uint64_t hashBytes(std::string_view bytes, std::uint64_t seed = 0) {
+	using namespace hash_detail;
+	std::uint64_t lanes[NUM_LANES];
+	for (std::size_t lane = 0; lane < NUM_LANES; lane++) {
+		lanes[lane] = seed ^ LANE_KEYS[lane];
+	}
+
+	std::size_t cursor = 0;
+	std::size_t stripeInBlock = 0;
+	for (; cursor + STRIPE_SIZE <= bytes.size(); cursor += STRIPE_SIZE) {
+		accumulateStripe(lanes, bytes.data() + cursor, stripeInBlock * PRIME_1);
+		if (++stripeInBlock == STRIPES_PER_BLOCK) {
+			scrambleLanes(lanes);
+			stripeInBlock = 0;
+		}
+	}
+
+	// The last partial stripe is padded with zeroes. Which bytes were padding is told apart by mixing in the size.
+	if (cursor < bytes.size()) {
+		char lastStripe[STRIPE_SIZE] = {};
+		std::memcpy(lastStripe, bytes.data() + cursor, bytes.size() - cursor);
+		accumulateStripe(lanes, lastStripe, stripeInBlock * PRIME_1);
+	}
+
+	std::uint64_t hash = bytes.size() * PRIME_2;
+	for (std::size_t lane = 0; lane < NUM_LANES; lane += 2) {
+		hash += multiplyFold(lanes[lane] ^ LANE_KEYS[lane], lanes[lane + 1] ^ LANE_KEYS[lane + 1]);
+	}
+
+	return multiplyFold(hash ^ (hash >> 37), PRIME_1 ^ seed);
+}
+
+#endif
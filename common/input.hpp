@@ -0,0 +1,152 @@
+#ifndef COMMON_INPUT_HPP
+#define COMMON_INPUT_HPP
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * A puzzle input, memory mapped from a file. Every view handed out by this class points directly into the mapping, so
+ * none of them may outlive the MappedInput they came from.
+ */
+class MappedInput {
+ public:
+	/**
+	 * Map the given file into memory
+	 * @param filename The file to map
+	 * @throws std::runtime_error if the file cannot be opened or mapped
+	 */
+	explicit MappedInput(const std::string &filename) {
+		int fd = open(filename.c_str(), O_RDONLY);
+		if (fd == -1) {
+			throw std::runtime_error("Could not open " + filename + ": " + std::strerror(errno));
+		}
+
+		struct stat fileStat;
+		if (fstat(fd, &fileStat) == -1) {
+			int error = errno;
+			close(fd);
+			throw std::runtime_error("Could not stat " + filename + ": " + std::strerror(error));
+		}
+
+		this->length = fileStat.st_size;
+		// mmap will refuse to map an empty file, but an empty file is a perfectly good (empty) input
+		if (this->length > 0) {
+			void *mapping = mmap(nullptr, this->length, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (mapping == MAP_FAILED) {
+				int error = errno;
+				close(fd);
+				throw std::runtime_error("Could not map " + filename + ": " + std::strerror(error));
+			}
+
+			// We only ever walk the input front to back, so let the kernel read ahead aggressively
+			madvise(mapping, this->length, MADV_SEQUENTIAL);
+			this->data = static_cast<const char *>(mapping);
+		}
+
+		// The mapping holds its own reference to the file
+		close(fd);
+	}
+
+	MappedInput(const MappedInput &) = delete;
+	MappedInput &operator=(const MappedInput &) = delete;
+
+	MappedInput(MappedInput &&other) noexcept : data(other.data), length(other.length) {
+		other.data = nullptr;
+		other.length = 0;
+	}
+
+	MappedInput &operator=(MappedInput &&other) noexcept {
+		std::swap(this->data, other.data);
+		std::swap(this->length, other.length);
+		return *this;
+	}
+
+	~MappedInput() {
+		if (this->data != nullptr) {
+			munmap(const_cast<char *>(this->data), this->length);
+		}
+	}
+
+	/**
+	 * @return std::string_view The raw contents of the input
+	 */
+	std::string_view getContents() const {
+		return std::string_view(this->data, this->length);
+	}
+
+	/**
+	 * Split the input into lines. Like std::getline, a trailing newline does not produce an extra empty line.
+	 * @return std::vector<std::string_view> Every line of the input, without newlines
+	 */
+	std::vector<std::string_view> getLines() const {
+		return splitLines(this->getContents());
+	}
+
+	/**
+	 * Count the lines of the input, as getLines would split them, without splitting them
+	 * @return std::size_t The number of lines in the input
+	 */
+	std::size_t getNumLines() const {
+		std::string_view contents = this->getContents();
+		std::size_t numLines = std::count(contents.cbegin(), contents.cend(), '\n');
+		// The last line only lacks a newline if the file doesn't end in one
+		return contents.empty() || contents.back() == '\n' ? numLines : numLines + 1;
+	}
+
+	/**
+	 * Split the input into blocks of lines, which are separated by blank lines
+	 * @return std::vector<std::vector<std::string_view>> Every block in the input, each as its lines
+	 */
+	std::vector<std::vector<std::string_view>> getBlocks() const {
+		std::vector<std::vector<std::string_view>> blocks(1);
+		for (std::string_view line : this->getLines()) {
+			if (line.empty()) {
+				blocks.emplace_back();
+				continue;
+			}
+
+			blocks.back().push_back(line);
+		}
+
+		return blocks;
+	}
+
+	/**
+	 * Split the given text into lines. Like std::getline, a trailing newline does not produce an extra empty line.
+	 * @param text The text to split
+	 * @return std::vector<std::string_view> Every line of the text, without newlines
+	 */
+	static std::vector<std::string_view> splitLines(std::string_view text) {
+		std::vector<std::string_view> lines;
+		// Counting up front is far cheaper than letting the vector regrow on very large inputs
+		lines.reserve(std::count(text.cbegin(), text.cend(), '\n') + 1);
+		std::string_view::size_type cursor = 0;
+		while (cursor < text.size()) {
+			auto newline = text.find('\n', cursor);
+			if (newline == std::string_view::npos) {
+				newline = text.size();
+			}
+
+			lines.push_back(text.substr(cursor, newline - cursor));
+			cursor = newline + 1;
+		}
+
+		return lines;
+	}
+
+ private:
+	const char *data = nullptr;
+	std::size_t length = 0;
+};
+
+#endif
@@ -0,0 +1,289 @@
+#ifndef COMMON_INTEGERS_HPP
+#define COMMON_INTEGERS_HPP
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace integers_detail {
+// The number of bytes that are checked for separators at once
+constexpr std::size_t BLOCK_SIZE = 32;
+
+/**
+ * Convert eight ASCII digits to their value, all at once, by combining adjacent pairs of digits, then pairs of those,
+ * and so on
+ * @param chars The digits, most significant first
+ * @param numIgnored The number of leading bytes to ignore (i.e. treat as zeroes), which must be less than eight
+ * @return std::uint64_t The value of the digits
+ */
+inline std::uint64_t parseEightDigits(const char *chars, int numIgnored = 0) {
+	std::uint64_t value;
+	std::memcpy(&value, chars, sizeof(value));
+	// This relies on the first digit being in the lowest byte, as it is on every little-endian machine
+	value &= ~std::uint64_t(0) << (numIgnored * 8);
+	value = ((value & 0x0F0F0F0F0F0F0F0F) * 2561) >> 8;
+	value = ((value & 0x00FF00FF00FF00FF) * 6553601) >> 16;
+
+	return ((value & 0x0000FFFF0000FFFF) * 42949672960001) >> 32;
+}
+
+/**
+ * Parse a single integer, which must be nothing but an optional minus sign and its digits
+ * @tparam T The integer type to parse into
+ * @param token The integer to parse
+ * @return T The integer
+ * @throws std::invalid_argument if the token isn't an integer
+ * @throws std::out_of_range if the integer doesn't fit in a T
+ */
+template <typename T>
+T parseToken(std::string_view token) {
+	bool negative = !token.empty() && token.front() == '-';
+	if (negative && !std::is_signed_v<T>) {
+		throw std::out_of_range("Negative integer can't be unsigned: " + std::string(token));
+	}
+
+	std::string_view digits = negative ? token.substr(1) : token;
+	// Anything longer than this could overflow the accumulator itself, so it is known to be out of range up front
+	if (digits.empty()) {
+		throw std::invalid_argument("Invalid integer: " + std::string(token));
+	} else if (digits.size() > std::numeric_limits<std::uint64_t>::digits10) {
+		throw std::out_of_range("Integer out of range: " + std::string(token));
+	}
+
+	std::uint64_t magnitude = 0;
+	std::size_t cursor = 0;
+	bool allDigits = true;
+	for (; cursor + 8 <= digits.size(); cursor += 8) {
+		// Only the digits themselves have their high nibble set to 3 and a low nibble of at most 9
+		std::uint64_t chunk;
+		std::memcpy(&chunk, digits.data() + cursor, sizeof(chunk));
+		allDigits = allDigits && (chunk & 0xF0F0F0F0F0F0F0F0) == 0x3030303030303030 &&
+					((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) == 0x3030303030303030;
+		magnitude = magnitude * 100000000 + parseEightDigits(digits.data() + cursor);
+	}
+	for (; cursor < digits.size(); cursor++) {
+		unsigned char digit = digits[cursor] - '0';
+		allDigits = allDigits && digit <= 9;
+		magnitude = magnitude * 10 + digit;
+	}
+
+	if (!allDigits) {
+		throw std::invalid_argument("Invalid integer: " + std::string(token));
+	}
+
+	// The most negative value has one more in its magnitude than the most positive
+	std::uint64_t maxMagnitude = static_cast<std::uint64_t>(std::numeric_limits<T>::max()) + (negative ? 1 : 0);
+	if (magnitude > maxMagnitude) {
+		throw std::out_of_range("Integer out of range: " + std::string(token));
+	}
+
+	return negative ? static_cast<T>(0 - magnitude) : static_cast<T>(magnitude);
+}
+
+/**
+ * Parse a token that is already known to hold nothing but digits and minus signs
+ * @tparam T The integer type to parse into
+ * @param text The text the token is in
+ * @param tokenStart The index of the token's first character
+ * @param tokenEnd The index one past the token's last character
+ * @return T The integer
+ * @throws std::invalid_argument if the token isn't an integer
+ * @throws std::out_of_range if the integer doesn't fit in a T
+ */
+template <typename T>
+__attribute__((always_inline)) inline T parseDigitsToken(
+	std::string_view text, std::size_t tokenStart, std::size_t tokenEnd) {
+	std::size_t length = tokenEnd - tokenStart;
+	// Most integers are short, and as long as there are eight bytes that end with them, they can be converted at once,
+	// with the bytes before the token masked off to act as leading zeroes
+	if (length > 0 && length <= 8 && tokenEnd >= 8) {
+		const char *chars = text.data() + tokenEnd - 8;
+		std::uint64_t chunk;
+		std::memcpy(&chunk, chars, sizeof(chunk));
+		// Of the digits and minus signs, only the digits have this bit set
+		std::uint64_t digitBits = 0x1010101010101010 & (~std::uint64_t(0) << ((8 - length) * 8));
+		std::uint64_t value = parseEightDigits(chars, 8 - length);
+		if ((chunk & digitBits) == digitBits && value <= static_cast<std::uint64_t>(std::numeric_limits<T>::max())) {
+			return static_cast<T>(value);
+		}
+	}
+
+	return parseToken<T>(text.substr(tokenStart, length));
+}
+
+/**
+ * Find every byte of a block that can't be part of an integer
+ * @param block The start of the block
+ * @param size The size of the block, which must be at most BLOCK_SIZE
+ * @return std::uint32_t A mask with the bit of each of those bytes set
+ */
+inline std::uint32_t findSeparatorsScalar(const char *block, std::size_t size) {
+	std::uint32_t separators = 0;
+	for (std::size_t i = 0; i < size; i++) {
+		bool isDigit = static_cast<unsigned char>(block[i] - '0') <= 9;
+		separators |= static_cast<std::uint32_t>(!isDigit && block[i] != '-') << i;
+	}
+
+	return separators;
+}
+
+#if defined(__x86_64__)
+/**
+ * Find every byte of a full block that can't be part of an integer, with AVX2
+ * @param block The start of the block, which must have BLOCK_SIZE bytes
+ * @return std::uint32_t A mask with the bit of each of those bytes set
+ */
+__attribute__((target("avx2,bmi,popcnt"))) inline std::uint32_t findSeparatorsAVX2(const char *block) {
+	__m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block));
+	// Shifted down by '0', the digits are exactly the bytes that are at most 9 as unsigned bytes
+	__m256i offsets = _mm256_sub_epi8(bytes, _mm256_set1_epi8('0'));
+	__m256i isDigit = _mm256_cmpeq_epi8(_mm256_min_epu8(offsets, _mm256_set1_epi8(9)), offsets);
+	__m256i isMinus = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('-'));
+
+	return ~static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(isDigit, isMinus)));
+}
+#endif
+
+/**
+ * @param c A character
+ * @return bool Whether the character is whitespace that may pad an integer, such as the '\r' of a CRLF line ending
+ */
+inline bool isPadding(char c) {
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+/**
+ * Parse the integers in some text, finding the separators between them a block at a time. This is always inlined into
+ * its callers, so that it gets compiled for whatever instruction set each of them targets.
+ * @tparam T The integer type to parse into
+ * @tparam findFullBlockSeparators Finds the separators in a block of exactly BLOCK_SIZE bytes
+ * @param text The text to parse
+ * @return std::vector<T> The integers
+ */
+template <typename T, std::uint32_t (*findFullBlockSeparators)(const char *)>
+__attribute__((always_inline)) inline std::vector<T> parseIntegersWith(std::string_view text) {
+	// Counting the separators first is far cheaper than letting the vector regrow, which would otherwise dominate
+	std::size_t numSeparators = 0;
+	for (std::size_t blockStart = 0; blockStart < text.size(); blockStart += BLOCK_SIZE) {
+		std::size_t blockSize = std::min(BLOCK_SIZE, text.size() - blockStart);
+		numSeparators += __builtin_popcount(
+			blockSize == BLOCK_SIZE ? findFullBlockSeparators(text.data() + blockStart)
+									: findSeparatorsScalar(text.data() + blockStart, blockSize));
+	}
+
+	// Padding is rare, so a token is only trimmed (and checked for padding inside it) if it had any after its start
+	auto parsePaddedToken = [text](std::size_t tokenStart, std::size_t tokenEnd, bool padded) {
+		if (!padded) {
+			return parseDigitsToken<T>(text, tokenStart, tokenEnd);
+		}
+
+		while (tokenEnd > tokenStart && isPadding(text[tokenEnd - 1])) {
+			tokenEnd--;
+		}
+
+		return parseToken<T>(text.substr(tokenStart, tokenEnd - tokenStart));
+	};
+
+	std::vector<T> integers;
+	integers.reserve(numSeparators + 1);
+	std::size_t tokenStart = 0;
+	bool padded = false;
+	for (std::size_t blockStart = 0; blockStart < text.size(); blockStart += BLOCK_SIZE) {
+		std::size_t blockSize = std::min(BLOCK_SIZE, text.size() - blockStart);
+		std::uint32_t separators = blockSize == BLOCK_SIZE
+									   ? findFullBlockSeparators(text.data() + blockStart)
+									   : findSeparatorsScalar(text.data() + blockStart, blockSize);
+		while (separators != 0) {
+			std::size_t separatorPos = blockStart + __builtin_ctz(separators);
+			separators &= separators - 1;
+			char separator = text[separatorPos];
+			if (isPadding(separator)) {
+				// Padding before a token is skipped outright, and padding after it is trimmed once the token ends
+				if (separatorPos == tokenStart) {
+					tokenStart++;
+				} else {
+					padded = true;
+				}
+
+				continue;
+			} else if (separator != '\n' && separator != ',') {
+				throw std::invalid_argument("Invalid character in integers: " + std::string(1, separator));
+			}
+
+			integers.push_back(parsePaddedToken(tokenStart, separatorPos, padded));
+			tokenStart = separatorPos + 1;
+			padded = false;
+		}
+	}
+
+	// Like a trailing newline, which doesn't make an extra empty line, a trailing separator doesn't make an empty integer
+	if (tokenStart < text.size()) {
+		integers.push_back(parsePaddedToken(tokenStart, text.size(), padded));
+	}
+
+	return integers;
+}
+
+inline std::uint32_t findFullBlockSeparatorsScalar(const char *block) {
+	return findSeparatorsScalar(block, BLOCK_SIZE);
+}
+
+template <typename T>
+std::vector<T> parseIntegersScalar(std::string_view text) {
+	return parseIntegersWith<T, findFullBlockSeparatorsScalar>(text);
+}
+
+#if defined(__x86_64__)
+template <typename T>
+__attribute__((target("avx2,bmi,popcnt"))) std::vector<T> parseIntegersAVX2(std::string_view text) {
+	return parseIntegersWith<T, findSeparatorsAVX2>(text);
+}
+#endif
+}  // namespace integers_detail
+
+/**
+ * Parse a single decimal integer
+ * @tparam T The integer type to parse into
+ * @param text The integer, with nothing around it
+ * @return T The integer
+ * @throws std::invalid_argument if the text isn't an integer
+ * @throws std::out_of_range if the integer doesn't fit in a T
+ */
+template <typename T = std::int64_t>
+T parseInteger(std::string_view text) {
+	return integers_detail::parseToken<T>(text);
+}
+
+/**
+ * Parse a list of decimal integers, separated by newlines or commas (e.g. a whole input of one number per line). Spaces,
+ * tabs, and carriage returns around an integer are skipped, so CRLF line endings and lists like "1, 2" parse too. When
+ * the machine supports AVX2, the separators are found 32 bytes at a time.
+ * @tparam T The integer type to parse into
+ * @param text The integers to parse
+ * @return std::vector<T> The integers, in order
+ * @throws std::invalid_argument if anything between the separators (other than that padding) isn't an integer
+ * @throws std::out_of_range if an integer doesn't fit in a T
+ */
+template <typename T = std::int64_t>
+std::vector<T> parseIntegers(std::string_view text) {
+#if defined(__x86_64__)
+	static const bool hasAVX2 = __builtin_cpu_supports("avx2");
+	if (hasAVX2) {
+		return integers_detail::parseIntegersAVX2<T>(text);
+	}
+#endif
+
+	return integers_detail::parseIntegersScalar<T>(text);
+}
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef COMMON_JSON_HPP
+#define COMMON_JSON_HPP
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+/**
+ * Quote and escape a string so it can be written into JSON output
+ * @param str The string to quote
+ * @return std::string The quoted string
+ */
+inline std::string toJSONString(std::string_view str) {
+	std::string res = "\"";
+	for (char c : str) {
+		switch (c) {
+			case '"':
+				res += "\\\"";
+				break;
+			case '\\':
+				res += "\\\\";
+				break;
+			case '\n':
+				res += "\\n";
+				break;
+			case '\t':
+				res += "\\t";
+				break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20) {
+					char escaped[7];
+					std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+					res += escaped;
+				} else {
+					res += c;
+				}
+		}
+	}
+
+	res += '"';
+	return res;
+}
+
+#endif
@@ -0,0 +1,415 @@
+#ifndef COMMON_KSUM_HPP
+#define COMMON_KSUM_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <future>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "thread_pool.hpp"
+
+// The number of chunks per thread that a search on a pool is split into, so that a thread that finishes its chunks
+// early can steal from the others
+constexpr std::size_t KSUM_CHUNKS_PER_THREAD = 16;
+
+/**
+ * Finds sets of entries that add up to a target. The entries are kept sorted, so that a search for k of them can fix
+ * all but the last two in turn, and close in on those from both ends of the entries at once. That takes O(n) time for a
+ * pair, and O(n^(k-1)) for k entries. Each entry can only be used once, so a value that repeats can be used as many
+ * times as it repeats, but no more. A search for the first set of three or more entries can also be split across a
+ * pool of threads.
+ */
+class KSumEngine {
+ public:
+	explicit KSumEngine(std::vector<long> entries) : entries(std::move(entries)) {
+		std::sort(this->entries.begin(), this->entries.end());
+		if (!this->entries.empty()) {
+			// The magnitude of the most negative long doesn't fit in a long, but anything near it is too large anyway
+			long smallest = std::max(this->entries.front(), -std::numeric_limits<long>::max());
+			this->maxMagnitude = std::max(std::labs(smallest), std::labs(this->entries.back()));
+		}
+	}
+
+	/**
+	 * @return const std::vector<long>& The entries, in increasing order
+	 */
+	const std::vector<long> &getEntries() const {
+		return this->entries;
+	}
+
+	/**
+	 * Find the first set of entries that adds up to the target, where sets with smaller entries come first
+	 * @param target The sum to look for
+	 * @param numTerms The number of entries to add up
+	 * @return std::optional<std::vector<long>> The entries, in increasing order, if there are any that add up to the
+	 * target
+	 * @throws std::invalid_argument if numTerms is less than one
+	 * @throws std::overflow_error if the entries are too large to add up in 64 bits
+	 */
+	std::optional<std::vector<long>> findFirst(long target, int numTerms) const {
+		std::optional<std::vector<long>> first;
+		this->forEachSolution(target, numTerms, [&first](const std::vector<long> &solution) {
+			first = solution;
+			return false;
+		});
+
+		return first;
+	}
+
+	/**
+	 * Find the first set of entries that adds up to the target, as findFirst does, but on a pool of threads. The range
+	 * of the first entry is split into chunks, which the pool's workers take (and steal) as they go. Once a set is
+	 * found, every chunk stops as soon as all that's left of it comes after that set's first entry, so that the set
+	 * found is the same one findFirst would find, but without searching past it for long.
+	 * @param target The sum to look for
+	 * @param numTerms The number of entries to add up
+	 * @param pool The pool to search on
+	 * @return std::optional<std::vector<long>> The entries, in increasing order, if there are any that add up to the
+	 * target
+	 * @throws std::invalid_argument if numTerms is less than one
+	 * @throws std::overflow_error if the entries are too large to add up in 64 bits
+	 */
+	std::optional<std::vector<long>> findFirst(long target, int numTerms, ThreadPool &pool) const {
+		if (numTerms < 3) {
+			// A pair is found in a single linear pass, which isn't worth splitting up
+			return this->findFirst(target, numTerms);
+		} else if (!this->isReachable(target, numTerms) || this->entries.size() < static_cast<std::size_t>(numTerms)) {
+			return std::nullopt;
+		}
+
+		std::size_t numFirstEntries = this->entries.size() - numTerms + 1;
+		std::size_t chunkSize =
+			std::max<std::size_t>(numFirstEntries / (pool.getNumThreads() * KSUM_CHUNKS_PER_THREAD), 1);
+		FirstSolution first;
+		std::vector<std::future<void>> chunks;
+		for (std::size_t start = 0; start < numFirstEntries; start += chunkSize) {
+			std::size_t end = std::min(start + chunkSize, numFirstEntries);
+			chunks.push_back(pool.submit([this, target, numTerms, start, end, &first]() {
+				this->searchFirstEntries(start, end, target, numTerms, first);
+			}));
+		}
+
+		// Every chunk refers to this frame, so all of them must finish before an error can leave it
+		std::exception_ptr error;
+		for (std::future<void> &chunk : chunks) {
+			try {
+				pool.await(chunk);
+			} catch (...) {
+				error = error ? error : std::current_exception();
+			}
+		}
+
+		if (error) {
+			std::rethrow_exception(error);
+		}
+
+		return first.solution;
+	}
+
+	/**
+	 * Find every distinct set of entries that adds up to the target. A set that the repeats of a value could make in
+	 * more than one way is only found once.
+	 * @param target The sum to look for
+	 * @param numTerms The number of entries to add up
+	 * @return std::vector<std::vector<long>> The sets of entries, each in increasing order, with sets that have smaller
+	 * entries first
+	 * @throws std::invalid_argument if numTerms is less than one
+	 * @throws std::overflow_error if the entries are too large to add up in 64 bits
+	 */
+	std::vector<std::vector<long>> findAll(long target, int numTerms) const {
+		std::vector<std::vector<long>> solutions;
+		this->forEachSolution(target, numTerms, [&solutions](const std::vector<long> &solution) {
+			solutions.push_back(solution);
+			return true;
+		});
+
+		return solutions;
+	}
+
+	/**
+	 * Call a function on every distinct set of entries that adds up to the target, in the order findAll returns them
+	 * @tparam Func A function that takes the entries (in increasing order), and returns whether to keep searching
+	 * @param target The sum to look for
+	 * @param numTerms The number of entries to add up
+	 * @param visit The function to call on each set
+	 * @throws std::invalid_argument if numTerms is less than one
+	 * @throws std::overflow_error if the entries are too large to add up in 64 bits
+	 */
+	template <typename Func>
+	void forEachSolution(long target, int numTerms, Func &&visit) const {
+		if (!this->isReachable(target, numTerms)) {
+			return;
+		}
+
+		std::vector<long> chosen;
+		chosen.reserve(numTerms);
+		this->search(0, target, numTerms, chosen, visit);
+	}
+
+ private:
+	// The first set found by a search on a pool of threads, which its chunks share
+	struct FirstSolution {
+		// The index of the first entry of the set, which no chunk needs to search past
+		std::atomic<std::size_t> firstIndex = std::numeric_limits<std::size_t>::max();
+		std::mutex mutex;
+		std::optional<std::vector<long>> solution;
+	};
+
+	// Where a target lies, compared to the sums that start with a given entry
+	enum class SumRange {
+		// Even the smallest sum is too large, as is every sum that starts with a later entry
+		TOO_LARGE,
+		// Even the largest sum is too small
+		TOO_SMALL,
+		IN_RANGE,
+	};
+
+	std::vector<long> entries;
+	long maxMagnitude = 0;
+
+	/**
+	 * Compare a target with the sums that start with a given entry, and use only the entries after it
+	 * @param first The index of the first entry of the sums
+	 * @param target The sum to look for
+	 * @param numTerms The number of entries to add up, which must be no more than there are from the first entry on
+	 * @return SumRange Where the target lies
+	 */
+	SumRange compareSums(std::size_t first, long target, int numTerms) const {
+		const std::vector<long> &entries = this->entries;
+		long smallestSum = entries[first];
+		long largestSum = entries[first];
+		for (int j = 1; j < numTerms; j++) {
+			smallestSum += entries[first + j];
+			largestSum += entries[entries.size() - j];
+		}
+
+		if (smallestSum > target) {
+			return SumRange::TOO_LARGE;
+		} else if (largestSum < target) {
+			return SumRange::TOO_SMALL;
+		}
+
+		return SumRange::IN_RANGE;
+	}
+
+	/**
+	 * Check that a search can be run, and whether it could find anything
+	 * @param target The sum to look for
+	 * @param numTerms The number of entries to add up
+	 * @return bool Whether that many entries could possibly add up to the target
+	 * @throws std::invalid_argument if numTerms is less than one
+	 * @throws std::overflow_error if the entries are too large to add up in 64 bits
+	 */
+	bool isReachable(long target, int numTerms) const {
+		if (numTerms < 1) {
+			throw std::invalid_argument("Must add up at least one entry");
+		} else if (this->maxMagnitude > std::numeric_limits<long>::max() / 2 / numTerms) {
+			// Every partial sum, and its difference from a target that it could still reach, then fits in a long
+			throw std::overflow_error("The entries are too large to add up in 64 bits");
+		}
+
+		return target <= static_cast<long>(numTerms) * this->maxMagnitude
+			&& target >= -static_cast<long>(numTerms) * this->maxMagnitude;
+	}
+
+	/**
+	 * Search for sets whose first entry is in a range of the entries, for findFirst on a pool of threads
+	 * @param start The index of the first entry to try first
+	 * @param end The index past the last entry to try first
+	 * @param target The sum to look for
+	 * @param numTerms The number of entries to add up, which must be at least two
+	 * @param first The first set found so far, by any chunk
+	 */
+	void searchFirstEntries(std::size_t start, std::size_t end, long target, int numTerms, FirstSolution &first) const {
+		const std::vector<long> &entries = this->entries;
+		std::vector<long> chosen;
+		chosen.reserve(numTerms);
+		for (std::size_t i = start; i < end && i < first.firstIndex.load(std::memory_order_relaxed); i++) {
+			if (i > 0 && entries[i] == entries[i - 1]) {
+				continue;
+			}
+
+			SumRange range = this->compareSums(i, target, numTerms);
+			if (range == SumRange::TOO_LARGE) {
+				return;
+			} else if (range == SumRange::TOO_SMALL) {
+				continue;
+			}
+
+			std::optional<std::vector<long>> found;
+			auto keepFirst = [&found](const std::vector<long> &solution) {
+				found = solution;
+				return false;
+			};
+			chosen.push_back(entries[i]);
+			this->search(i + 1, target - entries[i], numTerms - 1, chosen, keepFirst);
+			chosen.pop_back();
+			if (found) {
+				std::lock_guard<std::mutex> lock(first.mutex);
+				if (i < first.firstIndex.load()) {
+					first.firstIndex.store(i);
+					first.solution = std::move(found);
+				}
+
+				return;
+			}
+		}
+	}
+
+	/**
+	 * Search the entries from a given index on for sets that add up to the target
+	 * @param start The first entry that may be used
+	 * @param target The sum to look for
+	 * @param numTerms The number of entries to add up
+	 * @param chosen The entries that have already been fixed, which each set found is appended to
+	 * @param visit The function to call on each set
+	 * @return bool Whether to keep searching
+	 */
+	template <typename Func>
+	bool search(std::size_t start, long target, int numTerms, std::vector<long> &chosen, Func &visit) const {
+		const std::vector<long> &entries = this->entries;
+		if (entries.size() - start < static_cast<std::size_t>(numTerms)) {
+			return true;
+		} else if (numTerms == 1) {
+			if (!std::binary_search(entries.cbegin() + start, entries.cend(), target)) {
+				return true;
+			}
+
+			chosen.push_back(target);
+			bool keepSearching = visit(static_cast<const std::vector<long> &>(chosen));
+			chosen.pop_back();
+
+			return keepSearching;
+		} else if (numTerms == 2) {
+			return this->searchPairs(start, target, chosen, visit);
+		}
+
+		for (std::size_t i = start; i + numTerms <= entries.size(); i++) {
+			// A repeat of the entry before it can only find the sets that the entry before it already found
+			if (i > start && entries[i] == entries[i - 1]) {
+				continue;
+			}
+
+			SumRange range = this->compareSums(i, target, numTerms);
+			if (range == SumRange::TOO_LARGE) {
+				break;
+			} else if (range == SumRange::TOO_SMALL) {
+				continue;
+			}
+
+			chosen.push_back(entries[i]);
+			bool keepSearching = this->search(i + 1, target - entries[i], numTerms - 1, chosen, visit);
+			chosen.pop_back();
+			if (!keepSearching) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/**
+	 * Search the entries from a given index on for pairs that add up to the target, from both ends at once
+	 * @param start The first entry that may be used
+	 * @param target The sum to look for
+	 * @param chosen The entries that have already been fixed, which each pair found is appended to
+	 * @param visit The function to call on each set
+	 * @return bool Whether to keep searching
+	 */
+	template <typename Func>
+	bool searchPairs(std::size_t start, long target, std::vector<long> &chosen, Func &visit) const {
+		const std::vector<long> &entries = this->entries;
+		std::size_t low = start;
+		std::size_t high = entries.size() - 1;
+		while (low < high) {
+			long sum = entries[low] + entries[high];
+			if (sum < target) {
+				low++;
+			} else if (sum > target) {
+				high--;
+			} else {
+				chosen.push_back(entries[low]);
+				chosen.push_back(entries[high]);
+				bool keepSearching = visit(static_cast<const std::vector<long> &>(chosen));
+				chosen.resize(chosen.size() - 2);
+				if (!keepSearching) {
+					return false;
+				}
+
+				// Any other pair with either of these entries would be the same pair again
+				long lowEntry = entries[low];
+				long highEntry = entries[high];
+				while (low < high && entries[low] == lowEntry) {
+					low++;
+				}
+				while (low < high && entries[high] == highEntry) {
+					high--;
+				}
+			}
+		}
+
+		return true;
+	}
+};
+
+/**
+ * Find the first set of entries that adds up to the target, as KSumEngine::findFirst does, but at compile time, where
+ * KSumEngine (which sorts, and allocates) can't run. Each entry can only be used once, and sets with smaller entries
+ * come first. This is a plain search, without KSumEngine's pruning, so it takes O(n^k) time for k entries.
+ * @param entries The entries, in increasing order
+ * @param numEntries The number of entries
+ * @param target The sum to look for
+ * @param numTerms The number of entries to add up, which must be at least one
+ * @param chosen Filled with the entries of the set, in increasing order, if there is one
+ * @return bool Whether any entries add up to the target
+ */
+constexpr bool findFirstConstexpr(const long *entries, std::size_t numEntries, long target, int numTerms, long *chosen) {
+	for (std::size_t i = 0; i + numTerms <= numEntries; i++) {
+		if (i > 0 && entries[i] == entries[i - 1]) {
+			// A repeat of the entry before it can only find the sets that the entry before it already found
+			continue;
+		} else if (entries[i] * numTerms > target) {
+			// The other entries can't be any smaller than this one
+			break;
+		}
+
+		chosen[0] = entries[i];
+		if (numTerms == 1) {
+			if (entries[i] == target) {
+				return true;
+			}
+		} else if (findFirstConstexpr(
+					   entries + i + 1, numEntries - i - 1, target - entries[i], numTerms - 1, chosen + 1)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Multiply some entries together
+ * @param entries The entries
+ * @return long The product of the entries
+ * @throws std::overflow_error if the product doesn't fit in 64 bits
+ */
+inline long multiplyEntries(const std::vector<long> &entries) {
+	long product = 1;
+	for (long entry : entries) {
+		if (__builtin_mul_overflow(product, entry, &product)) {
+			throw std::overflow_error("The product of the entries doesn't fit in 64 bits");
+		}
+	}
+
+	return product;
+}
+
+#endif
@@ -0,0 +1,262 @@
+#ifndef COMMON_PATTERN_HPP
+#define COMMON_PATTERN_HPP
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+#include "integers.hpp"
+
+namespace pattern_detail {
+enum class FieldKind { INT, CHAR, STR };
+
+/**
+ * One piece of a pattern: either a field, or literal text that must appear exactly
+ */
+struct Segment {
+	bool isField;
+	FieldKind kind;
+	// For literals, the text to match
+	std::string_view literal;
+};
+
+/**
+ * Find the end of the segment that starts at the given position of a pattern
+ * @param pattern The pattern
+ * @param start The position of the start of the segment
+ * @return std::size_t The position one past the end of the segment
+ * @throws std::invalid_argument if a field is never closed. At compile time, this makes the pattern fail to compile.
+ */
+constexpr std::size_t findSegmentEnd(std::string_view pattern, std::size_t start) {
+	if (pattern[start] == '{') {
+		std::size_t close = pattern.find('}', start);
+		if (close == std::string_view::npos) {
+			throw std::invalid_argument("Unclosed field in pattern");
+		}
+
+		return close + 1;
+	}
+
+	std::size_t nextField = pattern.find('{', start);
+	return nextField == std::string_view::npos ? pattern.size() : nextField;
+}
+
+constexpr std::size_t countSegments(std::string_view pattern) {
+	std::size_t numSegments = 0;
+	for (std::size_t cursor = 0; cursor < pattern.size(); cursor = findSegmentEnd(pattern, cursor)) {
+		numSegments++;
+	}
+
+	return numSegments;
+}
+
+/**
+ * Split a pattern into its segments
+ * @tparam NumSegments The number of segments in the pattern
+ * @param pattern The pattern
+ * @return std::array<Segment, NumSegments> The segments, in order
+ * @throws std::invalid_argument if a field isn't one of the known kinds, or if a {str} is followed directly by another
+ * field (which would make it ambiguous where the {str} ends). At compile time, this makes the pattern fail to compile.
+ */
+template <std::size_t NumSegments>
+constexpr std::array<Segment, NumSegments> parseSegments(std::string_view pattern) {
+	std::array<Segment, NumSegments> segments{};
+	std::size_t cursor = 0;
+	for (Segment &segment : segments) {
+		std::size_t end = findSegmentEnd(pattern, cursor);
+		std::string_view text = pattern.substr(cursor, end - cursor);
+		if (text == "{int}") {
+			segment = Segment{true, FieldKind::INT, {}};
+		} else if (text == "{char}") {
+			segment = Segment{true, FieldKind::CHAR, {}};
+		} else if (text == "{str}") {
+			segment = Segment{true, FieldKind::STR, {}};
+		} else if (text.front() == '{') {
+			throw std::invalid_argument("Unknown field in pattern");
+		} else {
+			segment = Segment{false, FieldKind::STR, text};
+		}
+
+		cursor = end;
+	}
+
+	for (std::size_t i = 0; i + 1 < NumSegments; i++) {
+		if (segments[i].isField && segments[i].kind == FieldKind::STR && segments[i + 1].isField) {
+			throw std::invalid_argument("A string field must be followed by literal text");
+		}
+	}
+
+	return segments;
+}
+
+template <FieldKind Kind>
+struct FieldType;
+
+template <>
+struct FieldType<FieldKind::INT> {
+	using type = std::int64_t;
+};
+
+template <>
+struct FieldType<FieldKind::CHAR> {
+	using type = char;
+};
+
+template <>
+struct FieldType<FieldKind::STR> {
+	using type = std::string_view;
+};
+}  // namespace pattern_detail
+
+/**
+ * A pattern that a whole line must match, made up of literal text and fields, e.g. "{int}-{int} {char}: {str}". The
+ * pattern is split up at compile time (a malformed pattern doesn't compile), so matching a line is nothing but a walk
+ * along it, and never allocates. The fields are:
+ *  - {int}, an optionally negative decimal integer, as a std::int64_t
+ *  - {char}, any single character
+ *  - {str}, as few characters as possible (possibly none) up to the literal text that follows it, or the rest of the
+ *    line if there is none. If that literal text ends the pattern, the {str} instead runs up to where it ends the line.
+ * @tparam Pattern The pattern. In C++17, this must be a named array with static storage (e.g. a constexpr char[]).
+ */
+template <const char *Pattern>
+class LinePattern {
+ private:
+	static constexpr std::string_view PATTERN = Pattern;
+	static constexpr std::size_t NUM_SEGMENTS = pattern_detail::countSegments(PATTERN);
+	static constexpr auto SEGMENTS = pattern_detail::parseSegments<NUM_SEGMENTS>(PATTERN);
+
+	static constexpr std::size_t countFields() {
+		std::size_t numFields = 0;
+		for (const pattern_detail::Segment &segment : SEGMENTS) {
+			numFields += segment.isField;
+		}
+
+		return numFields;
+	}
+
+	static constexpr std::size_t NUM_FIELDS = countFields();
+
+	/**
+	 * @return std::array<std::size_t, NUM_FIELDS> The index of the segment of each field
+	 */
+	static constexpr std::array<std::size_t, NUM_FIELDS> findFieldSegments() {
+		std::array<std::size_t, NUM_FIELDS> fieldSegments{};
+		std::size_t field = 0;
+		for (std::size_t i = 0; i < NUM_SEGMENTS; i++) {
+			if (SEGMENTS[i].isField) {
+				fieldSegments[field++] = i;
+			}
+		}
+
+		return fieldSegments;
+	}
+
+	static constexpr auto FIELD_SEGMENTS = findFieldSegments();
+
+	template <std::size_t... FieldIndices>
+	static auto makeFields(std::index_sequence<FieldIndices...>)
+		-> std::tuple<typename pattern_detail::FieldType<SEGMENTS[FIELD_SEGMENTS[FieldIndices]].kind>::type...>;
+
+ public:
+	// The values of the fields, in the order they appear in the pattern
+	using Fields = decltype(makeFields(std::make_index_sequence<NUM_FIELDS>()));
+
+	/**
+	 * Match a line against the pattern
+	 * @param line The line to match
+	 * @return std::optional<Fields> The fields, if the whole line matches. Any std::string_views point into the line.
+	 * @throws std::out_of_range if an {int} doesn't fit in a std::int64_t
+	 */
+	static std::optional<Fields> match(std::string_view line) {
+		Fields fields;
+		if (!matchFrom<0, 0>(line, 0, fields)) {
+			return std::nullopt;
+		}
+
+		return fields;
+	}
+
+ private:
+	/**
+	 * Match the rest of a line, one segment at a time. The recursion is resolved at compile time, so this unrolls into
+	 * straight-line code for each segment.
+	 * @tparam SegmentIndex The index of the segment to match next
+	 * @tparam FieldIndex The index of the next field to fill in
+	 * @param line The line to match
+	 * @param cursor The position in the line to match from
+	 * @param fields The fields to fill in
+	 * @return bool Whether the rest of the line matches
+	 */
+	template <std::size_t SegmentIndex, std::size_t FieldIndex>
+	static bool matchFrom(std::string_view line, std::size_t cursor, Fields &fields) {
+		if constexpr (SegmentIndex == NUM_SEGMENTS) {
+			return cursor == line.size();
+		} else {
+			constexpr pattern_detail::Segment segment = SEGMENTS[SegmentIndex];
+			if constexpr (!segment.isField) {
+				if (line.substr(cursor, segment.literal.size()) != segment.literal) {
+					return false;
+				}
+
+				return matchFrom<SegmentIndex + 1, FieldIndex>(line, cursor + segment.literal.size(), fields);
+			} else if constexpr (segment.kind == pattern_detail::FieldKind::CHAR) {
+				if (cursor >= line.size()) {
+					return false;
+				}
+
+				std::get<FieldIndex>(fields) = line[cursor];
+				return matchFrom<SegmentIndex + 1, FieldIndex + 1>(line, cursor + 1, fields);
+			} else if constexpr (segment.kind == pattern_detail::FieldKind::INT) {
+				std::size_t end = cursor < line.size() && line[cursor] == '-' ? cursor + 1 : cursor;
+				std::size_t digitsStart = end;
+				while (end < line.size() && line[end] >= '0' && line[end] <= '9') {
+					end++;
+				}
+
+				if (end == digitsStart) {
+					return false;
+				}
+
+				std::get<FieldIndex>(fields) = parseInteger<std::int64_t>(line.substr(cursor, end - cursor));
+				return matchFrom<SegmentIndex + 1, FieldIndex + 1>(line, end, fields);
+			} else {
+				std::size_t end = findStringEnd<SegmentIndex>(line, cursor);
+				if (end == std::string_view::npos) {
+					return false;
+				}
+
+				std::get<FieldIndex>(fields) = line.substr(cursor, end - cursor);
+				return matchFrom<SegmentIndex + 1, FieldIndex + 1>(line, end, fields);
+			}
+		}
+	}
+
+	/**
+	 * Find where a {str} field ends
+	 * @tparam SegmentIndex The index of the field's segment
+	 * @param line The line being matched
+	 * @param cursor The position the field starts at
+	 * @return std::size_t The position one past the end of the field, or std::string_view::npos if it can't end
+	 */
+	template <std::size_t SegmentIndex>
+	static std::size_t findStringEnd(std::string_view line, std::size_t cursor) {
+		if constexpr (SegmentIndex + 1 == NUM_SEGMENTS) {
+			return line.size();
+		} else {
+			constexpr std::string_view terminator = SEGMENTS[SegmentIndex + 1].literal;
+			if constexpr (SegmentIndex + 2 == NUM_SEGMENTS) {
+				bool endsLine = line.size() >= cursor + terminator.size() &&
+								line.substr(line.size() - terminator.size()) == terminator;
+				return endsLine ? line.size() - terminator.size() : std::string_view::npos;
+			} else {
+				return line.find(terminator, cursor);
+			}
+		}
+	}
+};
+
+#endif
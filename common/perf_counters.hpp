@@ -0,0 +1,194 @@
+#ifndef COMMON_PERF_COUNTERS_HPP
+#define COMMON_PERF_COUNTERS_HPP
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+
+/**
+ * The hardware events counted by PerfCounters
+ */
+enum class PerfEvent { CYCLES, INSTRUCTIONS, L1D_MISSES, LLC_MISSES, DTLB_MISSES, BRANCH_MISSES };
+constexpr int NUM_PERF_EVENTS = 6;
+
+/**
+ * The hardware counts of a single phase of a solution. Any event that couldn't be counted (which is common in
+ * containers and VMs) has no count.
+ */
+class PerfCounts {
+ public:
+	PerfCounts(std::array<std::optional<long>, NUM_PERF_EVENTS> counts) : counts(counts) {
+	}
+
+	const std::optional<long> &getCount(PerfEvent event) const {
+		return this->counts.at(static_cast<int>(event));
+	}
+
+	/**
+	 * @return std::optional<double> The instructions per cycle, if both were counted
+	 */
+	std::optional<double> getInstructionsPerCycle() const {
+		const std::optional<long> &cycles = this->getCount(PerfEvent::CYCLES);
+		const std::optional<long> &instructions = this->getCount(PerfEvent::INSTRUCTIONS);
+		if (!cycles || !instructions || *cycles == 0) {
+			return std::nullopt;
+		}
+
+		return static_cast<double>(*instructions) / *cycles;
+	}
+
+ private:
+	std::array<std::optional<long>, NUM_PERF_EVENTS> counts;
+};
+
+/**
+ * A set of hardware performance counters for the calling thread, opened with perf_event_open. Each event is opened on
+ * its own, so that the events a machine does support can still be counted when others aren't.
+ */
+class PerfCounters {
+ public:
+	PerfCounters() {
+		for (int i = 0; i < NUM_PERF_EVENTS; i++) {
+			perf_event_attr attr = makeEventAttr(static_cast<PerfEvent>(i));
+			int fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+			if (fd == -1) {
+				this->openError = std::strerror(errno);
+			}
+
+			this->fds.at(i) = fd;
+		}
+	}
+
+	PerfCounters(const PerfCounters &) = delete;
+	PerfCounters &operator=(const PerfCounters &) = delete;
+
+	~PerfCounters() {
+		for (int fd : this->fds) {
+			if (fd != -1) {
+				close(fd);
+			}
+		}
+	}
+
+	/**
+	 * @return std::optional<std::string> Why the last event that couldn't be opened failed, if any failed
+	 */
+	const std::optional<std::string> &getOpenError() const {
+		return this->openError;
+	}
+
+	/**
+	 * Reset every counter, and start counting
+	 */
+	void start() {
+		for (int fd : this->fds) {
+			if (fd != -1) {
+				ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+				ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+			}
+		}
+	}
+
+	/**
+	 * Stop counting
+	 * @return PerfCounts The counts since start was called
+	 */
+	PerfCounts stop() {
+		for (int fd : this->fds) {
+			if (fd != -1) {
+				ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+			}
+		}
+
+		std::array<std::optional<long>, NUM_PERF_EVENTS> counts;
+		for (int i = 0; i < NUM_PERF_EVENTS; i++) {
+			counts.at(i) = readCount(this->fds.at(i));
+		}
+
+		return PerfCounts(counts);
+	}
+
+ private:
+	std::array<int, NUM_PERF_EVENTS> fds;
+	std::optional<std::string> openError;
+
+	/**
+	 * Make the attributes to open an event with. Events start disabled, and only count this thread in user space.
+	 * @param event The event to count
+	 * @return perf_event_attr The attributes
+	 */
+	static perf_event_attr makeEventAttr(PerfEvent event) {
+		perf_event_attr attr;
+		std::memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		// If there are more events than hardware counters, the kernel multiplexes them, and these let us scale up the
+		// counts of events that only ran for part of the time
+		attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		switch (event) {
+			case PerfEvent::CYCLES:
+				attr.type = PERF_TYPE_HARDWARE;
+				attr.config = PERF_COUNT_HW_CPU_CYCLES;
+				break;
+			case PerfEvent::INSTRUCTIONS:
+				attr.type = PERF_TYPE_HARDWARE;
+				attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+				break;
+			case PerfEvent::L1D_MISSES:
+				attr.type = PERF_TYPE_HW_CACHE;
+				attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+							  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+				break;
+			case PerfEvent::LLC_MISSES:
+				attr.type = PERF_TYPE_HW_CACHE;
+				attr.config = PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+							  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+				break;
+			case PerfEvent::DTLB_MISSES:
+				attr.type = PERF_TYPE_HW_CACHE;
+				attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+							  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+				break;
+			case PerfEvent::BRANCH_MISSES:
+				attr.type = PERF_TYPE_HARDWARE;
+				attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+				break;
+		}
+
+		return attr;
+	}
+
+	/**
+	 * Read the count of an event, scaled up if it was multiplexed
+	 * @param fd The event's file descriptor
+	 * @return std::optional<long> The count, if the event could be counted
+	 */
+	static std::optional<long> readCount(int fd) {
+		if (fd == -1) {
+			return std::nullopt;
+		}
+
+		// The count, the time enabled, and the time running, as asked for by read_format
+		std::array<std::uint64_t, 3> values;
+		if (read(fd, values.data(), sizeof(values)) != sizeof(values)) {
+			return std::nullopt;
+		} else if (values.at(2) == 0) {
+			// An event that was enabled but never got a hardware counter wasn't counted at all
+			return values.at(1) == 0 ? std::optional<long>(0) : std::nullopt;
+		}
+
+		return static_cast<long>(static_cast<double>(values.at(0)) * values.at(1) / values.at(2));
+	}
+};
+
+#endif
@@ -0,0 +1,671 @@
+#ifndef COMMON_SOLVER_HPP
+#define COMMON_SOLVER_HPP
+
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "cache.hpp"
+#include "input.hpp"
+#include "integers.hpp"
+#include "stream.hpp"
+#include "thread_pool.hpp"
+#include "timing.hpp"
+#include "trace.hpp"
+
+// Prints the timing of each phase (as JSON, to stderr) after the answers
+constexpr auto TIMINGS_FLAG = "--timings";
+// Adds the heap allocations of each phase to its timing (and implies --timings)
+constexpr auto ALLOCATIONS_FLAG = "--allocations";
+// Adds the hardware performance counters of each phase to its timing (and implies --timings)
+constexpr auto COUNTERS_FLAG = "--counters";
+// Sets the number of threads to solve a batch of inputs with (or the parts of an input, with --concurrent)
+constexpr auto JOBS_FLAG = "--jobs";
+// Runs the independent parts of each solution concurrently, on a shared pool of threads
+constexpr auto CONCURRENT_FLAG = "--concurrent";
+// Sets a directory to cache the answers to each input in, so that an input that has been solved before isn't again
+constexpr auto CACHE_FLAG = "--cache";
+// Writes a Chrome trace of every phase, and of calls to the traced recursive functions, to the given file
+constexpr auto TRACE_FLAG = "--trace";
+// Sets how deeply nested a span can be and still be traced
+constexpr auto TRACE_DEPTH_FLAG = "--trace-depth";
+// Sets how many calls of each traced recursive function there are for each one that is traced
+constexpr auto TRACE_SAMPLE_FLAG = "--trace-sample";
+constexpr int DEFAULT_TRACE_DEPTH = 16;
+constexpr int DEFAULT_TRACE_SAMPLE_INTERVAL = 1;
+// Passing this in place of an input file streams the input from stdin, for the days that can
+constexpr auto STDIN_INPUT = "-";
+
+/**
+ * Runs the phases of a solution (parsing, each part, etc). Solvers hand every phase to the runner, rather than calling
+ * it directly, so that the same solver can be run normally, benchmarked, or otherwise instrumented.
+ */
+class PhaseRunner {
+ public:
+	/**
+	 * @param answerPool The pool to run independent answers on concurrently, if any. It must outlive the runner.
+	 */
+	explicit PhaseRunner(ThreadPool *answerPool = nullptr) : answerPool(answerPool) {
+	}
+
+	virtual ~PhaseRunner() = default;
+
+	/**
+	 * @return bool Whether the runner counts something about each phase (allocations, hardware events) that it can
+	 * only see on the thread that runs the phase. A phase that would otherwise spread its work across threads should
+	 * keep it on the calling thread while this is true, or most of that work would go uncounted.
+	 */
+	virtual bool isCountingPerThread() const {
+		return false;
+	}
+
+	/**
+	 * Run a single phase of the solution
+	 * @tparam Func A function that takes no arguments and returns the phase's result
+	 * @param name The name of the phase
+	 * @param func The phase to run. This may be run more than once, so it must not modify anything it captures.
+	 * @return The result of the phase
+	 */
+	template <typename Func>
+	std::invoke_result_t<Func> phase(const std::string &name, Func &&func) {
+		std::optional<std::invoke_result_t<Func>> result;
+		TraceSpan span(name);
+		this->runPhase(name, [&result, &func]() { result.emplace(func()); });
+
+		return std::move(*result);
+	}
+
+	/**
+	 * Run a phase of the solution that produces one of the puzzle's answers
+	 * @tparam Func A function that takes no arguments and returns the answer. Its result must be printable.
+	 * @param name The name of the phase
+	 * @param func The phase to run. This may be run more than once, so it must not modify anything it captures.
+	 * @return The answer
+	 */
+	template <typename Func>
+	std::invoke_result_t<Func> answer(const std::string &name, Func &&func) {
+		auto result = this->phase(name, std::forward<Func>(func));
+		std::ostringstream answerStream;
+		answerStream << result;
+		this->keepAnswer(name, answerStream.str());
+
+		return result;
+	}
+
+	/**
+	 * Run phases that each produce one of the puzzle's answers, and that don't depend on each other (as the parts
+	 * usually don't). If the runner has a pool, they are run on it concurrently, but either way, their answers are
+	 * recorded in the order they are given in.
+	 * @tparam Funcs Functions that take no arguments and return the answers. Their results must be printable.
+	 * @param names The name of each phase
+	 * @param funcs The phases to run. These may be run more than once, and alongside each other, so they must not
+	 * modify anything they capture.
+	 */
+	template <typename... Funcs>
+	void answers(const std::array<std::string, sizeof...(Funcs)> &names, Funcs &&...funcs) {
+		std::array<std::function<std::string()>, sizeof...(Funcs)> bodies{[&funcs]() {
+			std::ostringstream answerStream;
+			answerStream << funcs();
+			return answerStream.str();
+		}...};
+
+		if (this->answerPool == nullptr) {
+			for (std::size_t i = 0; i < names.size(); i++) {
+				this->keepAnswer(names[i], this->phase(names[i], bodies[i]));
+			}
+
+			return;
+		}
+
+		// The first phase is run on this thread, rather than leaving it to wait on the others
+		std::array<std::future<std::string>, sizeof...(Funcs)> results;
+		for (std::size_t i = 1; i < names.size(); i++) {
+			results[i] = this->answerPool->submit([this, &names, &bodies, i]() {
+				return this->phase(names[i], bodies[i]);
+			});
+		}
+
+		// Every phase refers to this frame, so all of them must finish before an error can leave it. As in a sequential
+		// run, the answers before the first error are still recorded.
+		std::exception_ptr error;
+		for (std::size_t i = 0; i < names.size(); i++) {
+			try {
+				std::string answer =
+					i == 0 ? this->phase(names[i], bodies[i]) : this->answerPool->await(results[i]);
+				if (!error) {
+					this->keepAnswer(names[i], answer);
+				}
+			} catch (...) {
+				if (!error) {
+					error = std::current_exception();
+				}
+			}
+		}
+
+		if (error) {
+			std::rethrow_exception(error);
+		}
+	}
+
+	/**
+	 * @return const std::vector<std::string>& Every answer recorded so far, in order
+	 */
+	const std::vector<std::string> &getAnswers() const {
+		return this->answersSoFar;
+	}
+
+ protected:
+	/**
+	 * Run the body of a phase
+	 * @param name The name of the phase
+	 * @param body The body of the phase, which must be run at least once
+	 */
+	virtual void runPhase(const std::string &name, const std::function<void()> &body) = 0;
+
+	/**
+	 * Record an answer that a phase produced
+	 * @param name The name of the phase
+	 * @param answer The answer, as it should be printed
+	 */
+	virtual void recordAnswer(const std::string &name, const std::string &answer) = 0;
+
+ private:
+	ThreadPool *answerPool;
+	std::vector<std::string> answersSoFar;
+
+	void keepAnswer(const std::string &name, const std::string &answer) {
+		this->answersSoFar.push_back(answer);
+		this->recordAnswer(name, answer);
+	}
+};
+
+/**
+ * The PhaseRunner for a normal run, which runs every phase once and prints each answer as it is found
+ */
+class ConsoleRunner : public PhaseRunner {
+ public:
+	using PhaseRunner::PhaseRunner;
+
+ protected:
+	void runPhase(const std::string &name, const std::function<void()> &body) override {
+		body();
+	}
+
+	void recordAnswer(const std::string &name, const std::string &answer) override {
+		std::cout << answer << std::endl;
+	}
+};
+
+/**
+ * A ConsoleRunner that also times every phase. This is kept separate so that a normal run pays nothing for timing. It
+ * never runs phases concurrently, so that each phase's timing (and counts) are its own.
+ */
+class TimingRunner : public ConsoleRunner {
+ public:
+	/**
+	 * @param countAllocations Whether to count the allocations of each phase as well. Counting must already be enabled.
+	 * @param countPerfEvents Whether to count the hardware events of each phase as well
+	 */
+	TimingRunner(bool countAllocations = false, bool countPerfEvents = false) : countAllocations(countAllocations) {
+		if (countPerfEvents) {
+			this->perfCounters.emplace();
+		}
+	}
+
+	const std::vector<PhaseTiming> &getTimings() const {
+		return this->timings;
+	}
+
+	/**
+	 * @return const std::optional<PerfCounters>& The hardware counters used for each phase, if any
+	 */
+	const std::optional<PerfCounters> &getPerfCounters() const {
+		return this->perfCounters;
+	}
+
+	bool isCountingPerThread() const override {
+		return this->countAllocations || this->perfCounters;
+	}
+
+ protected:
+	void runPhase(const std::string &name, const std::function<void()> &body) override {
+		ScopedTimer timer(
+			name, this->timings, this->countAllocations, this->perfCounters ? &*this->perfCounters : nullptr);
+		ConsoleRunner::runPhase(name, body);
+	}
+
+ private:
+	bool countAllocations;
+	// The counters are opened once, and reused for every phase
+	std::optional<PerfCounters> perfCounters;
+	std::vector<PhaseTiming> timings;
+};
+
+/**
+ * A PhaseRunner that runs every phase once and only keeps the answers (see getAnswers), rather than printing them
+ */
+class CollectingRunner : public PhaseRunner {
+ public:
+	using PhaseRunner::PhaseRunner;
+
+ protected:
+	void runPhase(const std::string &name, const std::function<void()> &body) override {
+		body();
+	}
+
+	void recordAnswer(const std::string &name, const std::string &answer) override {
+	}
+};
+
+/**
+ * The options shared by every solver's command line
+ */
+class RunOptions {
+ public:
+	/**
+	 * Parse the command line. Flags may appear anywhere; every other argument is positional.
+	 * @param argc argc from main
+	 * @param argv argv from main
+	 * @return RunOptions The parsed options
+	 * @throws std::invalid_argument if a flag is unknown or missing its value, or a value isn't an integer
+	 * @throws std::out_of_range if a value is too large for an int
+	 */
+	static RunOptions parse(int argc, char *argv[]) {
+		RunOptions options;
+		for (int i = 1; i < argc; i++) {
+			std::string arg = argv[i];
+			if (arg == TIMINGS_FLAG) {
+				options.withTimings = true;
+			} else if (arg == ALLOCATIONS_FLAG) {
+				options.withTimings = true;
+				options.withAllocations = true;
+			} else if (arg == COUNTERS_FLAG) {
+				options.withTimings = true;
+				options.withPerfCounters = true;
+			} else if (arg == CONCURRENT_FLAG) {
+				options.withConcurrentParts = true;
+			} else if (arg == CACHE_FLAG && i + 1 < argc) {
+				options.cacheDirectory = argv[++i];
+			} else if (arg == JOBS_FLAG && i + 1 < argc) {
+				options.numJobs = parseInteger<int>(argv[++i]);
+				if (options.numJobs < 1) {
+					throw std::invalid_argument("Must use at least one job");
+				}
+			} else if (arg == TRACE_FLAG && i + 1 < argc) {
+				options.traceFilename = argv[++i];
+			} else if (arg == TRACE_DEPTH_FLAG && i + 1 < argc) {
+				options.traceDepth = parseInteger<int>(argv[++i]);
+				if (options.traceDepth < 0) {
+					throw std::invalid_argument("The trace depth can't be negative");
+				}
+			} else if (arg == TRACE_SAMPLE_FLAG && i + 1 < argc) {
+				options.traceSampleInterval = parseInteger<int>(argv[++i]);
+				if (options.traceSampleInterval < 1) {
+					throw std::invalid_argument("Must trace at least one in every n calls");
+				}
+			} else if (arg.rfind("--", 0) == 0) {
+				throw std::invalid_argument("Invalid option " + arg);
+			} else {
+				options.positional.push_back(std::move(arg));
+			}
+		}
+
+		return options;
+	}
+
+	bool getWithTimings() const {
+		return this->withTimings;
+	}
+
+	bool getWithAllocations() const {
+		return this->withAllocations;
+	}
+
+	bool getWithPerfCounters() const {
+		return this->withPerfCounters;
+	}
+
+	bool getWithConcurrentParts() const {
+		return this->withConcurrentParts;
+	}
+
+	const std::optional<std::string> &getCacheDirectory() const {
+		return this->cacheDirectory;
+	}
+
+	const std::optional<std::string> &getTraceFilename() const {
+		return this->traceFilename;
+	}
+
+	int getTraceDepth() const {
+		return this->traceDepth;
+	}
+
+	int getTraceSampleInterval() const {
+		return this->traceSampleInterval;
+	}
+
+	int getNumJobs() const {
+		return this->numJobs;
+	}
+
+	const std::vector<std::string> &getPositional() const {
+		return this->positional;
+	}
+
+ private:
+	bool withTimings = false;
+	bool withAllocations = false;
+	bool withPerfCounters = false;
+	bool withConcurrentParts = false;
+	std::optional<std::string> cacheDirectory;
+	std::optional<std::string> traceFilename;
+	int traceDepth = DEFAULT_TRACE_DEPTH;
+	int traceSampleInterval = DEFAULT_TRACE_SAMPLE_INTERVAL;
+	int numJobs = ThreadPool::getDefaultNumThreads();
+	std::vector<std::string> positional;
+};
+
+// Every day provides one of these, which reads its parsed input from the MappedInput and runs its parts
+using SolveFunction = void (*)(PhaseRunner &, const MappedInput &);
+// Days that only ever need their input a line at a time may also provide one of these, which consumes the input as it
+// is streamed, and runs its parts
+using StreamSolveFunction = void (*)(PhaseRunner &, LineStream &);
+
+/**
+ * Run a solution with the PhaseRunner the command line asks for, printing its answers (and its timings, if asked)
+ * @tparam Func A function that takes a PhaseRunner, runs the solution with it, and returns the number of lines in the
+ * input
+ * @param inputName The name of the input, for the timings
+ * @param options The options from the command line
+ * @param run The solution to run
+ */
+template <typename Func>
+void runWithOptions(const std::string &inputName, const RunOptions &options, Func &&run) {
+	if (!options.getWithTimings()) {
+		std::optional<ThreadPool> pool;
+		if (options.getWithConcurrentParts()) {
+			pool.emplace(options.getNumJobs());
+		}
+
+		ConsoleRunner runner(pool ? &*pool : nullptr);
+		run(runner);
+		return;
+	}
+
+	if (options.getWithAllocations()) {
+		allocationCountingEnabled = true;
+	}
+
+	TimingRunner runner(options.getWithAllocations(), options.getWithPerfCounters());
+	if (runner.getPerfCounters() && runner.getPerfCounters()->getOpenError()) {
+		// This is expected in most containers, so the run carries on with whatever could be counted
+		std::cerr << "Some hardware counters are unavailable (" << *runner.getPerfCounters()->getOpenError()
+				  << "), and will be null" << std::endl;
+	}
+
+	long numInputLines = run(runner);
+	writeTimings(std::cerr, inputName, numInputLines, runner.getTimings());
+}
+
+/**
+ * Read an input and run solvers on it. If the answers to the input are cached, they are recorded straight from the
+ * cache instead, and if not, they are cached once they are found.
+ * @param runner The runner to run the solvers with
+ * @param solvers The solvers to run, in order
+ * @param filename The input file
+ * @param cache The cache of answers, if any
+ * @return long The number of lines in the input
+ */
+inline long solveInput(
+	PhaseRunner &runner,
+	const std::vector<SolveFunction> &solvers,
+	const std::string &filename,
+	const ResultCache *cache) {
+	MappedInput input = runner.phase("read", [&filename]() { return MappedInput(filename); });
+	if (cache != nullptr) {
+		auto cachedAnswers =
+			runner.phase("cacheLookup", [cache, &input]() { return cache->lookup(input.getContents()); });
+		if (cachedAnswers) {
+			for (const std::string &answer : *cachedAnswers) {
+				runner.answer("cached", [&answer]() { return answer; });
+			}
+
+			return static_cast<long>(input.getNumLines());
+		}
+	}
+
+	for (SolveFunction solve : solvers) {
+		solve(runner, input);
+	}
+
+	if (cache != nullptr) {
+		try {
+			cache->store(input.getContents(), runner.getAnswers());
+		} catch (const std::runtime_error &e) {
+			// The answers are still good, they'll just have to be found again next time
+			std::cerr << "Could not cache the answers to " << filename << ": " << e.what() << std::endl;
+		}
+	}
+
+	return static_cast<long>(input.getNumLines());
+}
+
+/**
+ * Read an input and run solvers on it, printing their answers
+ * @param solvers The solvers to run, in order
+ * @param filename The input file
+ * @param options The options from the command line, which say whether to print the timing (and counts) of each phase
+ * once all of the solvers have run
+ * @param cache The cache of answers, if any
+ */
+inline void runSolvers(
+	const std::vector<SolveFunction> &solvers,
+	const std::string &filename,
+	const RunOptions &options,
+	const ResultCache *cache = nullptr) {
+	runWithOptions(filename, options, [&solvers, &filename, cache](PhaseRunner &runner) {
+		return solveInput(runner, solvers, filename, cache);
+	});
+}
+
+/**
+ * Stream an input from stdin into a solver, printing its answers
+ * @param solveStream The solver
+ * @param options The options from the command line, which say whether to print the timing (and counts) of each phase
+ * once the solver has run
+ */
+inline void runStreamSolver(StreamSolveFunction solveStream, const RunOptions &options) {
+	runWithOptions("<stdin>", options, [solveStream](PhaseRunner &runner) {
+		LineStream stream(STDIN_FILENO);
+		solveStream(runner, stream);
+
+		return stream.getNumLines();
+	});
+}
+
+/**
+ * Solve a batch of inputs concurrently, printing one line per input, in the order they were given. Each line has the
+ * input's name and each of its answers, separated by tabs. An input that can't be solved gets an error in place of its
+ * answers, and does not stop the rest of the batch.
+ * @param os The stream to print the results to
+ * @param solvers The solvers to run on each input, in order
+ * @param filenames The input files
+ * @param numJobs The number of threads to solve with
+ * @param concurrentParts Whether to run the independent parts of each input concurrently as well, on the same threads
+ * @param cache The cache of answers, if any
+ * @return bool Whether every input was solved
+ */
+inline bool runBatch(
+	std::ostream &os,
+	const std::vector<SolveFunction> &solvers,
+	const std::vector<std::string> &filenames,
+	int numJobs,
+	bool concurrentParts = false,
+	const ResultCache *cache = nullptr) {
+	ThreadPool pool(numJobs);
+	std::vector<std::future<std::string>> results;
+	results.reserve(filenames.size());
+	for (const std::string &filename : filenames) {
+		results.push_back(pool.submit([&solvers, &filename, &pool, concurrentParts, cache]() {
+			std::string result = filename;
+			try {
+				CollectingRunner runner(concurrentParts ? &pool : nullptr);
+				solveInput(runner, solvers, filename, cache);
+				for (const std::string &answer : runner.getAnswers()) {
+					result += "\t" + answer;
+				}
+			} catch (const std::exception &e) {
+				return result + "\terror: " + e.what();
+			} catch (...) {
+				// Some of the solvers throw pointers to exceptions, which can't be inspected without leaking them
+				return result + "\terror";
+			}
+
+			return result;
+		}));
+	}
+
+	bool allSolved = true;
+	for (std::future<std::string> &result : results) {
+		std::string line = result.get();
+		allSolved = allSolved && line.find("\terror") == std::string::npos;
+		os << line << '\n';
+	}
+
+	os.flush();
+
+	return allSolved;
+}
+
+/**
+ * Find every input file in the given paths. Directories are replaced by the files directly inside of them, sorted by
+ * name.
+ * @param paths The paths to search
+ * @return std::vector<std::string> The input files
+ */
+inline std::vector<std::string> findInputFiles(const std::vector<std::string> &paths) {
+	std::vector<std::string> filenames;
+	for (const std::string &path : paths) {
+		if (!std::filesystem::is_directory(path)) {
+			filenames.push_back(path);
+			continue;
+		}
+
+		std::vector<std::string> directoryFilenames;
+		for (const std::filesystem::directory_entry &entry : std::filesystem::directory_iterator(path)) {
+			if (entry.is_regular_file()) {
+				directoryFilenames.push_back(entry.path().string());
+			}
+		}
+
+		std::sort(directoryFilenames.begin(), directoryFilenames.end());
+		std::move(directoryFilenames.begin(), directoryFilenames.end(), std::back_inserter(filenames));
+	}
+
+	return filenames;
+}
+
+/**
+ * Run solvers on the inputs from the command line. A single input file is solved as normal, but several files (or a
+ * directory of them) are solved as a batch. An input of STDIN_INPUT is streamed into the stream solver.
+ * @param solvers The solvers to run on each input, in order
+ * @param solverName The name the solvers' answers are cached under
+ * @param paths The input files or directories
+ * @param options The options from the command line
+ * @param solveStream The stream solver, if there is one
+ * @return int The exit code for main
+ */
+inline int runInputs(
+	const std::vector<SolveFunction> &solvers,
+	const std::string &solverName,
+	const std::vector<std::string> &paths,
+	const RunOptions &options,
+	StreamSolveFunction solveStream = nullptr) {
+	// The trace is written once everything has been solved, however the run ends
+	std::optional<ScopedTrace> trace;
+	if (options.getTraceFilename()) {
+		trace.emplace(*options.getTraceFilename(), options.getTraceDepth(), options.getTraceSampleInterval());
+	}
+
+	if (paths.size() == 1 && paths.front() == STDIN_INPUT) {
+		if (solveStream == nullptr) {
+			std::cerr << "This day needs its whole input at once, so it can't be streamed" << std::endl;
+			return 1;
+		}
+
+		runStreamSolver(solveStream, options);
+		return 0;
+	} else if (std::find(paths.cbegin(), paths.cend(), STDIN_INPUT) != paths.cend()) {
+		std::cerr << "A streamed input can't be part of a batch" << std::endl;
+		return 1;
+	}
+
+	std::optional<ResultCache> cache;
+	if (options.getCacheDirectory()) {
+		try {
+			cache.emplace(*options.getCacheDirectory(), solverName);
+		} catch (const std::exception &e) {
+			std::cerr << "Could not open the cache: " << e.what() << std::endl;
+			return 1;
+		}
+	}
+
+	const ResultCache *cachePtr = cache ? &*cache : nullptr;
+	if (paths.size() == 1 && !std::filesystem::is_directory(paths.front())) {
+		runSolvers(solvers, paths.front(), options, cachePtr);
+		return 0;
+	} else if (options.getWithTimings()) {
+		std::cerr << TIMINGS_FLAG << ", " << ALLOCATIONS_FLAG << ", and " << COUNTERS_FLAG
+				  << " can only be used with a single input file" << std::endl;
+		return 1;
+	}
+
+	bool allSolved = runBatch(
+		std::cout, solvers, findInputFiles(paths), options.getNumJobs(), options.getWithConcurrentParts(), cachePtr);
+
+	return allSolved ? 0 : 1;
+}
+
+/**
+ * Run a day's solver from its main
+ * @param argc argc from main
+ * @param argv argv from main
+ * @param solve The day's solver
+ * @param solveStream The day's stream solver, if it has one
+ * @return int The exit code for main
+ */
+inline int runSolver(int argc, char *argv[], SolveFunction solve, StreamSolveFunction solveStream = nullptr) {
+	std::optional<RunOptions> options;
+	try {
+		options = RunOptions::parse(argc, argv);
+	} catch (const std::exception &e) {
+		std::cerr << e.what() << std::endl;
+	}
+
+	if (!options || options->getPositional().empty()) {
+		std::cerr << argv[0] << " [" << TIMINGS_FLAG << "] [" << ALLOCATIONS_FLAG << "] [" << COUNTERS_FLAG << "] ["
+				  << CONCURRENT_FLAG << "] [" << JOBS_FLAG << " n] [" << CACHE_FLAG << " directory] [" << TRACE_FLAG
+				  << " file [" << TRACE_DEPTH_FLAG << " n] [" << TRACE_SAMPLE_FLAG << " n]] "
+				  << "<input_file|input_directory|" << STDIN_INPUT << ">..." << std::endl;
+		return 1;
+	}
+
+	// Each day has a binary of its own, so the binary's name is the day's
+	std::string solverName = std::filesystem::path(argv[0]).filename().string();
+
+	return runInputs({solve}, solverName, options->getPositional(), *options, solveStream);
+}
+
+#endif
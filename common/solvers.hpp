@@ -0,0 +1,135 @@
+#ifndef COMMON_SOLVERS_HPP
+#define COMMON_SOLVERS_HPP
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "input.hpp"
+#include "solver.hpp"
+#include "stream.hpp"
+
+// Each of these is defined in its day's directory. Anything that links against every day must compile each of them
+// with AOC_NO_MAIN defined, so their mains don't collide.
+namespace day1 {
+void solve(PhaseRunner &runner, const MappedInput &input);
+}
+namespace day2 {
+void solve(PhaseRunner &runner, const MappedInput &input);
+void solveStream(PhaseRunner &runner, LineStream &stream);
+}
+namespace day3 {
+void solve(PhaseRunner &runner, const MappedInput &input);
+}
+namespace day4 {
+void solve(PhaseRunner &runner, const MappedInput &input);
+}
+namespace day5 {
+void solve(PhaseRunner &runner, const MappedInput &input);
+void solveStream(PhaseRunner &runner, LineStream &stream);
+}
+namespace day6 {
+void solve(PhaseRunner &runner, const MappedInput &input);
+}
+namespace day7 {
+void solve(PhaseRunner &runner, const MappedInput &input);
+}
+namespace day8 {
+void solve(PhaseRunner &runner, const MappedInput &input);
+}
+namespace day9 {
+void solve(PhaseRunner &runner, const MappedInput &input);
+}
+namespace day10 {
+void solve(PhaseRunner &runner, const MappedInput &input);
+}
+namespace day11 {
+void solve(PhaseRunner &runner, const MappedInput &input);
+}
+namespace day12 {
+void solve(PhaseRunner &runner, const MappedInput &input);
+void solveStream(PhaseRunner &runner, LineStream &stream);
+}
+namespace day13 {
+void solve(PhaseRunner &runner, const MappedInput &input);
+}
+namespace day14 {
+void solve(PhaseRunner &runner, const MappedInput &input);
+}
+namespace day15 {
+void solve(PhaseRunner &runner, const MappedInput &input);
+}
+namespace day16 {
+void solve(PhaseRunner &runner, const MappedInput &input);
+}
+namespace day17p1 {
+void solve(PhaseRunner &runner, const MappedInput &input);
+}
+namespace day17p2 {
+void solve(PhaseRunner &runner, const MappedInput &input);
+}
+namespace day18 {
+void solve(PhaseRunner &runner, const MappedInput &input);
+}
+namespace day19 {
+void solve(PhaseRunner &runner, const MappedInput &input);
+}
+namespace day20 {
+void solve(PhaseRunner &runner, const MappedInput &input);
+}
+namespace day21 {
+void solve(PhaseRunner &runner, const MappedInput &input);
+}
+namespace day22 {
+void solve(PhaseRunner &runner, const MappedInput &input);
+}
+namespace day23 {
+void solve(PhaseRunner &runner, const MappedInput &input);
+}
+namespace day24 {
+void solve(PhaseRunner &runner, const MappedInput &input);
+void solveStream(PhaseRunner &runner, LineStream &stream);
+}
+namespace day25 {
+void solve(PhaseRunner &runner, const MappedInput &input);
+}
+
+// Every solver, in order. Day 17 has a separate solver for each part.
+inline const std::vector<std::pair<std::string, SolveFunction>> SOLVERS{
+	{"day1", day1::solve},
+	{"day2", day2::solve},
+	{"day3", day3::solve},
+	{"day4", day4::solve},
+	{"day5", day5::solve},
+	{"day6", day6::solve},
+	{"day7", day7::solve},
+	{"day8", day8::solve},
+	{"day9", day9::solve},
+	{"day10", day10::solve},
+	{"day11", day11::solve},
+	{"day12", day12::solve},
+	{"day13", day13::solve},
+	{"day14", day14::solve},
+	{"day15", day15::solve},
+	{"day16", day16::solve},
+	{"day17p1", day17p1::solve},
+	{"day17p2", day17p2::solve},
+	{"day18", day18::solve},
+	{"day19", day19::solve},
+	{"day20", day20::solve},
+	{"day21", day21::solve},
+	{"day22", day22::solve},
+	{"day23", day23::solve},
+	{"day24", day24::solve},
+	{"day25", day25::solve},
+};
+
+// The days that can stream their input, by the name of their solver
+inline const std::vector<std::pair<std::string, StreamSolveFunction>> STREAM_SOLVERS{
+	{"day2", day2::solveStream},
+	{"day5", day5::solveStream},
+	{"day12", day12::solveStream},
+	{"day24", day24::solveStream},
+};
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef COMMON_STREAM_HPP
+#define COMMON_STREAM_HPP
+
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// The size of each read from the stream. Only this, and the longest line, are ever held in memory at once.
+constexpr std::size_t STREAM_CHUNK_SIZE = 64 * 1024;
+
+/**
+ * A puzzle input that is read line by line from a file descriptor (usually stdin), without ever holding all of it in
+ * memory. Unlike a MappedInput, a stream can only be read once, so it can't be benchmarked.
+ */
+class LineStream {
+ public:
+	/**
+	 * @param fd The file descriptor to read from. It is not closed by the stream.
+	 */
+	explicit LineStream(int fd) : fd(fd), chunk(STREAM_CHUNK_SIZE) {
+	}
+
+	/**
+	 * Read the rest of the stream, handing each line to a consumer as it is read. Like MappedInput::getLines, a
+	 * trailing newline does not produce an extra empty line.
+	 * @tparam Func A function that takes a std::string_view of a line, without its newline. The view is only valid
+	 * until the function returns.
+	 * @param consume The consumer of each line
+	 * @throws std::runtime_error if the stream cannot be read
+	 */
+	template <typename Func>
+	void forEachLine(Func &&consume) {
+		// Holds the start of a line that runs past the end of a chunk
+		std::string partialLine;
+		while (true) {
+			ssize_t numRead = read(this->fd, this->chunk.data(), this->chunk.size());
+			if (numRead == -1 && errno == EINTR) {
+				continue;
+			} else if (numRead == -1) {
+				throw std::runtime_error(std::string("Could not read input stream: ") + std::strerror(errno));
+			} else if (numRead == 0) {
+				break;
+			}
+
+			std::string_view data(this->chunk.data(), numRead);
+			std::string_view::size_type cursor = 0;
+			while (cursor < data.size()) {
+				auto newline = data.find('\n', cursor);
+				if (newline == std::string_view::npos) {
+					partialLine.append(data.substr(cursor));
+					break;
+				}
+
+				std::string_view line = data.substr(cursor, newline - cursor);
+				if (partialLine.empty()) {
+					consume(line);
+				} else {
+					partialLine.append(line);
+					consume(std::string_view(partialLine));
+					partialLine.clear();
+				}
+
+				this->numLines++;
+				cursor = newline + 1;
+			}
+		}
+
+		if (!partialLine.empty()) {
+			consume(std::string_view(partialLine));
+			this->numLines++;
+		}
+	}
+
+	/**
+	 * @return long The number of lines that have been read so far
+	 */
+	long getNumLines() const {
+		return this->numLines;
+	}
+
+ private:
+	int fd;
+	std::vector<char> chunk;
+	long numLines = 0;
+};
+
+#endif
@@ -0,0 +1,209 @@
+#ifndef COMMON_THREAD_POOL_HPP
+#define COMMON_THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// How long a thread that is waiting on a task sleeps when there's nothing queued to help with, before it looks again
+constexpr std::chrono::microseconds AWAIT_RETRY_INTERVAL(200);
+
+/**
+ * A fixed-size, work-stealing pool of threads. Every worker has its own queue of tasks, and once it runs dry, it steals
+ * from the other workers' queues, so that a few slow tasks can't hold up everything queued behind them.
+ */
+class ThreadPool {
+ public:
+	/**
+	 * @param numThreads The number of worker threads
+	 * @throws std::invalid_argument if there are no threads
+	 */
+	ThreadPool(int numThreads) {
+		if (numThreads < 1) {
+			throw std::invalid_argument("A thread pool needs at least one thread");
+		}
+
+		for (int i = 0; i < numThreads; i++) {
+			this->queues.push_back(std::make_unique<TaskQueue>());
+		}
+		for (int i = 0; i < numThreads; i++) {
+			this->workers.emplace_back([this, i]() { this->runWorker(i); });
+		}
+	}
+
+	ThreadPool(const ThreadPool &) = delete;
+	ThreadPool &operator=(const ThreadPool &) = delete;
+
+	/**
+	 * Finish every task that has been submitted, and stop the workers
+	 */
+	~ThreadPool() {
+		{
+			std::lock_guard<std::mutex> lock(this->wakeMutex);
+			this->stopping = true;
+		}
+
+		this->wakeCondition.notify_all();
+		for (std::thread &worker : this->workers) {
+			worker.join();
+		}
+	}
+
+	/**
+	 * @return int The number of threads to use by default, which is one per core
+	 */
+	static int getDefaultNumThreads() {
+		return std::max(1U, std::thread::hardware_concurrency());
+	}
+
+	int getNumThreads() const {
+		return this->workers.size();
+	}
+
+	/**
+	 * Submit a task to the pool. A task submitted from one of the pool's workers goes on that worker's own queue.
+	 * @tparam Func A function that takes no arguments
+	 * @param func The task to run
+	 * @return std::future<std::invoke_result_t<Func>> The result of the task, or the exception it threw
+	 */
+	template <typename Func>
+	std::future<std::invoke_result_t<Func>> submit(Func &&func) {
+		using Result = std::invoke_result_t<Func>;
+		auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Func>(func));
+		std::future<Result> future = task->get_future();
+		std::size_t queueIndex =
+			currentPool == this ? currentWorkerIndex : this->nextQueueIndex++ % this->queues.size();
+		{
+			std::lock_guard<std::mutex> lock(this->queues.at(queueIndex)->mutex);
+			this->queues.at(queueIndex)->tasks.emplace_back([task]() { (*task)(); });
+		}
+		{
+			// This must be updated under the lock so that a worker can't miss the wakeup between checking for tasks and
+			// going to sleep
+			std::lock_guard<std::mutex> lock(this->wakeMutex);
+			this->numQueuedTasks++;
+		}
+
+		this->wakeCondition.notify_one();
+
+		return future;
+	}
+
+	/**
+	 * Run a single queued task on the calling thread, if there is one. A thread that is waiting on the pool's tasks can
+	 * use this to help out, rather than block (which could deadlock if it is a worker itself).
+	 * @return bool Whether a task was run
+	 */
+	bool runQueuedTask() {
+		std::optional<std::function<void()>> task = this->takeTask(currentPool == this ? currentWorkerIndex : 0);
+		if (!task) {
+			return false;
+		}
+
+		(*task)();
+
+		return true;
+	}
+
+	/**
+	 * Wait for the result of a task, running other queued tasks in the meantime
+	 * @param future The future of a task submitted to this pool
+	 * @return T The result of the task
+	 */
+	template <typename T>
+	T await(std::future<T> &future) {
+		while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+			if (!this->runQueuedTask()) {
+				// Nothing is queued right now, but the task may still submit more to help with, so rather than block
+				// for good (or spin, which takes a core from the threads doing the work), this sleeps until either the
+				// task is done or it's time to look again
+				future.wait_for(AWAIT_RETRY_INTERVAL);
+			}
+		}
+
+		return future.get();
+	}
+
+ private:
+	struct TaskQueue {
+		std::mutex mutex;
+		std::deque<std::function<void()>> tasks;
+	};
+
+	// Which pool (if any) the current thread is a worker of, and which of its workers it is
+	static inline thread_local const ThreadPool *currentPool = nullptr;
+	static inline thread_local std::size_t currentWorkerIndex = 0;
+
+	std::vector<std::unique_ptr<TaskQueue>> queues;
+	std::vector<std::thread> workers;
+	std::atomic<std::size_t> nextQueueIndex = 0;
+	std::mutex wakeMutex;
+	std::condition_variable wakeCondition;
+	std::atomic<long> numQueuedTasks = 0;
+	bool stopping = false;
+
+	/**
+	 * Take a task, preferring the newest task on the given queue, and otherwise stealing the oldest task of another
+	 * @param queueIndex The index of the queue to take from first
+	 * @return std::optional<std::function<void()>> The task, if there were any queued
+	 */
+	std::optional<std::function<void()>> takeTask(std::size_t queueIndex) {
+		for (std::size_t i = 0; i < this->queues.size(); i++) {
+			TaskQueue &queue = *this->queues.at((queueIndex + i) % this->queues.size());
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (queue.tasks.empty()) {
+				continue;
+			}
+
+			std::function<void()> task;
+			if (i == 0) {
+				task = std::move(queue.tasks.back());
+				queue.tasks.pop_back();
+			} else {
+				task = std::move(queue.tasks.front());
+				queue.tasks.pop_front();
+			}
+
+			this->numQueuedTasks--;
+			return task;
+		}
+
+		return std::nullopt;
+	}
+
+	/**
+	 * Run tasks until the pool is stopped and there are none left
+	 * @param workerIndex The index of this worker
+	 */
+	void runWorker(std::size_t workerIndex) {
+		currentPool = this;
+		currentWorkerIndex = workerIndex;
+		while (true) {
+			std::optional<std::function<void()>> task = this->takeTask(workerIndex);
+			if (task) {
+				(*task)();
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(this->wakeMutex);
+			this->wakeCondition.wait(lock, [this]() { return this->stopping || this->numQueuedTasks > 0; });
+			if (this->stopping && this->numQueuedTasks == 0) {
+				return;
+			}
+		}
+	}
+};
+
+#endif
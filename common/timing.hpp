@@ -0,0 +1,245 @@
+#ifndef COMMON_TIMING_HPP
+#define COMMON_TIMING_HPP
+
+#include <sys/resource.h>
+#include <time.h>
+
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "allocations.hpp"
+#include "json.hpp"
+#include "perf_counters.hpp"
+
+/**
+ * The resources used by a single phase of a solution
+ */
+class PhaseTiming {
+ public:
+	PhaseTiming(
+		std::string name,
+		long wallNanoseconds,
+		long cpuNanoseconds,
+		long peakRSSBytes,
+		std::optional<AllocationCounts> allocations = std::nullopt,
+		std::optional<PerfCounts> perfCounts = std::nullopt)
+		: name(std::move(name)),
+		  wallNanoseconds(wallNanoseconds),
+		  cpuNanoseconds(cpuNanoseconds),
+		  peakRSSBytes(peakRSSBytes),
+		  allocations(std::move(allocations)),
+		  perfCounts(std::move(perfCounts)) {
+	}
+
+	const std::string &getName() const {
+		return this->name;
+	}
+
+	long getWallNanoseconds() const {
+		return this->wallNanoseconds;
+	}
+
+	long getCPUNanoseconds() const {
+		return this->cpuNanoseconds;
+	}
+
+	/**
+	 * @return long The peak resident set size of the process as of the end of the phase. This is a high water mark, so
+	 * it may have been reached in an earlier phase.
+	 */
+	long getPeakRSSBytes() const {
+		return this->peakRSSBytes;
+	}
+
+	/**
+	 * @return const std::optional<AllocationCounts>& The heap traffic of the phase, if allocations were counted
+	 */
+	const std::optional<AllocationCounts> &getAllocations() const {
+		return this->allocations;
+	}
+
+	/**
+	 * @return const std::optional<PerfCounts>& The hardware counts of the phase, if hardware events were counted
+	 */
+	const std::optional<PerfCounts> &getPerfCounts() const {
+		return this->perfCounts;
+	}
+
+ private:
+	std::string name;
+	long wallNanoseconds;
+	long cpuNanoseconds;
+	long peakRSSBytes;
+	std::optional<AllocationCounts> allocations;
+	std::optional<PerfCounts> perfCounts;
+};
+
+/**
+ * Times the scope it lives in, and records a PhaseTiming for it when the scope ends
+ */
+class ScopedTimer {
+ public:
+	/**
+	 * @param name The name of the phase being timed
+	 * @param timings The timings to add this scope's timing to once it ends
+	 * @param countAllocations Whether to count the allocations made in this scope. Counting must already be enabled.
+	 * @param perfCounters The hardware counters to count this scope's events with, if any
+	 */
+	ScopedTimer(
+		std::string name,
+		std::vector<PhaseTiming> &timings,
+		bool countAllocations = false,
+		PerfCounters *perfCounters = nullptr)
+		: name(std::move(name)), timings(timings), perfCounters(perfCounters) {
+		if (countAllocations) {
+			this->allocationCounter.emplace();
+		}
+
+		// The clocks are read last, so that they don't time setting up the counters
+		this->wallStart = std::chrono::steady_clock::now();
+		this->cpuStart = getCPUTime();
+		if (this->perfCounters != nullptr) {
+			this->perfCounters->start();
+		}
+	}
+
+	ScopedTimer(const ScopedTimer &) = delete;
+	ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+	~ScopedTimer() {
+		std::optional<PerfCounts> perfCounts;
+		if (this->perfCounters != nullptr) {
+			perfCounts = this->perfCounters->stop();
+		}
+
+		std::chrono::nanoseconds wallElapsed = std::chrono::steady_clock::now() - this->wallStart;
+		long cpuElapsed = getCPUTime() - this->cpuStart;
+		// The counts must be taken before recording the timing, which allocates
+		std::optional<AllocationCounts> allocations;
+		if (this->allocationCounter) {
+			allocations = this->allocationCounter->getCounts();
+		}
+
+		this->timings.emplace_back(
+			std::move(this->name),
+			wallElapsed.count(),
+			cpuElapsed,
+			getPeakRSS(),
+			std::move(allocations),
+			std::move(perfCounts));
+	}
+
+ private:
+	std::string name;
+	std::vector<PhaseTiming> &timings;
+	std::optional<ScopedAllocationCounter> allocationCounter;
+	PerfCounters *perfCounters;
+	std::chrono::steady_clock::time_point wallStart;
+	long cpuStart;
+
+	/**
+	 * @return long The CPU time used by every thread of this process so far, in nanoseconds
+	 */
+	static long getCPUTime() {
+		timespec cpuTime;
+		if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpuTime) != 0) {
+			throw std::runtime_error(std::string("Failed to get CPU time: ") + std::strerror(errno));
+		}
+
+		return cpuTime.tv_sec * 1'000'000'000L + cpuTime.tv_nsec;
+	}
+
+	/**
+	 * @return long The peak resident set size of this process so far, in bytes
+	 */
+	static long getPeakRSS() {
+		rusage usage;
+		if (getrusage(RUSAGE_SELF, &usage) != 0) {
+			throw std::runtime_error(std::string("Failed to get resource usage: ") + std::strerror(errno));
+		}
+
+		// ru_maxrss is in kilobytes
+		return usage.ru_maxrss * 1024L;
+	}
+};
+
+/**
+ * Write an optional number as JSON
+ * @tparam T The type of number
+ * @param os The stream to write to
+ * @param value The number, which is written as null if it is missing
+ */
+template <typename T>
+void writeJSONNumber(std::ostream &os, const std::optional<T> &value) {
+	if (value) {
+		os << *value;
+	} else {
+		os << "null";
+	}
+}
+
+// The name of each PerfEvent in the timings, in the order they are declared
+constexpr std::array<const char *, NUM_PERF_EVENTS> PERF_EVENT_NAMES{
+	"cycles", "instructions", "l1d_misses", "llc_misses", "dtlb_misses", "branch_misses"};
+
+/**
+ * Write the timings of a run as a single line of JSON. Phases whose allocations were counted also get their counts, and
+ * the number of allocations per line of input. Likewise, phases whose hardware events were counted get their counts,
+ * their instructions per cycle, and their misses per line of input. Any of these that couldn't be counted are null.
+ * @param os The stream to write to
+ * @param filename The input file of the run
+ * @param numInputLines The number of lines in the input file
+ * @param timings The timings of each phase of the run
+ */
+inline void writeTimings(
+	std::ostream &os, const std::string &filename, long numInputLines, const std::vector<PhaseTiming> &timings) {
+	os << "{\"input\": " << toJSONString(filename) << ", \"input_lines\": " << numInputLines << ", \"phases\": [";
+	for (auto it = timings.cbegin(); it != timings.cend(); ++it) {
+		os << (it == timings.cbegin() ? "" : ", ") << "{\"name\": " << toJSONString(it->getName())
+		   << ", \"wall_ns\": " << it->getWallNanoseconds() << ", \"cpu_ns\": " << it->getCPUNanoseconds()
+		   << ", \"peak_rss_bytes\": " << it->getPeakRSSBytes();
+		if (it->getAllocations()) {
+			const AllocationCounts &allocations = *it->getAllocations();
+			os << ", \"allocations\": " << allocations.getNumAllocations()
+			   << ", \"allocated_bytes\": " << allocations.getAllocatedBytes()
+			   << ", \"peak_live_bytes\": " << allocations.getPeakLiveBytes() << ", \"allocations_per_line\": "
+			   << (numInputLines > 0 ? static_cast<double>(allocations.getNumAllocations()) / numInputLines : 0);
+		}
+
+		if (it->getPerfCounts()) {
+			const PerfCounts &perfCounts = *it->getPerfCounts();
+			for (int i = 0; i < NUM_PERF_EVENTS; i++) {
+				os << ", \"" << PERF_EVENT_NAMES.at(i) << "\": ";
+				writeJSONNumber(os, perfCounts.getCount(static_cast<PerfEvent>(i)));
+			}
+
+			os << ", \"ipc\": ";
+			writeJSONNumber(os, perfCounts.getInstructionsPerCycle());
+			for (PerfEvent event :
+				 {PerfEvent::L1D_MISSES, PerfEvent::LLC_MISSES, PerfEvent::DTLB_MISSES, PerfEvent::BRANCH_MISSES}) {
+				const std::optional<long> &count = perfCounts.getCount(event);
+				std::optional<double> countPerLine;
+				if (count) {
+					countPerLine = numInputLines > 0 ? static_cast<double>(*count) / numInputLines : 0;
+				}
+
+				os << ", \"" << PERF_EVENT_NAMES.at(static_cast<int>(event)) << "_per_line\": ";
+				writeJSONNumber(os, countPerLine);
+			}
+		}
+
+		os << "}";
+	}
+
+	os << "]}" << std::endl;
+}
+
+#endif
@@ -0,0 +1,313 @@
+#ifndef COMMON_TRACE_HPP
+#define COMMON_TRACE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "json.hpp"
+
+// The most spans a trace keeps, across every thread, so that tracing a huge recursion can't exhaust memory
+constexpr long MAX_TRACE_SPANS = 1000000;
+
+/**
+ * A single span of a trace
+ */
+class TraceSpanEvent {
+ public:
+	TraceSpanEvent(std::string name, const char *category, long startNanoseconds, long durationNanoseconds, int depth)
+		: name(std::move(name)),
+		  category(category),
+		  startNanoseconds(startNanoseconds),
+		  durationNanoseconds(durationNanoseconds),
+		  depth(depth) {
+	}
+
+	const std::string &getName() const {
+		return this->name;
+	}
+
+	const char *getCategory() const {
+		return this->category;
+	}
+
+	/**
+	 * @return long When the span started, relative to the start of the trace
+	 */
+	long getStartNanoseconds() const {
+		return this->startNanoseconds;
+	}
+
+	long getDurationNanoseconds() const {
+		return this->durationNanoseconds;
+	}
+
+	/**
+	 * @return int How many spans enclosed this one on its thread when it started (including ones that weren't kept)
+	 */
+	int getDepth() const {
+		return this->depth;
+	}
+
+ private:
+	std::string name;
+	const char *category;
+	long startNanoseconds;
+	long durationNanoseconds;
+	int depth;
+};
+
+/**
+ * Collects the spans of a run, from any number of threads, so they can be written out as a Chrome trace (which
+ * chrome://tracing and Perfetto both load). Each thread appends to a buffer of its own, so recording a span never takes
+ * a lock.
+ */
+class TraceRecorder {
+ public:
+	/**
+	 * @param maxDepth Recursive spans nested any deeper than this are not kept
+	 * @param sampleInterval Only one in this many calls of each recursive function gets a span
+	 */
+	TraceRecorder(int maxDepth, int sampleInterval)
+		: maxDepth(maxDepth), sampleInterval(sampleInterval), start(std::chrono::steady_clock::now()) {
+	}
+
+	TraceRecorder(const TraceRecorder &) = delete;
+	TraceRecorder &operator=(const TraceRecorder &) = delete;
+
+	int getMaxDepth() const {
+		return this->maxDepth;
+	}
+
+	int getSampleInterval() const {
+		return this->sampleInterval;
+	}
+
+	/**
+	 * @return long The time since the trace started
+	 */
+	long now() const {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - this->start)
+			.count();
+	}
+
+	/**
+	 * Keep a span, unless the trace is already full
+	 * @param event The span
+	 */
+	void record(TraceSpanEvent event) {
+		if (this->numSpans.fetch_add(1, std::memory_order_relaxed) >= MAX_TRACE_SPANS) {
+			this->numDroppedSpans.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		this->findThreadBuffer().events.push_back(std::move(event));
+	}
+
+	/**
+	 * Write the trace, in Chrome's trace event format. Every thread that recorded a span must have finished.
+	 * @param os The stream to write to
+	 */
+	void write(std::ostream &os) const {
+		os << "{\"displayTimeUnit\": \"ns\", \"otherData\": {\"dropped_spans\": " << this->numDroppedSpans.load()
+		   << ", \"max_depth\": " << this->maxDepth << ", \"sample_interval\": " << this->sampleInterval
+		   << "}, \"traceEvents\": [";
+		bool first = true;
+		for (const std::unique_ptr<ThreadBuffer> &buffer : this->threadBuffers) {
+			for (const TraceSpanEvent &event : buffer->events) {
+				// The format's times are in (fractional) microseconds
+				char times[64];
+				std::snprintf(
+					times,
+					sizeof(times),
+					"\"ts\": %.3f, \"dur\": %.3f",
+					event.getStartNanoseconds() / 1000.0,
+					event.getDurationNanoseconds() / 1000.0);
+				os << (first ? "" : ",") << "\n{\"name\": " << toJSONString(event.getName()) << ", \"cat\": \""
+				   << event.getCategory() << "\", \"ph\": \"X\", " << times << ", \"pid\": 1, \"tid\": "
+				   << buffer->threadIndex << ", \"args\": {\"depth\": " << event.getDepth() << "}}";
+				first = false;
+			}
+		}
+
+		os << "\n]}" << std::endl;
+	}
+
+ private:
+	struct ThreadBuffer {
+		int threadIndex;
+		std::vector<TraceSpanEvent> events;
+	};
+
+	int maxDepth;
+	int sampleInterval;
+	std::chrono::steady_clock::time_point start;
+	std::atomic<long> numSpans = 0;
+	std::atomic<long> numDroppedSpans = 0;
+	std::mutex threadBuffersMutex;
+	std::vector<std::unique_ptr<ThreadBuffer>> threadBuffers;
+
+	ThreadBuffer &findThreadBuffer() {
+		// Only one trace is ever recorded at a time, but a thread may outlive one trace and go on to record another
+		thread_local const TraceRecorder *bufferOwner = nullptr;
+		thread_local ThreadBuffer *buffer = nullptr;
+		if (bufferOwner != this) {
+			std::lock_guard<std::mutex> lock(this->threadBuffersMutex);
+			this->threadBuffers.push_back(std::make_unique<ThreadBuffer>());
+			this->threadBuffers.back()->threadIndex = this->threadBuffers.size();
+			buffer = this->threadBuffers.back().get();
+			bufferOwner = this;
+		}
+
+		return *buffer;
+	}
+};
+
+// The trace being recorded, if any. This is only ever set while no solver is running.
+inline TraceRecorder *activeTrace = nullptr;
+
+namespace trace_detail {
+// How many spans (kept or not) enclose the current point on this thread
+inline thread_local int currentDepth = 0;
+}  // namespace trace_detail
+
+/**
+ * Traces the scope it lives in, if a trace is being recorded. Otherwise, this costs a single check.
+ */
+class TraceSpan {
+ public:
+	/**
+	 * @param name The name of the span, which must outlive it
+	 * @param category The category of the span, which trace viewers can filter by
+	 * @param keep Whether to keep the span. Even if it isn't kept, it still counts towards the depth of the spans inside
+	 * of it.
+	 */
+	explicit TraceSpan(std::string_view name, const char *category = "phase", bool keep = true)
+		: trace(activeTrace), name(name), category(category), keep(keep) {
+		if (this->trace == nullptr) {
+			return;
+		}
+
+		this->depth = trace_detail::currentDepth++;
+		this->keep = this->keep && (this->depth <= this->trace->getMaxDepth());
+		if (this->keep) {
+			this->startNanoseconds = this->trace->now();
+		}
+	}
+
+	TraceSpan(const TraceSpan &) = delete;
+	TraceSpan &operator=(const TraceSpan &) = delete;
+
+	~TraceSpan() {
+		if (this->trace == nullptr) {
+			return;
+		}
+
+		trace_detail::currentDepth--;
+		if (this->keep) {
+			long duration = this->trace->now() - this->startNanoseconds;
+			this->trace->record(TraceSpanEvent(
+				std::string(this->name), this->category, this->startNanoseconds, duration, this->depth));
+		}
+	}
+
+ private:
+	TraceRecorder *trace;
+	std::string_view name;
+	const char *category;
+	bool keep;
+	int depth = 0;
+	long startNanoseconds = 0;
+};
+
+/**
+ * A recursive function to be traced. Each one should be a single object that lives as long as the program, so that
+ * calls from every level of the recursion share the same sampling count.
+ */
+class TracedFunction {
+ public:
+	explicit TracedFunction(const char *name) : name(name) {
+	}
+
+	const char *getName() const {
+		return this->name;
+	}
+
+	/**
+	 * Count a call, and decide whether it should be sampled
+	 * @param sampleInterval One in this many calls is sampled
+	 * @return bool Whether to sample this call
+	 */
+	bool sampleCall(int sampleInterval) {
+		return this->numCalls.fetch_add(1, std::memory_order_relaxed) % sampleInterval == 0;
+	}
+
+ private:
+	const char *name;
+	std::atomic<long> numCalls = 0;
+};
+
+/**
+ * Traces one call of a recursive function, if a trace is being recorded, and if the call is sampled and isn't nested
+ * too deeply
+ */
+class RecursiveTraceSpan {
+ public:
+	/**
+	 * @param function The function being called
+	 */
+	explicit RecursiveTraceSpan(TracedFunction &function) {
+		if (activeTrace != nullptr) {
+			this->span.emplace(
+				function.getName(), "recursion", function.sampleCall(activeTrace->getSampleInterval()));
+		}
+	}
+
+ private:
+	std::optional<TraceSpan> span;
+};
+
+/**
+ * Records a trace for as long as it lives, and then writes it to a file. Every thread that records into it must have
+ * finished by then.
+ */
+class ScopedTrace {
+ public:
+	/**
+	 * @param filename The file to write the trace to
+	 * @param maxDepth Spans nested any deeper than this are not kept
+	 * @param sampleInterval Only one in this many calls of each recursive function gets a span
+	 */
+	ScopedTrace(std::string filename, int maxDepth, int sampleInterval)
+		: filename(std::move(filename)), recorder(maxDepth, sampleInterval) {
+		activeTrace = &this->recorder;
+	}
+
+	ScopedTrace(const ScopedTrace &) = delete;
+	ScopedTrace &operator=(const ScopedTrace &) = delete;
+
+	~ScopedTrace() {
+		activeTrace = nullptr;
+		std::ofstream file(this->filename);
+		this->recorder.write(file);
+		if (!file) {
+			std::cerr << "Could not write the trace to " << this->filename << std::endl;
+		}
+	}
+
+ private:
+	std::string filename;
+	TraceRecorder recorder;
+};
+
+#endif
@@ -1,59 +1,535 @@
-#include <fstream>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <future>
 #include <iostream>
-#include <set>
+#include <limits>
+#include <optional>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../common/embedded.hpp"
+#include "../common/input.hpp"
+#include "../common/integers.hpp"
+#include "../common/ksum.hpp"
+#include "../common/solver.hpp"
+#include "../common/thread_pool.hpp"
+
+namespace day1 {
 
 constexpr int TARGET_NUM = 2020;
+// Sets the sum to look for, in place of TARGET_NUM
+constexpr auto TARGET_FLAG = "--target";
+// Looks for this many entries, as a single answer, in place of the two parts
+constexpr auto NUM_TERMS_FLAG = "--k";
+// Counts every distinct set of entries that sums to the target, in place of the product of the first
+constexpr auto ALL_FLAG = "--all";
+// Answers every target in a file (one per line) against a single input, in place of the two parts
+constexpr auto QUERIES_FLAG = "--queries";
+// Splits the search for the first set of three or more entries across this many threads
+constexpr auto SEARCH_THREADS_FLAG = "--search-threads";
+// An index only keeps a bitmap of its entries if they span at most this many values (which takes 32 MiB)
+constexpr long MAX_BITMAP_RANGE = 1L << 28;
+// The number of queries that each task of a batch answers, so that the pool isn't swamped by tiny tasks
+constexpr std::size_t QUERIES_PER_TASK = 64;
+
+/**
+ * An index of the entries of an input, to answer the pair and triple of many targets against. Alongside the sorted
+ * entries, it keeps a bitmap of which values are present (unless they span too many values to be worth it), so that
+ * finding the last entry of a sum is a single bit test, rather than a search. It finds the same sets as
+ * KSumEngine::findFirst.
+ */
+class EntryIndex {
+ public:
+	/**
+	 * @param engine The entries, which the index takes over
+	 * @throws std::overflow_error if the entries are too large to add up three of in 64 bits
+	 */
+	explicit EntryIndex(KSumEngine engine) : engine(std::move(engine)) {
+		const std::vector<long> &entries = this->engine.getEntries();
+		if (entries.empty()) {
+			return;
+		}
+
+		long smallest = std::max(entries.front(), -std::numeric_limits<long>::max());
+		long maxMagnitude = std::max(std::labs(smallest), std::labs(entries.back()));
+		if (maxMagnitude > std::numeric_limits<long>::max() / 6) {
+			throw std::overflow_error("The entries are too large to add up in 64 bits");
+		}
+
+		this->minEntry = entries.front();
+		this->maxEntry = entries.back();
+		if (this->maxEntry - this->minEntry < MAX_BITMAP_RANGE) {
+			this->present.resize((this->maxEntry - this->minEntry) / 64 + 1);
+			for (long entry : entries) {
+				long offset = entry - this->minEntry;
+				this->present[offset / 64] |= std::uint64_t{1} << (offset % 64);
+			}
+		}
+	}
+
+	const KSumEngine &getEngine() const {
+		return this->engine;
+	}
+
+	/**
+	 * Find the first pair of entries that adds up to the target
+	 * @param target The sum to look for
+	 * @return std::optional<long> The product of the pair, if there is one
+	 * @throws std::overflow_error if the product doesn't fit in 64 bits
+	 */
+	std::optional<long> findPairProduct(long target) const {
+		const std::vector<long> &entries = this->engine.getEntries();
+		if (entries.empty() || !this->isReachable(target, 2)) {
+			return std::nullopt;
+		}
+
+		std::optional<std::size_t> low = this->findPartner(0, target);
+		if (!low) {
+			return std::nullopt;
+		}
+
+		return multiplyEntries({entries[*low], target - entries[*low]});
+	}
+
+	/**
+	 * Find the first triple of entries that adds up to the target
+	 * @param target The sum to look for
+	 * @return std::optional<long> The product of the triple, if there is one
+	 * @throws std::overflow_error if the product doesn't fit in 64 bits
+	 */
+	std::optional<long> findTripleProduct(long target) const {
+		const std::vector<long> &entries = this->engine.getEntries();
+		if (entries.empty() || !this->isReachable(target, 3)) {
+			return std::nullopt;
+		}
+
+		for (std::size_t i = 0; i + 2 < entries.size(); i++) {
+			long first = entries[i];
+			if (3 * first > target) {
+				// The other two entries can't be any smaller than this one
+				break;
+			} else if (i > 0 && first == entries[i - 1]) {
+				continue;
+			}
+
+			std::optional<std::size_t> second = this->findPartner(i + 1, target - first);
+			if (second) {
+				return multiplyEntries({first, entries[*second], target - first - entries[*second]});
+			}
+		}
+
+		return std::nullopt;
+	}
+
+ private:
+	KSumEngine engine;
+	long minEntry = 0;
+	long maxEntry = 0;
+	// A bit for each value from minEntry to maxEntry, which is set if the value is an entry
+	std::vector<std::uint64_t> present;
+
+	/**
+	 * @param target A sum
+	 * @param numTerms The number of entries to add up
+	 * @return bool Whether that many entries could possibly add up to the sum, which also keeps the arithmetic of a
+	 * search for it from overflowing
+	 */
+	bool isReachable(long target, int numTerms) const {
+		return target >= numTerms * this->minEntry && target <= numTerms * this->maxEntry;
+	}
+
+	/**
+	 * @param value A value
+	 * @return bool Whether the value is an entry
+	 */
+	bool contains(long value) const {
+		if (value < this->minEntry || value > this->maxEntry) {
+			return false;
+		} else if (this->present.empty()) {
+			const std::vector<long> &entries = this->engine.getEntries();
+			return std::binary_search(entries.cbegin(), entries.cend(), value);
+		}
+
+		long offset = value - this->minEntry;
+		return (this->present[offset / 64] >> (offset % 64)) & 1;
+	}
+
+	/**
+	 * Find the smallest entry, from a given index on, with a partner later on that adds up to the target with it
+	 * @param start The first entry that may be used
+	 * @param target The sum to look for
+	 * @return std::optional<std::size_t> The index of the smaller entry of the pair, if there is one
+	 */
+	std::optional<std::size_t> findPartner(std::size_t start, long target) const {
+		const std::vector<long> &entries = this->engine.getEntries();
+		for (std::size_t i = start; i + 1 < entries.size(); i++) {
+			long partner = target - entries[i];
+			if (partner < entries[i]) {
+				// Every later entry would need a partner smaller than itself, which it's already been checked against
+				break;
+			} else if (partner == entries[i] ? entries[i + 1] == partner : this->contains(partner)) {
+				// An entry can only be its own partner if it repeats, and the entry after a repeat is the repeat
+				return i;
+			}
+		}
+
+		return std::nullopt;
+	}
+};
+
+/**
+ * What to look for, as the command line of day 1's own binary asks
+ */
+class KSumQuery {
+ public:
+	KSumQuery() = default;
+
+	/**
+	 * @param target The sum to look for
+	 * @param numTerms The number of entries to add up, or std::nullopt for both parts (pairs, and then triples)
+	 * @param findAll Whether to count every distinct set of entries, rather than multiply the entries of the first
+	 * @param queriesFilename A file of targets to answer the pair and triple of, in place of the target, if any
+	 * @param numSearchThreads The number of threads to search for the first set of three or more entries on
+	 */
+	KSumQuery(
+		long target,
+		std::optional<int> numTerms,
+		bool findAll,
+		std::optional<std::string> queriesFilename,
+		int numSearchThreads)
+		: target(target),
+		  numTerms(numTerms),
+		  findAll(findAll),
+		  queriesFilename(std::move(queriesFilename)),
+		  numSearchThreads(numSearchThreads) {
+	}
+
+	long getTarget() const {
+		return this->target;
+	}
+
+	const std::optional<int> &getNumTerms() const {
+		return this->numTerms;
+	}
+
+	bool getFindAll() const {
+		return this->findAll;
+	}
+
+	const std::optional<std::string> &getQueriesFilename() const {
+		return this->queriesFilename;
+	}
+
+	int getNumSearchThreads() const {
+		return this->numSearchThreads;
+	}
+
+	/**
+	 * @return bool Whether this is what the puzzle itself asks for (however many threads it's searched on)
+	 */
+	bool isPuzzleQuery() const {
+		return this->target == TARGET_NUM && !this->numTerms && !this->findAll && !this->queriesFilename;
+	}
+
+ private:
+	long target = TARGET_NUM;
+	std::optional<int> numTerms;
+	bool findAll = false;
+	std::optional<std::string> queriesFilename;
+	int numSearchThreads = 1;
+};
+
+// The query that solve answers. Only day 1's own main ever changes this, before anything is solved.
+KSumQuery activeQuery;
+
+/**
+ * Parse the input as a list of integers
+ * @param input The puzzle input
+ * @return KSumEngine An engine over the numbers in the input
+ */
+KSumEngine parseInput(std::string_view input) {
+	return KSumEngine(parseIntegers<long>(input));
+}
+
+/**
+ * Find the product of the first set of entries that adds up to the target
+ * @param engine The entries
+ * @param target The sum to look for
+ * @param numTerms The number of entries to add up
+ * @param pool The pool to search on, if any
+ * @return long The product of the entries
+ * @throws std::runtime_error if no entries add up to the target
+ * @throws std::overflow_error if the product doesn't fit in 64 bits
+ */
+long findProduct(const KSumEngine &engine, long target, int numTerms, ThreadPool *pool = nullptr) {
+	std::optional<std::vector<long>> solution =
+		pool != nullptr ? engine.findFirst(target, numTerms, *pool) : engine.findFirst(target, numTerms);
+	if (!solution) {
+		throw std::runtime_error("Does not contain solution");
+	}
+
+	return multiplyEntries(*solution);
+}
+
+/**
+ * Answer the pair and triple of many targets against the same entries, on a pool of threads, and write one line for
+ * each target, in order, with the target and the product of its pair and its triple, separated by tabs. A target that
+ * no pair (or triple) adds up to gets "none" in its place.
+ * @param os The stream to write to
+ * @param index The entries
+ * @param targets The targets
+ * @param numJobs The number of threads to answer the targets on
+ */
+void answerTargets(std::ostream &os, const EntryIndex &index, const std::vector<long> &targets, int numJobs) {
+	ThreadPool pool(numJobs);
+	std::vector<std::future<std::string>> results;
+	for (std::size_t start = 0; start < targets.size(); start += QUERIES_PER_TASK) {
+		std::size_t end = std::min(start + QUERIES_PER_TASK, targets.size());
+		results.push_back(pool.submit([&index, &targets, start, end]() {
+			std::string result;
+			for (std::size_t i = start; i < end; i++) {
+				result += std::to_string(targets[i]);
+				try {
+					for (std::optional<long> product :
+						 {index.findPairProduct(targets[i]), index.findTripleProduct(targets[i])}) {
+						result += "\t" + (product ? std::to_string(*product) : std::string("none"));
+					}
+				} catch (const std::overflow_error &e) {
+					result += "\terror: " + std::string(e.what());
+				}
+
+				result += '\n';
+			}
+
+			return result;
+		}));
+	}
+
+	for (std::future<std::string> &result : results) {
+		os << result.get();
+	}
+
+	os.flush();
+}
 
 /**
- * Read the input and get it as a set of integers
- * @param filename The filename to read from
- * @return std::set<int> A set of the numbers in the input
+ * Answer a query, which is the product of the first set of entries that add up to its target, or the number of
+ * distinct sets that do, if it asks for all of them
+ * @param engine The entries
+ * @param query The query
+ * @param numTerms The number of entries to add up
+ * @param pool The pool to search for the first set on, if any
+ * @return long The answer
  */
-std::set<int> readInput(const std::string &filename) {
-	std::set<int> input;
-	std::string line;
-	std::ifstream file(filename);
+long answerQuery(const KSumEngine &engine, const KSumQuery &query, int numTerms, ThreadPool *pool) {
+	if (query.getFindAll()) {
+		long numSolutions = 0;
+		engine.forEachSolution(query.getTarget(), numTerms, [&numSolutions](const std::vector<long> &) {
+			numSolutions++;
+			return true;
+		});
 
-	while (std::getline(file, line)) {
-		int num = std::stoi(line);
-		input.insert(num);
+		return numSolutions;
 	}
 
-	return input;
+	return findProduct(engine, query.getTarget(), numTerms, pool);
 }
 
-int part1(const std::set<int> &inputs) {
-	for (int num : inputs) {
-		int desired = TARGET_NUM - num;
-		if (inputs.find(desired) != inputs.end()) {
-			return desired * num;
+/**
+ * The entries of an input, kept in increasing order, as a list that (unlike std::vector) can be built at compile time
+ * @tparam Capacity The most entries the list can hold
+ */
+template <std::size_t Capacity>
+class EntryList {
+ public:
+	/**
+	 * Add an entry to the list, in order
+	 * @param num The entry
+	 * @throws std::length_error if the list is full
+	 */
+	constexpr void insert(long num) {
+		if (this->numEntries == Capacity) {
+			throw std::length_error("Too many entries");
+		}
+
+		std::size_t i = this->numEntries++;
+		for (; i > 0 && this->entries[i - 1] > num; i--) {
+			this->entries[i] = this->entries[i - 1];
 		}
+
+		this->entries[i] = num;
 	}
 
-	throw std::runtime_error("Does not contain solution");
+	/**
+	 * Find the product of the first set of entries that adds up to TARGET_NUM, as findProduct does
+	 * @tparam NumTerms The number of entries to add up
+	 * @return long The product of the entries
+	 * @throws std::runtime_error if no entries add up to the target
+	 * @throws std::overflow_error if the product doesn't fit in 64 bits
+	 */
+	template <int NumTerms>
+	constexpr long findProduct() const {
+		std::array<long, NumTerms> chosen{};
+		if (!findFirstConstexpr(this->entries.data(), this->numEntries, TARGET_NUM, NumTerms, chosen.data())) {
+			throw std::runtime_error("Does not contain solution");
+		}
+
+		long product = 1;
+		for (long entry : chosen) {
+			if (__builtin_mul_overflow(product, entry, &product)) {
+				throw std::overflow_error("The product of the entries doesn't fit in 64 bits");
+			}
+		}
+
+		return product;
+	}
+
+ private:
+	std::array<long, Capacity> entries{};
+	std::size_t numEntries = 0;
+};
+
+void solve(PhaseRunner &runner, const MappedInput &input) {
+	KSumEngine engine = runner.phase("parse", [&input]() { return parseInput(input.getContents()); });
+	const KSumQuery &query = activeQuery;
+	std::optional<ThreadPool> searchPool;
+	if (query.getNumSearchThreads() > 1) {
+		searchPool.emplace(query.getNumSearchThreads());
+	}
+
+	ThreadPool *pool = searchPool ? &*searchPool : nullptr;
+	if (query.getNumTerms()) {
+		runner.answer("kSum", [&engine, &query, pool]() {
+			return answerQuery(engine, query, *query.getNumTerms(), pool);
+		});
+		return;
+	}
+
+	runner.answers(
+		{"part1", "part2"},
+		[&engine, &query, pool]() { return answerQuery(engine, query, 2, pool); },
+		[&engine, &query, pool]() { return answerQuery(engine, query, 3, pool); });
 }
 
-int part2(const std::set<int> &inputs) {
-	for (int num : inputs) {
-		for (int num2 : inputs) {
-			int desired = TARGET_NUM - (num + num2);
-			if (inputs.find(desired) != inputs.end()) {
-				return desired * num2 * num;
+/**
+ * Take day 1's own options out of the command line, leaving the rest for runSolver
+ * @param argc argc from main
+ * @param argv argv from main
+ * @param remainingArgs Filled with the arguments that aren't day 1's own, starting with argv[0]
+ * @return KSumQuery The query the options ask for
+ * @throws std::invalid_argument if an option's value is missing or invalid, or the options can't be combined
+ */
+KSumQuery parseQueryOptions(int argc, char *argv[], std::vector<char *> &remainingArgs) {
+	long target = TARGET_NUM;
+	std::optional<int> numTerms;
+	bool findAll = false;
+	std::optional<std::string> queriesFilename;
+	int numSearchThreads = 1;
+	bool withCache = false;
+	remainingArgs.push_back(argv[0]);
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == TARGET_FLAG && i + 1 < argc) {
+			target = parseInteger<long>(argv[++i]);
+		} else if (arg == NUM_TERMS_FLAG && i + 1 < argc) {
+			numTerms = parseInteger<int>(argv[++i]);
+			if (*numTerms < 1) {
+				throw std::invalid_argument("Must add up at least one entry");
+			}
+		} else if (arg == ALL_FLAG) {
+			findAll = true;
+		} else if (arg == QUERIES_FLAG && i + 1 < argc) {
+			queriesFilename = argv[++i];
+		} else if (arg == SEARCH_THREADS_FLAG && i + 1 < argc) {
+			numSearchThreads = parseInteger<int>(argv[++i]);
+			if (numSearchThreads < 1) {
+				throw std::invalid_argument("Must search on at least one thread");
 			}
+		} else {
+			withCache = withCache || arg == CACHE_FLAG;
+			remainingArgs.push_back(argv[i]);
 		}
 	}
 
-	throw std::runtime_error("Does not contain solution");
+	KSumQuery query(target, numTerms, findAll, queriesFilename, numSearchThreads);
+	if (queriesFilename && (target != TARGET_NUM || numTerms || findAll || numSearchThreads != 1)) {
+		throw std::invalid_argument(std::string(QUERIES_FLAG) + " can't be combined with the other queries");
+	} else if (withCache && !query.isPuzzleQuery()) {
+		// The cache is keyed by the input, so it would hand back the answers to whichever query was cached first
+		throw std::invalid_argument(std::string(CACHE_FLAG) + " can only be used for the puzzle's own query");
+	}
+
+	return query;
 }
 
-int main(int argc, const char *argv[]) {
-	if (argc != 2) {
-		std::cerr << "./day1 <input_file>" << std::endl;
+/**
+ * Solve both parts of an embedded input at compile time, with the same semantics as KSumEngine
+ * @tparam NumLines The number of lines in the input
+ * @param input The puzzle input
+ * @return std::array<long, 2> The answer to each part
+ */
+template <std::size_t NumLines>
+constexpr std::array<long, 2> solveConstexpr(std::string_view input) {
+	EntryList<NumLines> inputs;
+	forEachLineConstexpr(input, [&inputs](std::string_view line) { inputs.insert(parseIntegerConstexpr<long>(line)); });
+
+	return {inputs.template findProduct<2>(), inputs.template findProduct<3>()};
+}
+
+}  // namespace day1
+
+#ifndef AOC_NO_MAIN
+#ifdef AOC_EMBEDDED_INPUT
+#include AOC_EMBEDDED_INPUT
+
+int main() {
+	// Both answers are found while compiling, so all that's left is to print them
+	constexpr auto answers = day1::solveConstexpr<countLinesConstexpr(EMBEDDED_INPUT)>(EMBEDDED_INPUT);
+	return printEmbeddedAnswers(answers);
+}
+#else
+int main(int argc, char *argv[]) {
+	std::vector<char *> remainingArgs;
+	try {
+		day1::activeQuery = day1::parseQueryOptions(argc, argv, remainingArgs);
+	} catch (const std::exception &e) {
+		std::cerr << e.what() << std::endl;
+		std::cerr << argv[0] << " [" << day1::TARGET_FLAG << " n] [" << day1::NUM_TERMS_FLAG << " k] ["
+				  << day1::ALL_FLAG << "] [" << day1::SEARCH_THREADS_FLAG << " n] "
+				  << "<options and inputs, as for every day>..." << std::endl;
+		std::cerr << argv[0] << " " << day1::QUERIES_FLAG << " <target_file> [" << JOBS_FLAG << " n] <input_file>"
+				  << std::endl;
+		return 1;
+	}
+
+	if (!day1::activeQuery.getQueriesFilename()) {
+		return runSolver(remainingArgs.size(), remainingArgs.data(), day1::solve);
+	}
+
+	try {
+		RunOptions options = RunOptions::parse(remainingArgs.size(), remainingArgs.data());
+		if (options.getPositional().size() != 1 || options.getWithTimings() || options.getCacheDirectory()
+			|| options.getTraceFilename()) {
+			throw std::invalid_argument(
+				std::string(day1::QUERIES_FLAG) + " takes a single input file, and no options but " + JOBS_FLAG);
+		}
+
+		// The entries are indexed once, and every target is answered against them
+		day1::EntryIndex index(day1::parseInput(MappedInput(options.getPositional().front()).getContents()));
+		MappedInput queries(*day1::activeQuery.getQueriesFilename());
+		std::vector<long> targets = parseIntegers<long>(queries.getContents());
+		day1::answerTargets(std::cout, index, targets, options.getNumJobs());
+	} catch (const std::exception &e) {
+		std::cerr << e.what() << std::endl;
 		return 1;
 	}
 
-	std::set<int> inputs = readInput(argv[1]);
-	std::cout << part1(inputs) << std::endl;
-	std::cout << part2(inputs) << std::endl;
+	return 0;
 }
+#endif
+#endif
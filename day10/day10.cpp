@@ -1,41 +1,30 @@
-#include <folly/String.h>
-
 #include <algorithm>
-#include <fstream>
 #include <iostream>
 #include <list>
 #include <map>
 #include <numeric>
 #include <queue>
 #include <set>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
-constexpr auto MAX_VOLTAGE_DELTA = 3;
+#include "../common/input.hpp"
+#include "../common/integers.hpp"
+#include "../common/solver.hpp"
+#include "../common/trace.hpp"
 
-std::vector<std::string> readInput(const std::string &filename) {
-	std::vector<std::string> input;
-	std::string line;
-	std::ifstream file(filename);
-	while (std::getline(file, line)) {
-		input.push_back(line);
-	}
+namespace day10 {
 
-	return input;
-}
+constexpr auto MAX_VOLTAGE_DELTA = 3;
 
 /**
- * Convert a vector of strings to a vector of numbers
+ * Convert the input to a vector of numbers
  * @param input The input for the puzzle
  * @return std::vector<int> The puzzle input as numbers
  */
-std::vector<int> convertInputToNumbers(const std::vector<std::string> &input) {
-	std::vector<int> converted;
-	converted.reserve(input.size());
-	std::transform(input.cbegin(), input.cend(), std::back_inserter(converted), [](const std::string &line) {
-		return std::stol(line);
-	});
-
-	return converted;
+std::vector<int> convertInputToNumbers(std::string_view input) {
+	return parseIntegers<int>(input);
 }
 
 /**
@@ -49,6 +38,9 @@ void prepareInput(std::vector<int> &input) {
 	std::sort(input.begin(), input.end());
 }
 
+// Traces the calls of solvePart2WithGraph, with --trace
+TracedFunction solvePart2WithGraphTrace("solvePart2WithGraph");
+
 /**
  * Finds the number of paths from the given source node to the target (the end of the adapters lsit)
  * Based on algorithm from:
@@ -59,6 +51,7 @@ void prepareInput(std::vector<int> &input) {
  * @return long
  */
 long solvePart2WithGraph(const std::vector<int> &adapters, std::unordered_map<int, long> &numPaths, int source = 0) {
+	RecursiveTraceSpan traceSpan(solvePart2WithGraphTrace);
 	int target = adapters.size() - 1;
 	if (source == target) {
 		return 1;
@@ -103,15 +96,18 @@ long part2(const std::vector<int> &input) {
 	return solvePart2WithGraph(adapters, counts);
 }
 
-int main(int argc, char *argv[]) {
-	if (argc != 2) {
-		std::cerr << argv[0] << " <input_file>" << std::endl;
-		return 1;
-	}
+void solve(PhaseRunner &runner, const MappedInput &input) {
+	auto numericInput = runner.phase("parse", [&input]() { return convertInputToNumbers(input.getContents()); });
+	runner.answers(
+		{"part1", "part2"},
+		[&numericInput]() { return part1(numericInput); },
+		[&numericInput]() { return part2(numericInput); });
+}
 
-	auto input = readInput(argv[1]);
-	auto numericInput = convertInputToNumbers(input);
+}  // namespace day10
 
-	std::cout << part1(numericInput) << std::endl;
-	std::cout << part2(numericInput) << std::endl;
+#ifndef AOC_NO_MAIN
+int main(int argc, char *argv[]) {
+	return runSolver(argc, argv, day10::solve);
 }
+#endif
@@ -1,57 +1,23 @@
 #include <algorithm>
-#include <fstream>
 #include <iostream>
 #include <numeric>
 #include <optional>
+#include <string>
+#include <string_view>
 #include <vector>
 
+#include "../common/automaton.hpp"
+#include "../common/input.hpp"
+#include "../common/solver.hpp"
+
+namespace day11 {
+
 constexpr char EMPTY_CHAR = 'L';
 constexpr char FLOOR_CHAR = '.';
 constexpr char OCCUPIED_CHAR = '#';
 constexpr int PART_1_OCCUPIED_THRESHOLD = 4;
 constexpr int PART_2_OCCUPIED_THRESHOLD = 5;
 
-std::vector<std::string> readInput(const std::string &filename) {
-	std::vector<std::string> input;
-	std::string line;
-	std::ifstream file(filename);
-	while (std::getline(file, line)) {
-		input.push_back(line);
-	}
-
-	return input;
-}
-
-/**
- * Get all of the neighbors for part 1
- * @param state The state of the board
- * @param row The row to get neighbors for
- * @param column The column to get neighbors for
- * @return std::vector<char> The neighbors of this position
- */
-std::vector<char> getPart1Neighbors(const std::vector<std::string> &state, int row, int column) {
-	std::vector<char> neighbors;
-	for (int dRow = -1; dRow <= 1; dRow++) {
-		for (int dCol = -1; dCol <= 1; dCol++) {
-			if (dRow == 0 && dCol == 0) {
-				continue;
-			}
-
-			int candidateRow = row + dRow;
-			int candidateCol = column + dCol;
-			if (candidateRow < 0 || candidateRow >= state.size() || candidateCol < 0 ||
-				candidateCol >= state.at(candidateRow).size()) {
-				continue;
-			}
-
-			char neighbor = state.at(candidateRow).at(candidateCol);
-			neighbors.push_back(neighbor);
-		}
-	}
-
-	return neighbors;
-}
-
 template <typename T>
 int sign(T val) {
 	// Taken from https://stackoverflow.com/questions/1903954/is-there-a-standard-sign-function-signum-sgn-in-c-c
@@ -70,69 +36,75 @@ void extendRay(std::pair<T, T> &ray) {
 }
 
 /**
- * Cast the given ray until we hit a neighbor that is a seat
- * @param state The current board state
+ * Cast the given ray until we hit a seat
+ * @param input The input for the puzzle
  * @param origin Where to start the ray from
  * @param ray The ray to extend until it hits a seat
- * @return optional<char> An optional of the neighbor that was hit. If none, this extended off the board.
+ * @return std::optional<std::pair<int, int>> The position of the seat that was hit. If none, this extended off the
+ * board.
  */
-std::optional<char> castRayToSeat(
-	const std::vector<std::string> &state, const std::pair<int, int> &origin, const std::pair<int, int> &ray) {
+std::optional<std::pair<int, int>> castRayToSeat(
+	const std::vector<std::string_view> &input, const std::pair<int, int> &origin, const std::pair<int, int> &ray) {
 	std::pair<int, int> rayCursor(ray);
-	char neighbor;
 	// Keep projecting our ray until we hit a seat
-	while (neighbor != OCCUPIED_CHAR && neighbor != EMPTY_CHAR) {
+	while (true) {
 		int candidateRow = origin.first + rayCursor.first;
 		int candidateCol = origin.second + rayCursor.second;
-		if (candidateRow < 0 || candidateRow >= state.size() || candidateCol < 0 ||
-			candidateCol >= state.at(candidateRow).size()) {
-			return std::optional<char>();
+		if (candidateRow < 0 || candidateRow >= input.size() || candidateCol < 0 ||
+			candidateCol >= input.at(candidateRow).size()) {
+			return std::nullopt;
+		}
+
+		if (input.at(candidateRow).at(candidateCol) != FLOOR_CHAR) {
+			return std::make_pair(candidateRow, candidateCol);
 		}
 
-		neighbor = state.at(candidateRow).at(candidateCol);
 		extendRay(rayCursor);
 	}
-
-	return std::optional<char>(neighbor);
 }
 
 /**
- * Get all of the neighbors for part 2
- * @param state The state of the board
- * @param row The row to get neighbors for
- * @param column The column to get neighbors for
- * @return std::vector<char> The neighbors of this position
+ * Find the seats that can be seen from each seat, for part 2. The floor never changes, so neither do these.
+ * @param input The input for the puzzle
+ * @return std::vector<std::vector<int>> For each position (in row-major order), the positions of the seats that can be
+ * seen from it, in the same order. Positions that are floor see nothing.
  */
-std::vector<char> getPart2Neighbors(const std::vector<std::string> &state, int row, int column) {
-	std::pair<int, int> rayOrigin(row, column);
-	std::vector<char> neighbors;
-	for (int dRow = -1; dRow <= 1; dRow++) {
-		for (int dCol = -1; dCol <= 1; dCol++) {
-			if (dRow == 0 && dCol == 0) {
+std::vector<std::vector<int>> findVisibleSeats(const std::vector<std::string_view> &input) {
+	int width = input.at(0).size();
+	std::vector<std::vector<int>> visibleSeats(input.size() * width);
+	for (int row = 0; row < input.size(); row++) {
+		for (int col = 0; col < width; col++) {
+			if (input.at(row).at(col) == FLOOR_CHAR) {
 				continue;
 			}
 
-			std::pair<int, int> deltaRay(dRow, dCol);
-			std::optional<char> neighbor = castRayToSeat(state, rayOrigin, deltaRay);
-			if (neighbor.has_value()) {
-				neighbors.push_back(*neighbor);
+			std::pair<int, int> rayOrigin(row, col);
+			for (int dRow = -1; dRow <= 1; dRow++) {
+				for (int dCol = -1; dCol <= 1; dCol++) {
+					if (dRow == 0 && dCol == 0) {
+						continue;
+					}
+
+					std::optional<std::pair<int, int>> seat = castRayToSeat(input, rayOrigin, std::make_pair(dRow, dCol));
+					if (seat) {
+						visibleSeats.at(row * width + col).push_back(seat->first * width + seat->second);
+					}
+				}
 			}
 		}
 	}
 
-	return neighbors;
+	return visibleSeats;
 }
 
 /**
  * Apply the automata rules to a single seat
- * @param neighbors The neighbors of the location to check
+ * @param numOccupied The number of occupied seats around the seat
  * @param seatState The state of the seat to check
  * @param occupiedThreshold How many seats must be occupied surrounding the location to the seat
  * @return char The new state for this position
  */
-char applyRules(const std::vector<char> &neighbors, char seatState, int occupiedThreshold) {
-	int numOccupied =
-		std::count_if(neighbors.begin(), neighbors.end(), [](char neighbor) { return neighbor == OCCUPIED_CHAR; });
+char applyRules(int numOccupied, char seatState, int occupiedThreshold) {
 	if (seatState == EMPTY_CHAR && numOccupied == 0) {
 		return OCCUPIED_CHAR;
 	} else if (seatState == OCCUPIED_CHAR && numOccupied >= occupiedThreshold) {
@@ -142,51 +114,67 @@ char applyRules(const std::vector<char> &neighbors, char seatState, int occupied
 	}
 }
 
-/**
- * Run the simulation to completion
- * @param input The input for the puzzle
- * @param occupiedThreshold The number of seats that need to be occupied surrounding a seat to empty it
- * @param getNeighbors A function to get the neighbors surrounding a position
- * @return int The puzzle answer
- */
-int runSimulation(
-	const std::vector<std::string> &input, int occupiedThreshold,
-	std::function<std::vector<char>(const std::vector<std::string>, int, int)> getNeighbors) {
-	std::vector<std::string> state(input);
-	std::vector<std::string> nextState(input.size(), std::string(input.at(0).size(), ' '));
-	while (state != nextState) {
+int part1(const std::vector<std::string_view> &input) {
+	// Part 1 is a life-like automaton, where the floor is the only thing that can never be occupied. Seats become
+	// occupied with no occupied neighbors, and stay that way with fewer than PART_1_OCCUPIED_THRESHOLD.
+	std::vector<int> survivalCounts(PART_1_OCCUPIED_THRESHOLD);
+	std::iota(survivalCounts.begin(), survivalCounts.end(), 0);
+	CellularAutomaton<2> automaton(
+		{static_cast<int>(input.size()), static_cast<int>(input.at(0).size())},
+		Topology<2>::moore(),
+		AutomatonRule({0}, std::move(survivalCounts)));
+	for (int row = 0; row < input.size(); row++) {
+		for (int col = 0; col < input.at(row).size(); col++) {
+			char seat = input.at(row).at(col);
+			automaton.setLivable({row, col}, seat != FLOOR_CHAR);
+			automaton.setAlive({row, col}, seat == OCCUPIED_CHAR);
+		}
+	}
+
+	automaton.stepUntilStable();
+
+	return automaton.countAlive();
+}
+
+int part2(const std::vector<std::string_view> &input) {
+	// Seeing past the floor means neighbors can be arbitrarily far apart, which doesn't fit in a fixed topology, so this
+	// works from the seats each seat can see instead
+	std::vector<std::vector<int>> visibleSeats = findVisibleSeats(input);
+	std::vector<char> state;
+	for (std::string_view row : input) {
+		state.insert(state.end(), row.cbegin(), row.cend());
+	}
+
+	std::vector<char> nextState(state.size());
+	bool changed = true;
+	while (changed) {
+		changed = false;
 		for (int i = 0; i < state.size(); i++) {
-			for (int j = 0; j < input.at(i).size(); j++) {
-				std::vector<char> neighbors = getNeighbors(state, i, j);
-				char res = applyRules(neighbors, state.at(i).at(j), occupiedThreshold);
-				nextState.at(i).at(j) = res;
-			}
+			const std::vector<int> &neighbors = visibleSeats.at(i);
+			int numOccupied = std::count_if(
+				neighbors.cbegin(), neighbors.cend(), [&state](int neighbor) { return state[neighbor] == OCCUPIED_CHAR; });
+			nextState.at(i) = applyRules(numOccupied, state.at(i), PART_2_OCCUPIED_THRESHOLD);
+			changed |= nextState.at(i) != state.at(i);
 		}
 
 		std::swap(state, nextState);
 	}
 
-	return std::accumulate(state.cbegin(), state.cend(), 0, [](int total, const std::string &row) {
-		return total + std::count_if(row.cbegin(), row.cend(), [](char item) { return item == OCCUPIED_CHAR; });
-	});
+	return std::count(state.cbegin(), state.cend(), OCCUPIED_CHAR);
 }
 
-int part1(const std::vector<std::string> &input) {
-	return runSimulation(input, PART_1_OCCUPIED_THRESHOLD, getPart1Neighbors);
+void solve(PhaseRunner &runner, const MappedInput &input) {
+	auto lines = runner.phase("parse", [&input]() { return input.getLines(); });
+	runner.answers(
+		{"part1", "part2"},
+		[&lines]() { return part1(lines); },
+		[&lines]() { return part2(lines); });
 }
 
-int part2(const std::vector<std::string> &input) {
-	return runSimulation(input, PART_2_OCCUPIED_THRESHOLD, getPart2Neighbors);
-}
+}  // namespace day11
 
+#ifndef AOC_NO_MAIN
 int main(int argc, char *argv[]) {
-	if (argc != 2) {
-		std::cerr << argv[0] << " <input_file>" << std::endl;
-		return 1;
-	}
-
-	auto input = readInput(argv[1]);
-
-	std::cout << part1(input) << std::endl;
-	std::cout << part2(input) << std::endl;
+	return runSolver(argc, argv, day11::solve);
 }
+#endif
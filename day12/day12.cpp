@@ -1,11 +1,17 @@
 #include <algorithm>
 #include <charconv>
-#include <fstream>
 #include <iostream>
 #include <numeric>
 #include <optional>
+#include <string_view>
 #include <vector>
 
+#include "../common/input.hpp"
+#include "../common/solver.hpp"
+#include "../common/stream.hpp"
+
+namespace day12 {
+
 constexpr int NUM_DIRECTIONS = 4;
 enum CardinalDirection { NORTH = 0, EAST = 1, SOUTH = 2, WEST = 3 };
 
@@ -117,15 +123,21 @@ class MovablePoint {
 	std::pair<int, int> position;
 };
 
-std::vector<std::string> readInput(const std::string &filename) {
-	std::vector<std::string> input;
-	std::string line;
-	std::ifstream file(filename);
-	while (std::getline(file, line)) {
-		input.push_back(line);
+/**
+ * Parse a single line of the input
+ * @param line The line to parse
+ * @return std::pair<char, int> A pair of <directive, magnitude>
+ */
+std::pair<char, int> parseMove(std::string_view line) {
+	char direction = line.at(0);
+	auto rawMagnitude = line.substr(1);
+	int magnitude;
+	auto parseResult = std::from_chars(rawMagnitude.data(), rawMagnitude.data() + rawMagnitude.size(), magnitude);
+	if (parseResult.ec == std::errc::invalid_argument) {
+		throw std::invalid_argument("Invalid input");
 	}
 
-	return input;
+	return std::pair<char, int>(direction, magnitude);
 }
 
 /**
@@ -133,19 +145,11 @@ std::vector<std::string> readInput(const std::string &filename) {
  * @param input The puzzle input
  * @return std::vector<std::pair<char, int>> A vector of pairs of <directive, magnitude>
  */
-std::vector<std::pair<char, int>> parseInput(const std::vector<std::string> &input) {
+std::vector<std::pair<char, int>> parseInput(const std::vector<std::string_view> &input) {
 	std::vector<std::pair<char, int>> parsedInput;
 	parsedInput.reserve(input.size());
 	for (std::string_view line : input) {
-		char direction = line.at(0);
-		auto rawMagnitude = line.substr(1);
-		int magnitude;
-		auto parseResult = std::from_chars(rawMagnitude.data(), rawMagnitude.data() + rawMagnitude.size(), magnitude);
-		if (parseResult.ec == std::errc::invalid_argument) {
-			throw std::invalid_argument("Invalid input");
-		}
-
-		parsedInput.push_back(std::pair<char, int>(direction, magnitude));
+		parsedInput.push_back(parseMove(line));
 	}
 
 	return parsedInput;
@@ -243,15 +247,40 @@ int part2(const std::vector<std::pair<char, int>> &input) {
 	return abs(ship.getPosition().first) + abs(ship.getPosition().second);
 }
 
-int main(int argc, char *argv[]) {
-	if (argc != 2) {
-		std::cerr << argv[0] << " <input_file>" << std::endl;
-		return 1;
-	}
+void solve(PhaseRunner &runner, const MappedInput &input) {
+	auto parsedInput = runner.phase("parse", [&input]() { return parseInput(input.getLines()); });
+	runner.answers(
+		{"part1", "part2"},
+		[&parsedInput]() { return part1(parsedInput); },
+		[&parsedInput]() { return part2(parsedInput); });
+}
+
+void solveStream(PhaseRunner &runner, LineStream &stream) {
+	// Both parts' ships can be moved as each move is read, so only their final positions need to be kept
+	auto finalPositions = runner.phase("stream", [&stream]() {
+		MovablePoint part1Ship(EAST, std::pair<int, int>(0, 0));
+		MovablePoint part2Ship(EAST, std::pair<int, int>(0, 0));
+		MovablePoint waypoint(EAST, std::pair<int, int>(10, 1));
+		stream.forEachLine([&](std::string_view line) {
+			std::pair<char, int> move = parseMove(line);
+			moveShip(part1Ship, move);
+			moveShipOrWaypoint(part2Ship, waypoint, move);
+		});
 
-	auto input = readInput(argv[1]);
-	auto parsedInput = parseInput(input);
+		return std::make_pair(part1Ship.getPosition(), part2Ship.getPosition());
+	});
+	runner.answer("part1", [&finalPositions]() {
+		return abs(finalPositions.first.first) + abs(finalPositions.first.second);
+	});
+	runner.answer("part2", [&finalPositions]() {
+		return abs(finalPositions.second.first) + abs(finalPositions.second.second);
+	});
+}
+
+}  // namespace day12
 
-	std::cout << part1(parsedInput) << std::endl;
-	std::cout << part2(parsedInput) << std::endl;
+#ifndef AOC_NO_MAIN
+int main(int argc, char *argv[]) {
+	return runSolver(argc, argv, day12::solve, day12::solveStream);
 }
+#endif
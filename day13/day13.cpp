@@ -1,26 +1,22 @@
 #include <folly/String.h>
 
 #include <algorithm>
+#include <array>
 #include <cassert>
-#include <charconv>
-#include <fstream>
 #include <iostream>
 #include <map>
 #include <numeric>
+#include <string_view>
 #include <vector>
 
-constexpr auto OUT_OF_SERVICE_BUS = "x";
+#include "../common/embedded.hpp"
+#include "../common/input.hpp"
+#include "../common/integers.hpp"
+#include "../common/solver.hpp"
 
-std::vector<std::string> readInput(const std::string &filename) {
-	std::vector<std::string> input;
-	std::string line;
-	std::ifstream file(filename);
-	while (std::getline(file, line)) {
-		input.push_back(line);
-	}
+namespace day13 {
 
-	return input;
-}
+constexpr auto OUT_OF_SERVICE_BUS = "x";
 
 /**
  * Parse a split list of bus times into a vector of pairs of the form <busLeaveTime, offset>
@@ -38,7 +34,7 @@ std::vector<std::pair<int, int>> parseBusTimes(const std::vector<std::string> &r
 			continue;
 		}
 
-		int busTime = std::stoi(rawBusTime);
+		int busTime = parseInteger<int>(rawBusTime);
 		busTimes.emplace_back(busTime, nextBusOffsset);
 	}
 
@@ -50,9 +46,11 @@ std::vector<std::pair<int, int>> parseBusTimes(const std::vector<std::string> &r
  * @param input The input to parse
  * @return std::pair<int, std::vector<std::pair<int, int>>> A pair of the form <busLeaveTime, <busLeaveTime, offset>>
  */
-std::pair<int, std::vector<std::pair<int, int>>> parseInput(const std::vector<std::string> &input) {
-	int startTime = std::stoi(input.at(0));
-	const std::string &rawBusses = input.at(1);
+std::pair<int, std::vector<std::pair<int, int>>> parseInput(const std::vector<std::string_view> &input) {
+	std::string_view rawStartTime = input.at(0);
+	int startTime = parseInteger<int>(rawStartTime);
+
+	std::string_view rawBusses = input.at(1);
 	std::vector<std::string> rawBusTimes;
 	folly::split(",", rawBusses, rawBusTimes);
 
@@ -61,6 +59,35 @@ std::pair<int, std::vector<std::pair<int, int>>> parseInput(const std::vector<st
 	return std::pair<int, std::vector<std::pair<int, int>>>(startTime, parsedBusTimes);
 }
 
+/**
+ * Find the first time that a bus leaves at or after the start time
+ * @param busStartTime The earliest time to leave
+ * @param busID The ID of the bus, which is also how often it leaves
+ * @return int The time the bus next leaves
+ */
+constexpr int findNextBusTime(int busStartTime, int busID) {
+	// Take the ceiling when dividing
+	int numIntervals = (busID + busStartTime - 1) / busID;
+
+	return busID * numIntervals;
+}
+
+/**
+ * Given the earliest time at which every bus so far leaves at its offset, find the earliest at which the next one does
+ * as well
+ * @param t The earliest time that lines up every bus so far, which is advanced to line up the next bus too
+ * @param stepSize How often the buses so far line up again, which is updated to include the next bus
+ * @param busTime The next bus, of the form <busLeaveTime, offset>
+ */
+constexpr void alignNextBus(long &t, long &stepSize, const std::pair<int, int> &busTime) {
+	// Find the time that next bus that will start at the offset after t
+	do {
+		t += stepSize;
+	} while ((t + busTime.second) % busTime.first != 0);
+
+	stepSize = std::lcm(stepSize, static_cast<long>(busTime.first));
+}
+
 int part1(int busStartTime, const std::vector<std::pair<int, int>> &busTimes) {
 	// Calculate the bus times that are immediately after the start time input
 	std::map<int, int> nextBusses;
@@ -69,11 +96,7 @@ int part1(int busStartTime, const std::vector<std::pair<int, int>> &busTimes) {
 		busTimes.cend(),
 		std::inserter(nextBusses, nextBusses.end()),
 		[busStartTime](const std::pair<int, int> &busTime) {
-			// Take the ceiling when dividing
-			int numIntervals = (busTime.first + busStartTime - 1) / busTime.first;
-			int nextBusTime = busTime.first * numIntervals;
-
-			return std::pair<int, int>(busTime.first, nextBusTime);
+			return std::pair<int, int>(busTime.first, findNextBusTime(busStartTime, busTime.first));
 		});
 
 	auto minPairIterator = std::min_element(
@@ -93,29 +116,84 @@ long part2(const std::vector<std::pair<int, int>> &busTimes) {
 	long t = cursor->first;
 	long stepSize = cursor->first;
 	cursor++;
-	while (cursor != busTimes.cend()) {
-		t += stepSize;
-		// Find the time that next bus that will start at the offset after t
-		if ((t + cursor->second) % cursor->first != 0) {
+	for (; cursor != busTimes.cend(); cursor++) {
+		alignNextBus(t, stepSize, *cursor);
+	}
+
+	return t;
+}
+
+void solve(PhaseRunner &runner, const MappedInput &input) {
+	auto parsedInput = runner.phase("parse", [&input]() { return parseInput(input.getLines()); });
+	runner.answers(
+		{"part1", "part2"},
+		[&parsedInput]() { return part1(parsedInput.first, parsedInput.second); },
+		[&parsedInput]() { return part2(parsedInput.second); });
+}
+
+/**
+ * Solve both parts of an embedded input at compile time. The busses are handled one at a time as they are parsed, since
+ * there's nowhere to keep them all at compile time.
+ * @param input The puzzle input
+ * @return std::array<long, 2> The answer to each part
+ */
+constexpr std::array<long, 2> solveConstexpr(std::string_view input) {
+	auto [rawStartTime, rawBusses] = splitLinesConstexpr<2>(input);
+	int busStartTime = parseIntegerConstexpr<int>(rawStartTime);
+	// Of the busses that leave first, part 1 picks the one with the lowest ID, as the map in part1 does
+	int bestBusID = 0;
+	int bestBusTime = 0;
+	long t = 0;
+	long stepSize = 0;
+	int offset = 0;
+	for (std::string_view::size_type cursor = 0; cursor <= rawBusses.size(); offset++) {
+		auto comma = rawBusses.find(',', cursor);
+		if (comma == std::string_view::npos) {
+			comma = rawBusses.size();
+		}
+
+		std::string_view rawBusTime = rawBusses.substr(cursor, comma - cursor);
+		cursor = comma + 1;
+		if (rawBusTime == OUT_OF_SERVICE_BUS) {
 			continue;
 		}
 
-		stepSize = std::lcm(stepSize, cursor->first);
-		cursor++;
+		std::pair<int, int> busTime(parseIntegerConstexpr<int>(rawBusTime), offset);
+		int nextBusTime = findNextBusTime(busStartTime, busTime.first);
+		if (bestBusID == 0 || nextBusTime < bestBusTime || (nextBusTime == bestBusTime && busTime.first < bestBusID)) {
+			bestBusID = busTime.first;
+			bestBusTime = nextBusTime;
+		}
+
+		if (stepSize == 0) {
+			t = busTime.first;
+			stepSize = busTime.first;
+		} else {
+			alignNextBus(t, stepSize, busTime);
+		}
 	}
 
-	return t;
+	if (bestBusID == 0) {
+		throw std::invalid_argument("No busses in service");
+	}
+
+	return {static_cast<long>(bestBusID) * (bestBusTime - busStartTime), t};
 }
 
-int main(int argc, char *argv[]) {
-	if (argc != 2) {
-		std::cerr << argv[0] << " <input_file>" << std::endl;
-		return 1;
-	}
+}  // namespace day13
 
-	auto input = readInput(argv[1]);
-	auto parsedInput = parseInput(input);
+#ifndef AOC_NO_MAIN
+#ifdef AOC_EMBEDDED_INPUT
+#include AOC_EMBEDDED_INPUT
 
-	std::cout << part1(parsedInput.first, parsedInput.second) << std::endl;
-	std::cout << part2(parsedInput.second) << std::endl;
+int main() {
+	// Both answers are found while compiling, so all that's left is to print them
+	constexpr auto answers = day13::solveConstexpr(EMBEDDED_INPUT);
+	return printEmbeddedAnswers(answers);
+}
+#else
+int main(int argc, char *argv[]) {
+	return runSolver(argc, argv, day13::solve);
 }
+#endif
+#endif
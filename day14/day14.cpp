@@ -1,16 +1,23 @@
 #include <algorithm>
 #include <charconv>
-#include <fstream>
 #include <iostream>
 #include <map>
 #include <numeric>
-#include <regex>
 #include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
+#include "../common/input.hpp"
+#include "../common/pattern.hpp"
+#include "../common/solver.hpp"
+
+namespace day14 {
+
 constexpr char IGNORE_CHAR = 'X';
-constexpr auto MASK_PATTERN = R"(mask = ([X0-9]+))";
-constexpr auto MEM_PATTERN = R"(mem\[(\d+)\] = (\d+))";
+constexpr char MASK_PATTERN[] = "mask = {str}";
+constexpr char MEM_PATTERN[] = "mem[{int}] = {int}";
 
 /**
  * Represents a block of instructions with a given mask
@@ -110,42 +117,27 @@ class InstructionBlock {
 	}
 };
 
-std::vector<std::string> readInput(const std::string &filename) {
-	std::vector<std::string> input;
-	std::string line;
-	std::ifstream file(filename);
-	while (std::getline(file, line)) {
-		input.push_back(line);
-	}
-
-	return input;
-}
-
 /**
  * Parse the input into InstructionBlocks
  * @param input The input to parse
  * @return std::vector<InstructionBlock> The parsed input
  */
-std::vector<InstructionBlock> parseInput(const std::vector<std::string> &input) {
+std::vector<InstructionBlock> parseInput(const std::vector<std::string_view> &input) {
 	std::vector<InstructionBlock> blocks;
-	std::regex maskExpression(MASK_PATTERN);
-	std::regex memExpression(MEM_PATTERN);
 	std::string currentMask;
 	std::vector<std::pair<int, int>> currentStoreInstructions;
 	for (auto it = input.cbegin(); it != input.cend(); it++) {
-		auto line = *it;
-		std::smatch matches;
-		if (std::regex_match(line, matches, maskExpression)) {
+		std::string_view line = *it;
+		if (auto mask = LinePattern<MASK_PATTERN>::match(line)) {
 			// We don't want to emplace on the first mask we find
 			if (it != input.cbegin()) {
 				blocks.emplace_back(std::move(currentMask), std::move(currentStoreInstructions));
 				currentStoreInstructions.clear();
 			}
 
-			currentMask = matches[1];
-		} else if (std::regex_match(line, matches, memExpression)) {
-			int address = std::stoi(matches[1]);
-			int value = std::stoi(matches[2]);
+			currentMask = std::get<0>(*mask);
+		} else if (auto store = LinePattern<MEM_PATTERN>::match(line)) {
+			auto [address, value] = *store;
 			currentStoreInstructions.emplace_back(address, value);
 		}
 	}
@@ -187,15 +179,18 @@ long long part2(const std::vector<InstructionBlock> &instructions) {
 		});
 }
 
-int main(int argc, char *argv[]) {
-	if (argc != 2) {
-		std::cerr << argv[0] << " <input_file>" << std::endl;
-		return 1;
-	}
+void solve(PhaseRunner &runner, const MappedInput &input) {
+	auto parsedInput = runner.phase("parse", [&input]() { return parseInput(input.getLines()); });
+	runner.answers(
+		{"part1", "part2"},
+		[&parsedInput]() { return part1(parsedInput); },
+		[&parsedInput]() { return part2(parsedInput); });
+}
 
-	auto input = readInput(argv[1]);
-	auto parsedInput = parseInput(input);
+}  // namespace day14
 
-	std::cout << part1(parsedInput) << std::endl;
-	std::cout << part2(parsedInput) << std::endl;
+#ifndef AOC_NO_MAIN
+int main(int argc, char *argv[]) {
+	return runSolver(argc, argv, day14::solve);
 }
+#endif
@@ -1,37 +1,30 @@
-#include <folly/String.h>
-
-#include <fstream>
+#include <algorithm>
 #include <iostream>
 #include <map>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
-std::vector<std::string> readInput(const std::string &filename) {
-	std::vector<std::string> input;
-	std::string line;
-	std::ifstream file(filename);
-	while (std::getline(file, line)) {
-		input.push_back(line);
-	}
-
-	return input;
-}
+#include "../common/arena.hpp"
+#include "../common/input.hpp"
+#include "../common/integers.hpp"
+#include "../common/solver.hpp"
 
-std::vector<int> parseStartingNumbers(const std::vector<std::string> &input) {
-	std::vector<std::string> rawNumbers;
-	folly::split(",", input.at(0), rawNumbers);
-	std::vector<int> startingNumbers;
+namespace day15 {
 
-	std::transform(
-		rawNumbers.cbegin(), rawNumbers.cend(), std::back_inserter(startingNumbers), [](const std::string &rawNumber) {
-			return std::stoi(rawNumber);
-		});
+// Maps each number to the last turn it was spoken on. With tens of millions of turns, there are millions of entries,
+// whose nodes are kept together on huge pages, rather than spread over the heap.
+using TurnMap =
+	std::unordered_map<int, int, std::hash<int>, std::equal_to<int>, ArenaAllocator<std::pair<const int, int>>>;
 
-	return startingNumbers;
+std::vector<int> parseStartingNumbers(const std::vector<std::string_view> &input) {
+	return parseIntegers<int>(input.at(0));
 }
 
 int solve(const std::vector<int> &startingNumbers, int num_turns) {
-	std::unordered_map<int, int> turnSpoken;
+	HugePageArena arena;
+	TurnMap turnSpoken{TurnMap::allocator_type(arena)};
 	int lastNumber = startingNumbers.back();
 	// Skip past the starting numbers< put them at the proper place
 	for (std::vector<int>::size_type turn = 1; turn < startingNumbers.size(); turn++) {
@@ -52,15 +45,18 @@ int solve(const std::vector<int> &startingNumbers, int num_turns) {
 	return lastNumber;
 }
 
-int main(int argc, char *argv[]) {
-	if (argc != 2) {
-		std::cerr << argv[0] << " <input_file>" << std::endl;
-		return 1;
-	}
+void solve(PhaseRunner &runner, const MappedInput &input) {
+	auto startingNumbers = runner.phase("parse", [&input]() { return parseStartingNumbers(input.getLines()); });
+	runner.answers(
+		{"part1", "part2"},
+		[&startingNumbers]() { return solve(startingNumbers, 2020); },
+		[&startingNumbers]() { return solve(startingNumbers, 30000000); });
+}
 
-	auto input = readInput(argv[1]);
-	auto startingNumbers = parseStartingNumbers(input);
+}  // namespace day15
 
-	std::cout << solve(startingNumbers, 2020) << std::endl;
-	std::cout << solve(startingNumbers, 30000000) << std::endl;
+#ifndef AOC_NO_MAIN
+int main(int argc, char *argv[]) {
+	return runSolver(argc, argv, day15::solve);
 }
+#endif
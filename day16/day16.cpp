@@ -1,18 +1,22 @@
-#include <folly/String.h>
-
-#include <fstream>
 #include <iostream>
 #include <map>
 #include <numeric>
-#include <regex>
 #include <set>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "../common/input.hpp"
+#include "../common/integers.hpp"
+#include "../common/pattern.hpp"
+#include "../common/solver.hpp"
+
+namespace day16 {
+
 constexpr auto NEARBY_TICKETS_HEADER = "nearby tickets:";
 constexpr auto YOUR_TICKET_HEADER = "your ticket:";
 constexpr auto DEPARTURE_PREFIX = "departure";
-constexpr auto FIELD_PATTERN = R"((.*): (\d+)-(\d+) or (\d+)-(\d+))";
+constexpr char FIELD_PATTERN[] = "{str}: {int}-{int} or {int}-{int}";
 
 // This has to be the grossest type signature I've written in a while, but it's of
 // a-b or c-d maps to pair<a, b> or pair<c ,d>
@@ -84,17 +88,6 @@ class TicketSpec {
 	std::vector<TicketField> fields;
 };
 
-std::vector<std::string> readInput(const std::string &filename) {
-	std::vector<std::string> input;
-	std::string line;
-	std::ifstream file(filename);
-	while (std::getline(file, line)) {
-		input.push_back(line);
-	}
-
-	return input;
-}
-
 /**
  * Parse the fields of the ticket specification
  * @tparam Iter The type of iterator to get the fields from
@@ -105,16 +98,18 @@ std::vector<std::string> readInput(const std::string &filename) {
 template <typename Iter>
 std::vector<TicketField> parseFields(Iter start, Iter end) {
 	std::vector<TicketField> fields;
-	std::regex rangeExpression(FIELD_PATTERN);
 	for (auto textIter = start; textIter != end; ++textIter) {
-		std::smatch matches;
-		if (!std::regex_search(*textIter, matches, rangeExpression)) {
+		std::string_view text = *textIter;
+		auto matches = LinePattern<FIELD_PATTERN>::match(text);
+		if (!matches) {
 			throw new std::invalid_argument("Invalid input");
 		}
-		std::pair<int, int> range1(std::stoi(matches[2]), std::stoi(matches[3]));
-		std::pair<int, int> range2(std::stoi(matches[4]), std::stoi(matches[5]));
+
+		auto [name, min1, max1, min2, max2] = *matches;
+		std::pair<int, int> range1(min1, max1);
+		std::pair<int, int> range2(min2, max2);
 		RangeSpec ticketRange(std::move(range1), std::move(range2));
-		fields.emplace_back(matches[1].str(), std::move(ticketRange));
+		fields.emplace_back(std::string(name), std::move(ticketRange));
 	}
 
 	return fields;
@@ -125,11 +120,8 @@ std::vector<TicketField> parseFields(Iter start, Iter end) {
  * @param rawTicket The ticket to parse
  * @return std::vector<int> The ticket's fields
  */
-std::vector<int> parseTicket(const std::string &rawTicket) {
-	std::vector<int> ticket;
-	folly::split(",", rawTicket, ticket);
-
-	return ticket;
+std::vector<int> parseTicket(std::string_view rawTicket) {
+	return parseIntegers<int>(rawTicket);
 }
 
 /**
@@ -155,7 +147,7 @@ std::vector<std::vector<int>> parseNearbyTickets(Iter start, Iter end) {
  * @param input The puzzle input
  * @return TicketSpec The puzzle input as a TicketSpec
  */
-TicketSpec parseInput(const std::vector<std::string> &input) {
+TicketSpec parseInput(const std::vector<std::string_view> &input) {
 	auto fieldsEnd = std::find(input.cbegin(), input.cend(), "");
 	auto yourTicketBegin = std::find(input.cbegin(), input.cend(), YOUR_TICKET_HEADER);
 	auto nearbyTicketsBegin = std::find(input.cbegin(), input.cend(), NEARBY_TICKETS_HEADER);
@@ -290,15 +282,18 @@ long part2(const TicketSpec &ticketSpec) {
 		});
 }
 
-int main(int argc, char *argv[]) {
-	if (argc != 2) {
-		std::cerr << argv[0] << " <input_file>" << std::endl;
-		return 1;
-	}
+void solve(PhaseRunner &runner, const MappedInput &input) {
+	auto parsedInput = runner.phase("parse", [&input]() { return parseInput(input.getLines()); });
+	runner.answers(
+		{"part1", "part2"},
+		[&parsedInput]() { return part1(parsedInput); },
+		[&parsedInput]() { return part2(parsedInput); });
+}
 
-	auto input = readInput(argv[1]);
-	auto parsedInput = parseInput(input);
+}  // namespace day16
 
-	std::cout << part1(parsedInput) << std::endl;
-	std::cout << part2(parsedInput) << std::endl;
+#ifndef AOC_NO_MAIN
+int main(int argc, char *argv[]) {
+	return runSolver(argc, argv, day16::solve);
 }
+#endif
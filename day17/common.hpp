@@ -1,51 +1,50 @@
 #ifndef COMMON_HPP
 #define COMMON_HPP
 
-#include <map>
-#include <numeric>
-#include <tuple>
+#include <string_view>
+#include <vector>
+
+#include "../common/automaton.hpp"
 
 constexpr char ALIVE_CHAR = '#';
 constexpr char DEAD_CHAR = '.';
 constexpr int CYCLE_COUNT = 6;
 
-enum CellState { ALIVE, DEAD };
-
 /**
- * Get the minimum and maximum position where an alive cell exist
- * @tparam Position The type of position to use
- * @tparam componentIndex The index in a position tuple that should be min/maxed
- * @param board The board to check
- * @return std::pair<int, int> The minimum/maximum along the component
+ * Run the pocket dimension through every cycle
+ * @tparam Dimensions The number of dimensions of the pocket dimension. The input is a slice of it, along the last two.
+ * @param input The puzzle input
+ * @return int The number of active cubes after the last cycle
  */
-template <typename PositionTuple, int componentIndex>
-std::pair<int, int> getMinMaxAlivePositionsForComponent(const std::map<PositionTuple, CellState> &board) {
-	std::vector<std::pair<PositionTuple, CellState>> alivePositionTuples;
-	std::copy_if(
-		board.cbegin(),
-		board.cend(),
-		std::back_inserter(alivePositionTuples),
-		[](const std::pair<PositionTuple, CellState> &item) { return item.second == ALIVE; });
-
-	auto elements = std::minmax_element(
-		alivePositionTuples.cbegin(),
-		alivePositionTuples.cend(),
-		[](const std::pair<PositionTuple, CellState> &item, const std::pair<PositionTuple, CellState> &item2) {
-			return std::get<componentIndex>(item.first) < std::get<componentIndex>(item2.first);
-		});
-	int minComponent = std::get<componentIndex>(elements.first->first);
-	int maxComponent = std::get<componentIndex>(elements.second->first);
-
-	return std::pair<int, int>(minComponent, maxComponent);
-}
+template <int Dimensions>
+int runCycles(const std::vector<std::string_view> &input) {
+	// The active cubes can spread at most one cube along each axis per cycle, so leaving that much room on each side of
+	// the input means that none of them can ever reach the edge of the grid
+	typename CellularAutomaton<Dimensions>::Coordinates size;
+	size.fill(1 + 2 * CYCLE_COUNT);
+	size.at(Dimensions - 2) += input.size();
+	size.at(Dimensions - 1) += input.at(0).size();
+
+	CellularAutomaton<Dimensions> automaton(size, Topology<Dimensions>::moore(), AutomatonRule({3}, {2, 3}));
+	for (int row = 0; row < input.size(); row++) {
+		for (int col = 0; col < input.at(row).size(); col++) {
+			if (input.at(row).at(col) != ALIVE_CHAR) {
+				continue;
+			}
+
+			typename CellularAutomaton<Dimensions>::Coordinates position;
+			position.fill(CYCLE_COUNT);
+			position.at(Dimensions - 2) += row;
+			position.at(Dimensions - 1) += col;
+			automaton.setAlive(position);
+		}
+	}
 
-template <typename Key, typename Val>
-Val getOrDefault(const std::map<Key, Val> &map, Val defaultValue, Key key) {
-	if (map.find(key) == map.end()) {
-		return defaultValue;
+	for (int i = 0; i < CYCLE_COUNT; i++) {
+		automaton.step();
 	}
 
-	return map.at(key);
+	return automaton.countAlive();
 }
 
 #endif
@@ -1,12 +1,18 @@
-#include <fstream>
 #include <functional>
 #include <iostream>
 #include <memory>
 #include <numeric>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "../common/input.hpp"
+#include "../common/solver.hpp"
+#include "../common/trace.hpp"
+
+namespace day18 {
+
 enum Operation { ADDITION = '+', MULTIPLICATION = '*', IDENTITY = 'i' };
 class ExpressionNode;
 // A strategy to evaluate the value of a node. Takes the left child, the right child, and the current operation at the
@@ -137,17 +143,6 @@ class ExpressionTree : public ExpressionNode {
 	}
 };
 
-std::vector<std::string> readInput(const std::string &filename) {
-	std::vector<std::string> input;
-	std::string line;
-	std::ifstream file(filename);
-	while (std::getline(file, line)) {
-		input.push_back(line);
-	}
-
-	return input;
-}
-
 /**
  * Parse a string component into an operator
  * @param component The string component to check
@@ -213,6 +208,9 @@ std::optional<std::pair<std::string_view, int>> parseParenthetical(int cursor, c
 	return std::pair<std::string_view, int>(input.substr(startPos + 1, cursor - startPos - 1), startPos);
 }
 
+// Traces the calls of buildTree, with --trace
+TracedFunction buildTreeTrace("buildTree");
+
 /**
  * Build a parse tree
  * @param input The input to build from
@@ -220,6 +218,7 @@ std::optional<std::pair<std::string_view, int>> parseParenthetical(int cursor, c
  * @return std::unique_ptr<ExpressionNode> The root of the tree
  */
 std::unique_ptr<ExpressionNode> buildTree(const std::string_view input, const EvaluationStrategy &strategy) {
+	RecursiveTraceSpan traceSpan(buildTreeTrace);
 	if (std::count_if(input.cbegin(), input.cend(), [](char c) { return c == ' '; }) == 0) {
 		std::optional<long> value = parseNumber(input);
 		if (!value) {
@@ -281,14 +280,14 @@ std::unique_ptr<ExpressionNode> buildTree(const std::string_view input, const Ev
  * @param strategy The strategy to evaluate each node
  * @return long The puzzle result
  */
-long run(const std::vector<std::string> &input, const EvaluationStrategy &strategy) {
-	return std::accumulate(input.cbegin(), input.cend(), 0L, [&strategy](long total, const std::string &expression) {
+long run(const std::vector<std::string_view> &input, const EvaluationStrategy &strategy) {
+	return std::accumulate(input.cbegin(), input.cend(), 0L, [&strategy](long total, std::string_view expression) {
 		auto tree = buildTree(expression, strategy);
 		return total + tree->evaluate();
 	});
 }
 
-long part1(const std::vector<std::string> &input) {
+long part1(const std::vector<std::string_view> &input) {
 	EvaluationStrategy strategy =
 		[](const std::unique_ptr<ExpressionNode> &left, const std::unique_ptr<ExpressionNode> &right, Operation op) {
 			long leftValue = left->evaluate();
@@ -307,7 +306,7 @@ long part1(const std::vector<std::string> &input) {
 	return run(input, strategy);
 }
 
-long part2(const std::vector<std::string> &input) {
+long part2(const std::vector<std::string_view> &input) {
 	EvaluationStrategy strategy = [](const std::unique_ptr<ExpressionNode> &left,
 									 const std::unique_ptr<ExpressionNode> &right,
 									 Operation op) -> long {
@@ -370,14 +369,18 @@ long part2(const std::vector<std::string> &input) {
 	return run(input, strategy);
 }
 
-int main(int argc, char *argv[]) {
-	if (argc != 2) {
-		std::cerr << argv[0] << " <input_file>" << std::endl;
-		return 1;
-	}
+void solve(PhaseRunner &runner, const MappedInput &input) {
+	auto lines = runner.phase("parse", [&input]() { return input.getLines(); });
+	runner.answers(
+		{"part1", "part2"},
+		[&lines]() { return part1(lines); },
+		[&lines]() { return part2(lines); });
+}
 
-	auto input = readInput(argv[1]);
+}  // namespace day18
 
-	std::cout << part1(input) << std::endl;
-	std::cout << part2(input) << std::endl;
+#ifndef AOC_NO_MAIN
+int main(int argc, char *argv[]) {
+	return runSolver(argc, argv, day18::solve);
 }
+#endif
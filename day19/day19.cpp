@@ -1,7 +1,6 @@
 #include <folly/Format.h>
 #include <folly/String.h>
 
-#include <fstream>
 #include <functional>
 #include <iostream>
 #include <map>
@@ -10,8 +9,15 @@
 #include <optional>
 #include <regex>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "../common/input.hpp"
+#include "../common/solver.hpp"
+#include "../common/trace.hpp"
+
+namespace day19 {
+
 constexpr auto RULE_DELIM = ":";
 constexpr auto ALTERNATING_DELIM = " | ";
 constexpr int NUM_RULE_11_CYCLES = 8;
@@ -71,33 +77,6 @@ class GrammarEntry {
 	bool isThisALookup;
 };
 
-std::vector<std::string> readInput(const std::string &filename) {
-	std::vector<std::string> input;
-	std::string line;
-	std::ifstream file(filename);
-	while (std::getline(file, line)) {
-		input.push_back(line);
-	}
-
-	return input;
-}
-
-/**
- * Split the input into grammar and test strings
- *
- * @param input The puzzle input.
- *
- * @return std::pair<std::vector<std::string>, std::vector<std::string>> A pair of the puzzle grammar and the puzzle
- * test strings
- */
-std::pair<std::vector<std::string>, std::vector<std::string>> splitInput(const std::vector<std::string> &input) {
-	auto emptyLine = std::find(input.cbegin(), input.cend(), "");
-	auto beforeEmptyLine = std::vector<std::string>(input.cbegin(), emptyLine);
-	auto afterEmptyLine = std::vector<std::string>(emptyLine + 1, input.cend());
-	return std::pair<std::vector<std::string>, std::vector<std::string>>(
-		std::move(beforeEmptyLine), std::move(afterEmptyLine));
-}
-
 /**
  * Convert a single pattern to a grammar entry
  *
@@ -138,11 +117,11 @@ MultiGrammarEntry parseSinglePattern(const std::string &rawPattern) {
  * @return std::unordered_multimap<int, MultiGrammarEntry> A map of grammar rule indices to grammar entries. Each
  * element of the grammar entry vectors are alternations.
  */
-std::unordered_multimap<int, MultiGrammarEntry> parseGrammar(const std::vector<std::string> &patterns) {
+std::unordered_multimap<int, MultiGrammarEntry> parseGrammar(const std::vector<std::string_view> &patterns) {
 	std::unordered_multimap<int, MultiGrammarEntry> grammar;
-	for (const std::string &patternLine : patterns) {
+	for (std::string_view patternLine : patterns) {
 		auto colonIndex = patternLine.find(RULE_DELIM);
-		std::string rawIndex = patternLine.substr(0, colonIndex);
+		std::string rawIndex(patternLine.substr(0, colonIndex));
 		int patternIndex = std::stoi(rawIndex);
 		std::vector<std::string> rawAlternations;
 		// An extra +1 on the colon index to get rid of the space after the colon
@@ -160,6 +139,9 @@ std::unordered_multimap<int, MultiGrammarEntry> parseGrammar(const std::vector<s
 	return grammar;
 }
 
+// Traces the calls of convertToRegularExpression, with --trace
+TracedFunction convertToRegularExpressionTrace("convertToRegularExpression");
+
 /**
  * Convert a grammar to a regular expression
  *
@@ -169,6 +151,7 @@ std::unordered_multimap<int, MultiGrammarEntry> parseGrammar(const std::vector<s
  * @return A regular expression for the puzzle input.
  */
 std::string convertToRegularExpression(const std::unordered_multimap<int, MultiGrammarEntry> &grammar, int rule = 0) {
+	RecursiveTraceSpan traceSpan(convertToRegularExpressionTrace);
 	std::vector<std::string> expressions;
 	auto ruleIterators = grammar.equal_range(rule);
 	std::vector<std::pair<int, MultiGrammarEntry>> entries(ruleIterators.first, ruleIterators.second);
@@ -235,20 +218,20 @@ std::string convertToRegularExpression(const std::unordered_multimap<int, MultiG
  * @returns int The number of test strings that match the grammar
  */
 int getNumberOfMatches(
-	const std::unordered_multimap<int, MultiGrammarEntry> &grammar, const std::vector<std::string> &testStrings) {
+	const std::unordered_multimap<int, MultiGrammarEntry> &grammar, const std::vector<std::string_view> &testStrings) {
 	std::regex inputRegex(convertToRegularExpression(grammar));
-	return std::count_if(testStrings.cbegin(), testStrings.cend(), [&inputRegex](const std::string &testString) {
-		std::smatch matches;
-		return std::regex_match(testString, matches, inputRegex);
+	return std::count_if(testStrings.cbegin(), testStrings.cend(), [&inputRegex](std::string_view testString) {
+		std::cmatch matches;
+		return std::regex_match(testString.data(), testString.data() + testString.size(), matches, inputRegex);
 	});
 }
 
-int part1(const std::vector<std::string> &patterns, const std::vector<std::string> &testStrings) {
+int part1(const std::vector<std::string_view> &patterns, const std::vector<std::string_view> &testStrings) {
 	std::unordered_multimap<int, MultiGrammarEntry> grammar = parseGrammar(patterns);
 	return getNumberOfMatches(grammar, testStrings);
 }
 
-int part2(const std::vector<std::string> &patterns, const std::vector<std::string> &testStrings) {
+int part2(const std::vector<std::string_view> &patterns, const std::vector<std::string_view> &testStrings) {
 	std::unordered_multimap<int, MultiGrammarEntry> grammar = parseGrammar(patterns);
 	grammar.erase(8);
 	grammar.erase(11);
@@ -259,15 +242,20 @@ int part2(const std::vector<std::string> &patterns, const std::vector<std::strin
 	return getNumberOfMatches(grammar, testStrings);
 }
 
-int main(int argc, char *argv[]) {
-	if (argc != 2) {
-		std::cerr << argv[0] << " <input_file>" << std::endl;
-		return 1;
-	}
+void solve(PhaseRunner &runner, const MappedInput &input) {
+	auto blocks = runner.phase("parse", [&input]() { return input.getBlocks(); });
+	const std::vector<std::string_view> &patterns = blocks.at(0);
+	const std::vector<std::string_view> &testStrings = blocks.at(1);
+	runner.answers(
+		{"part1", "part2"},
+		[&patterns, &testStrings]() { return part1(patterns, testStrings); },
+		[&patterns, &testStrings]() { return part2(patterns, testStrings); });
+}
 
-	auto input = readInput(argv[1]);
-	auto parsedInput = splitInput(input);
+}  // namespace day19
 
-	std::cout << part1(parsedInput.first, parsedInput.second) << std::endl;
-	std::cout << part2(parsedInput.first, parsedInput.second) << std::endl;
+#ifndef AOC_NO_MAIN
+int main(int argc, char *argv[]) {
+	return runSolver(argc, argv, day19::solve);
 }
+#endif
@@ -1,16 +1,36 @@
-#include <folly/String.h>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <exception>
-#include <fstream>
+#include <execution>
 #include <iostream>
+#include <limits>
 #include <numeric>
-#include <regex>
-#include <string>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
 #include <vector>
 
-const std::string POLICY_PATTERN = "([0-9]+)-([0-9]+) (.)";
-const std::string DELIM = ": ";
+#include "../common/input.hpp"
+#include "../common/solver.hpp"
+#include "../common/stream.hpp"
+#include "../common/trace.hpp"
+
+namespace day2 {
+
+// The most digits a policy's bound may have, so that it always fits in an int
+constexpr std::size_t MAX_BOUND_DIGITS = 9;
+// How much of an input is read to estimate how many entries it has
+constexpr std::size_t LINE_SAMPLE_SIZE = 64 * 1024;
+// How many bytes of a password are compared against its policy's letter at once
+constexpr std::size_t LANE_WIDTH = 32;
+// About how many bytes of an input each chunk of it has, when the chunks are parsed and checked in parallel
+constexpr std::size_t CHUNK_SIZE = 4 * 1024 * 1024;
 
 /**
  * Policy represents a password policy
@@ -20,22 +40,6 @@ class Policy {
 	Policy(int min, int max, char letter) : min(min), max(max), letter(letter) {
 	}
 
-	/**
-	 * Parse a policy from an input string
-	 * @param input The input to parse
-	 * @return Policy The policy from the input
-	 */
-	static Policy parse(const std::string &input) {
-		std::regex expression(POLICY_PATTERN);
-		std::smatch matches;
-
-		if (!std::regex_search(input, matches, expression)) {
-			throw new std::invalid_argument("Invalid string");
-		}
-
-		return Policy(std::stoi(matches[1]), std::stoi(matches[2]), matches.str(3).at(0));
-	}
-
 	int getMin() const {
 		return this->min;
 	}
@@ -54,91 +58,481 @@ class Policy {
 	char letter;
 };
 
-std::vector<std::string> readInput(const std::string &filename) {
-	std::vector<std::string> input;
-	std::string line;
-	std::ifstream file(filename);
-	while (std::getline(file, line)) {
-		input.push_back(line);
+/**
+ * Parse a policy's bound, which is a number of up to MAX_BOUND_DIGITS digits, and move past it
+ * @param text The text to parse from
+ * @param cursor The position of the bound, which is moved to just past it
+ * @return int The bound
+ * @throws std::invalid_argument if there is no bound at the cursor
+ */
+inline int parseBound(std::string_view text, std::size_t &cursor) {
+	std::size_t start = cursor;
+	int bound = 0;
+	while (cursor < text.size() && cursor - start < MAX_BOUND_DIGITS && text[cursor] >= '0' && text[cursor] <= '9') {
+		bound = bound * 10 + (text[cursor] - '0');
+		cursor++;
+	}
+
+	if (cursor == start) {
+		throw std::invalid_argument("Invalid entry");
 	}
 
-	return input;
+	return bound;
+}
+
+/**
+ * Move past a character that must appear at the cursor
+ * @param text The text to parse from
+ * @param cursor The position of the character, which is moved to just past it
+ * @param expected The character that must be there
+ * @throws std::invalid_argument if the character isn't there
+ */
+inline void skipExpected(std::string_view text, std::size_t &cursor, char expected) {
+	if (cursor >= text.size() || text[cursor] != expected) {
+		throw std::invalid_argument("Invalid entry");
+	}
+
+	cursor++;
+}
+
+/**
+ * Parse the entry that starts at the cursor, in a single pass and without allocating, and move past its line
+ * @tparam Func A function that takes the entry's min, max, letter, and the offset and length of its password in the
+ * text
+ * @param text The text to parse from
+ * @param cursor The position of the start of the entry, which is moved to the start of the next line
+ * @param onEntry Called with the entry
+ * @throws std::invalid_argument if the line isn't a valid entry
+ */
+template <typename Func>
+void parseEntryAt(std::string_view text, std::size_t &cursor, Func &&onEntry) {
+	int min = parseBound(text, cursor);
+	skipExpected(text, cursor, '-');
+	int max = parseBound(text, cursor);
+	skipExpected(text, cursor, ' ');
+	if (cursor >= text.size() || text[cursor] == '\n') {
+		throw std::invalid_argument("Invalid entry");
+	}
+
+	char letter = text[cursor++];
+	skipExpected(text, cursor, ':');
+	skipExpected(text, cursor, ' ');
+
+	// The password is the rest of the line, whatever it holds
+	const void *newline = std::memchr(text.data() + cursor, '\n', text.size() - cursor);
+	std::size_t end = newline == nullptr ? text.size() : static_cast<const char *>(newline) - text.data();
+	onEntry(min, max, letter, cursor, end - cursor);
+	cursor = end + 1;
 }
 
 class Entry {
  public:
-	Entry(Policy policy, std::string password) : policy(policy), password(password) {
+	Entry(Policy policy, std::string_view password) : policy(policy), password(password) {
 	}
 
 	/**
 	 * Parse an input entry from an input string
-	 * @param input The input to parse
-	 * @return Entry the entry from the input
+	 * @param input The input to parse, which must be a single line
+	 * @return Entry the entry from the input, whose password points into the input
+	 * @throws std::invalid_argument if the input isn't a valid entry
 	 */
-	static Entry parse(const std::string &input) {
-		int delimIndex = input.find(DELIM);
-		std::vector<std::string> components;
-		folly::split(DELIM, input, components);
-		std::string rawPolicy = components.at(0);
-		std::string password = components.at(1);
-		Policy policy = Policy::parse(rawPolicy);
+	static Entry parse(std::string_view input) {
+		std::size_t cursor = 0;
+		std::optional<Entry> entry;
+		auto keepEntry = [input, &entry](int min, int max, char letter, std::size_t offset, std::size_t length) {
+			entry.emplace(Policy(min, max, letter), input.substr(offset, length));
+		};
+		parseEntryAt(input, cursor, keepEntry);
+		// The entry only ends the input if there was no newline to skip past
+		if (cursor <= input.size()) {
+			throw std::invalid_argument("Invalid entry");
+		}
 
-		return Entry(policy, password);
+		return *entry;
 	}
 
 	const Policy &getPolicy() const {
 		return this->policy;
 	}
 
-	const std::string &getPassword() const {
+	std::string_view getPassword() const {
 		return this->password;
 	}
 
  private:
 	Policy policy;
-	std::string password;
+	std::string_view password;
 };
 
 /**
- * Get the number of valid passwords in the input
- * @param input The input split into lines
- * @param matches A function that checks whether or not the password matches the policy
- * @return int The number ofm atching password
+ * Every entry of an input, stored as a structure of arrays, so that a pass over one field of every entry doesn't drag
+ * in the others. The passwords aren't copied: each is an offset and length into the text that the batch was parsed
+ * from, which must outlive the batch.
  */
-int getNumValidPasswords(const std::vector<std::string> &input, const std::function<bool(const Entry &)> &valid) {
-	return std::accumulate(input.begin(), input.end(), 0, [&](int total, std::string rawEntry) {
-		Entry entry = Entry::parse(rawEntry);
-		return total + valid(entry);
-	});
+class EntryBatch {
+ public:
+	/**
+	 * Parse every line of some text as an entry, in a single pass, and without allocating anything for each line
+	 * @param text The text to parse
+	 * @return EntryBatch The entries
+	 * @throws std::invalid_argument if any line isn't a valid entry
+	 */
+	static EntryBatch parse(std::string_view text) {
+		EntryBatch batch;
+		batch.text = text;
+		batch.reserve(estimateNumLines(text));
+		std::size_t cursor = 0;
+		while (cursor < text.size()) {
+			parseEntryAt(
+				text, cursor, [&batch](int min, int max, char letter, std::size_t offset, std::size_t length) {
+					batch.mins.push_back(min);
+					batch.maxes.push_back(max);
+					batch.letters.push_back(letter);
+					batch.passwordOffsets.push_back(offset);
+					batch.passwordLengths.push_back(static_cast<std::uint32_t>(length));
+				});
+		}
+
+		return batch;
+	}
+
+	std::size_t size() const {
+		return this->mins.size();
+	}
+
+	const std::vector<int> &getMins() const {
+		return this->mins;
+	}
+
+	const std::vector<int> &getMaxes() const {
+		return this->maxes;
+	}
+
+	const std::vector<char> &getLetters() const {
+		return this->letters;
+	}
+
+	/**
+	 * @return const std::vector<std::size_t>& Where each password starts, in the text the batch was parsed from
+	 */
+	const std::vector<std::size_t> &getPasswordOffsets() const {
+		return this->passwordOffsets;
+	}
+
+	const std::vector<std::uint32_t> &getPasswordLengths() const {
+		return this->passwordLengths;
+	}
+
+	/**
+	 * @return std::string_view The text the batch was parsed from
+	 */
+	std::string_view getText() const {
+		return this->text;
+	}
+
+	/**
+	 * @param i The index of an entry
+	 * @return Entry The entry, whose password points into the text the batch was parsed from
+	 */
+	Entry getEntry(std::size_t i) const {
+		return Entry(
+			Policy(this->mins[i], this->maxes[i], this->letters[i]),
+			this->text.substr(this->passwordOffsets[i], this->passwordLengths[i]));
+	}
+
+ private:
+	std::string_view text;
+	std::vector<int> mins;
+	std::vector<int> maxes;
+	std::vector<char> letters;
+	std::vector<std::size_t> passwordOffsets;
+	std::vector<std::uint32_t> passwordLengths;
+
+	void reserve(std::size_t numEntries) {
+		this->mins.reserve(numEntries);
+		this->maxes.reserve(numEntries);
+		this->letters.reserve(numEntries);
+		this->passwordOffsets.reserve(numEntries);
+		this->passwordLengths.reserve(numEntries);
+	}
+
+	/**
+	 * Estimate how many lines some text has from how long the lines at its start are. Counting every line up front
+	 * would take a whole extra pass over the text, which costs nearly as much as parsing it.
+	 * @param text The text
+	 * @return std::size_t The estimated number of lines, which errs on the high side
+	 */
+	static std::size_t estimateNumLines(std::string_view text) {
+		if (text.empty()) {
+			return 0;
+		}
+
+		std::string_view sample = text.substr(0, LINE_SAMPLE_SIZE);
+		std::size_t numSampleLines = std::count(sample.cbegin(), sample.cend(), '\n') + 1;
+
+		return text.size() / sample.size() * numSampleLines * 11 / 10 + numSampleLines;
+	}
+};
+
+bool isValidForPart1(const Entry &entry) {
+	const Policy &policy = entry.getPolicy();
+	std::string_view password = entry.getPassword();
+	int count = std::count_if(password.begin(), password.end(), [&](char c) { return c == policy.getLetter(); });
+
+	return (count >= policy.getMin() && count <= policy.getMax());
+}
+
+/**
+ * Check a password against part 2's policy. A position outside of the password can't hold the letter, so a policy
+ * with one isn't met, rather than making part 2 fail (and taking part 1, which never looks at positions, with it).
+ */
+bool isValidForPart2(const Entry &entry) {
+	const Policy &policy = entry.getPolicy();
+	std::string_view password = entry.getPassword();
+	char letter = entry.getPolicy().getLetter();
+	int length = static_cast<int>(password.size());
+	if (policy.getMin() < 1 || policy.getMin() > length || policy.getMax() < 1 || policy.getMax() > length) {
+		return false;
+	}
+
+	return ((password[policy.getMin() - 1] == letter) ^ (password[policy.getMax() - 1] == letter));
+}
+
+/**
+ * Find every byte of a lane of a password that is a given letter
+ * @param lane The start of the lane
+ * @param size The size of the lane, which must be at most LANE_WIDTH
+ * @param letter The letter to look for
+ * @return std::uint32_t A mask with the bit of each of those bytes set
+ */
+inline std::uint32_t findLetterScalar(const char *lane, std::size_t size, char letter) {
+	std::uint32_t matches = 0;
+	for (std::size_t i = 0; i < size; i++) {
+		matches |= static_cast<std::uint32_t>(lane[i] == letter) << i;
+	}
+
+	return matches;
+}
+
+#if defined(__x86_64__)
+/**
+ * Find every byte of a lane of a password that is a given letter, with AVX2. A full lane is always compared, so the
+ * bits past the lane's size are left for the caller to clear.
+ * @param lane The start of the lane, which must have LANE_WIDTH bytes that are safe to read
+ * @param letter The letter to look for
+ * @return std::uint32_t A mask with the bit of each of those bytes set
+ */
+__attribute__((target("avx2,popcnt"))) inline std::uint32_t findLetterAVX2(
+	const char *lane, [[maybe_unused]] std::size_t size, char letter) {
+	__m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lane));
+
+	return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(letter))));
+}
+#endif
+
+/**
+ * Count the passwords that are valid under each part's policy, in a single pass over the entries. Each password is
+ * compared against its letter a lane of LANE_WIDTH bytes at a time, which gives a mask of where the letter is: part 1
+ * counts its bits, and part 2 looks at the two bits its positions point to. This is always inlined into its callers,
+ * so that it gets compiled for whatever instruction set each of them targets.
+ * @tparam findLetter Finds the letter in a lane, given its size, and may read all LANE_WIDTH bytes of it
+ * @param entries The entries to check
+ * @return std::pair<long, long> The number of passwords valid for part 1 and for part 2
+ */
+template <std::uint32_t (*findLetter)(const char *, std::size_t, char)>
+__attribute__((always_inline)) inline std::pair<long, long> countValidPasswordsWith(const EntryBatch &entries) {
+	std::string_view text = entries.getText();
+	const std::vector<int> &mins = entries.getMins();
+	const std::vector<int> &maxes = entries.getMaxes();
+	const std::vector<char> &letters = entries.getLetters();
+	const std::vector<std::size_t> &offsets = entries.getPasswordOffsets();
+	const std::vector<std::uint32_t> &lengths = entries.getPasswordLengths();
+	std::pair<long, long> numValid(0, 0);
+	for (std::size_t i = 0; i < entries.size(); i++) {
+		// As in isValidForPart2, a policy with a position outside of the password isn't met for part 2
+		int length = static_cast<int>(lengths[i]);
+		bool inPassword = mins[i] >= 1 && mins[i] <= length && maxes[i] >= 1 && maxes[i] <= length;
+
+		// Positions before the lane wrap around to huge values, so only positions inside it are ever checked
+		std::size_t minPosition = mins[i] - 1;
+		std::size_t maxPosition = maxes[i] - 1;
+		int count = 0;
+		bool atMin = false;
+		bool atMax = false;
+		for (std::size_t laneStart = 0; laneStart < lengths[i]; laneStart += LANE_WIDTH) {
+			std::size_t laneOffset = offsets[i] + laneStart;
+			std::size_t laneSize = std::min<std::size_t>(LANE_WIDTH, lengths[i] - laneStart);
+			// A full lane reads past a short password into the lines after it, but it must not read past the text
+			std::uint32_t matches = laneOffset + LANE_WIDTH <= text.size()
+										? findLetter(text.data() + laneOffset, laneSize, letters[i])
+										: findLetterScalar(text.data() + laneOffset, laneSize, letters[i]);
+			if (laneSize < LANE_WIDTH) {
+				matches &= (std::uint32_t{1} << laneSize) - 1;
+			}
+
+			count += __builtin_popcount(matches);
+			atMin |= minPosition - laneStart < LANE_WIDTH && (matches >> (minPosition - laneStart) & 1) != 0;
+			atMax |= maxPosition - laneStart < LANE_WIDTH && (matches >> (maxPosition - laneStart) & 1) != 0;
+		}
+
+		numValid.first += count >= mins[i] && count <= maxes[i];
+		numValid.second += inPassword && atMin != atMax;
+	}
+
+	return numValid;
 }
 
-int part1(const std::vector<std::string> &input) {
-	return getNumValidPasswords(input, [](const Entry &entry) {
-		const Policy &policy = entry.getPolicy();
-		const std::string &password = entry.getPassword();
-		int count = std::count_if(password.begin(), password.end(), [&](char c) { return c == policy.getLetter(); });
+inline std::pair<long, long> countValidPasswordsScalar(const EntryBatch &entries) {
+	return countValidPasswordsWith<findLetterScalar>(entries);
+}
+
+#if defined(__x86_64__)
+__attribute__((target("avx2,popcnt"))) inline std::pair<long, long> countValidPasswordsAVX2(const EntryBatch &entries) {
+	return countValidPasswordsWith<findLetterAVX2>(entries);
+}
+#endif
+
+/**
+ * Count the passwords that are valid under each part's policy, with AVX2 when the machine supports it
+ * @param entries The entries to check
+ * @return std::pair<long, long> The number of passwords valid for part 1 and for part 2
+ */
+std::pair<long, long> countValidPasswords(const EntryBatch &entries) {
+#if defined(__x86_64__)
+	static const bool hasAVX2 = __builtin_cpu_supports("avx2");
+	if (hasAVX2) {
+		return countValidPasswordsAVX2(entries);
+	}
+#endif
+
+	return countValidPasswordsScalar(entries);
+}
+
+/**
+ * Split some text into chunks of about a given size, each of which ends just after a newline (or at the end of the
+ * text), so that every line is in exactly one chunk
+ * @param text The text to split
+ * @param chunkSize About how many bytes each chunk should have
+ * @return std::vector<std::string_view> The chunks, in order
+ */
+std::vector<std::string_view> splitIntoChunks(std::string_view text, std::size_t chunkSize) {
+	std::vector<std::string_view> chunks;
+	std::size_t start = 0;
+	while (start < text.size()) {
+		std::size_t end = text.size();
+		if (text.size() - start > chunkSize) {
+			const void *newline = std::memchr(text.data() + start + chunkSize, '\n', text.size() - start - chunkSize);
+			end = newline == nullptr ? text.size() : static_cast<const char *>(newline) - text.data() + 1;
+		}
+
+		chunks.push_back(text.substr(start, end - start));
+		start = end;
+	}
+
+	return chunks;
+}
+
+/**
+ * Count the passwords that are valid under each part's policy, by splitting the text into chunks of whole lines, and
+ * parsing and checking each chunk in a single task. A chunk's entries are dropped as soon as they're counted, so only
+ * the chunks in flight are ever held in memory, however large the input is. The parse and the check of each chunk get
+ * trace spans of their own, so that a trace still tells them apart. The counts are the same as checking all of the text
+ * at once, and if several chunks have invalid entries, the error of the first of them is the one thrown, however the
+ * threads finish.
+ * @param text The entries to check, one per line
+ * @param inParallel Whether to check the chunks in parallel, rather than one at a time on the calling thread
+ * @param chunkSize About how many bytes each chunk should have
+ * @return std::pair<long, long> The number of passwords valid for part 1 and for part 2
+ * @throws std::invalid_argument if any line isn't a valid entry
+ */
+std::pair<long, long> countValidPasswordsInChunks(
+	std::string_view text, bool inParallel, std::size_t chunkSize = CHUNK_SIZE) {
+	struct ChunkResult {
+		std::pair<long, long> numValid{0, 0};
+		// An exception can't be allowed to leave a parallel algorithm, which would terminate, so the first chunk (in
+		// text order) to fail keeps its error, to be rethrown once every chunk is done
+		std::size_t errorChunk = std::numeric_limits<std::size_t>::max();
+		std::exception_ptr error;
+	};
+
+	std::vector<std::string_view> chunks = splitIntoChunks(text, chunkSize);
+	auto combine = [](ChunkResult a, ChunkResult b) {
+		ChunkResult &failed = b.errorChunk < a.errorChunk ? b : a;
+		ChunkResult combined{
+			{a.numValid.first + b.numValid.first, a.numValid.second + b.numValid.second},
+			failed.errorChunk,
+			failed.error};
+
+		return combined;
+	};
+	// Each chunk is the element of the vector itself, so its index is where it sits in the vector
+	auto checkChunk = [&chunks](const std::string_view &chunk) {
+		ChunkResult result;
+		try {
+			std::optional<EntryBatch> entries;
+			{
+				TraceSpan span("parse chunk", "chunk");
+				entries = EntryBatch::parse(chunk);
+			}
+
+			TraceSpan span("validate chunk", "chunk");
+			result.numValid = countValidPasswords(*entries);
+		} catch (...) {
+			result.errorChunk = &chunk - chunks.data();
+			result.error = std::current_exception();
+		}
 
-		return (count >= policy.getMin() && count <= policy.getMax());
+		return result;
+	};
+
+	ChunkResult total =
+		inParallel
+			? std::transform_reduce(
+				  std::execution::par, chunks.cbegin(), chunks.cend(), ChunkResult(), combine, checkChunk)
+			: std::transform_reduce(chunks.cbegin(), chunks.cend(), ChunkResult(), combine, checkChunk);
+	if (total.error) {
+		std::rethrow_exception(total.error);
+	}
+
+	return total.numValid;
+}
+
+void solve(PhaseRunner &runner, const MappedInput &input) {
+	// The allocation and hardware counters only see the thread that runs a phase, so while they're on, the chunks are
+	// all checked on this thread, rather than leaving most of the work uncounted. Both parts look at the same bytes of
+	// each password, so they're checked together, as each chunk is parsed.
+	bool inParallel = !runner.isCountingPerThread();
+	auto numValid = runner.phase("validate", [&input, inParallel]() {
+		return countValidPasswordsInChunks(input.getContents(), inParallel);
 	});
+	runner.answers(
+		{"part1", "part2"},
+		[&numValid]() { return numValid.first; },
+		[&numValid]() { return numValid.second; });
 }
 
-int part2(const std::vector<std::string> &input) {
-	return getNumValidPasswords(input, [](const Entry &entry) {
-		const Policy &policy = entry.getPolicy();
-		const std::string &password = entry.getPassword();
-		char letter = entry.getPolicy().getLetter();
+void solveStream(PhaseRunner &runner, LineStream &stream) {
+	// Each entry only needs to be checked once for each part, so both counts can be kept as it is read
+	auto numValid = runner.phase("stream", [&stream]() {
+		std::pair<long, long> numValid(0, 0);
+		stream.forEachLine([&numValid](std::string_view rawEntry) {
+			Entry entry = Entry::parse(rawEntry);
+			numValid.first += isValidForPart1(entry);
+			numValid.second += isValidForPart2(entry);
+		});
 
-		return ((password.at(policy.getMin() - 1) == letter) ^ (password.at(policy.getMax() - 1) == letter));
+		return numValid;
 	});
+	runner.answers(
+		{"part1", "part2"},
+		[&numValid]() { return numValid.first; },
+		[&numValid]() { return numValid.second; });
 }
 
-int main(int argc, char *argv[]) {
-	if (argc != 2) {
-		std::cerr << "./day2 <input_file>" << std::endl;
-		return 1;
-	}
+}  // namespace day2
 
-	auto input = readInput(argv[1]);
-	std::cout << part1(input) << std::endl;
-	std::cout << part2(input) << std::endl;
+#ifndef AOC_NO_MAIN
+int main(int argc, char *argv[]) {
+	return runSolver(argc, argv, day2::solve, day2::solveStream);
 }
+#endif
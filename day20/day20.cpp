@@ -1,20 +1,23 @@
 #include <folly/String.h>
 
 #include <cmath>
-#include <fstream>
 #include <functional>
 #include <iostream>
 #include <map>
 #include <numeric>
 #include <optional>
-#include <regex>
 #include <string>
+#include <string_view>
 #include <vector>
 
-constexpr auto TILE_ID_PATTERN = R"(Tile (\d+):)";
+#include "../common/input.hpp"
+#include "../common/pattern.hpp"
+#include "../common/solver.hpp"
+
+namespace day20 {
+
+constexpr char TILE_ID_PATTERN[] = "Tile {int}:";
 constexpr int NUM_CAMERA_LINES = 10;
-// Plus one for the ID line, plus one for the newline after
-constexpr int NUM_INPUT_BLOCK_LINES = NUM_CAMERA_LINES + 2;
 constexpr char MONSTER_SIGNAL_CHAR = '#';
 constexpr auto MONSTER_STR = 1 + R"(
                   # 
@@ -289,58 +292,38 @@ class TransformGenerator {
 	std::vector<std::function<CameraFrame()>> operationList;
 };
 
-std::vector<std::string> readInput(const std::string &filename) {
-	std::vector<std::string> input;
-	std::string line;
-	std::ifstream file(filename);
-	while (std::getline(file, line)) {
-		input.push_back(line);
-	}
-
-	return input;
-}
-
 /**
  * Get the frame ID from an input line containing one
  * @param line The frame ID line
  * @return int The frame ID
  */
-int getFrameIDFromIDLine(const std::string &line) {
-	std::regex pattern(TILE_ID_PATTERN);
-	std::smatch matches;
-	if (!std::regex_match(line, matches, pattern)) {
+int getFrameIDFromIDLine(std::string_view line) {
+	auto matches = LinePattern<TILE_ID_PATTERN>::match(line);
+	if (!matches) {
 		throw std::invalid_argument("Invalid ID line");
 	}
 
-	return std::stoi(matches[1]);
+	return std::get<0>(*matches);
 }
 
 /**
  * Parse the puzzle input
- * @param input The puzzle input
+ * @param input The puzzle input, split into blocks
  * @return std::vector<CameraFrame> The frames from the camera input
  */
-std::vector<CameraFrame> parseInput(const std::vector<std::string> &input) {
-	int i = 0;
+std::vector<CameraFrame> parseInput(const std::vector<std::vector<std::string_view>> &input) {
 	std::vector<CameraFrame> cameraFrames;
-	int currentFrameID;
-	std::vector<std::string> currentCameraFrame;
-	for (auto it = input.cbegin(); it != input.cend(); (++it, i++)) {
-		const std::string &line = *it;
-		int lineIndex = i % NUM_INPUT_BLOCK_LINES;
-		if (lineIndex == 0) {
-			currentFrameID = getFrameIDFromIDLine(line);
-		} else if (line.size() > 0) {
-			// If the line isn't blank, this is a frame of an image
-			currentCameraFrame.push_back(line);
-		} else {
-			cameraFrames.emplace_back(currentFrameID, currentCameraFrame);
-			currentCameraFrame.clear();
+	for (const std::vector<std::string_view> &block : input) {
+		// Trailing blank lines leave us with an empty block
+		if (block.empty()) {
+			continue;
 		}
-	}
 
-	// Handle the last frame
-	cameraFrames.emplace_back(currentFrameID, currentCameraFrame);
+		// The first line of each block is its ID, and the rest of it is the frame of an image
+		int frameID = getFrameIDFromIDLine(block.front());
+		std::vector<std::string> cameraFrame(block.cbegin() + 1, block.cend());
+		cameraFrames.emplace_back(frameID, cameraFrame);
+	}
 
 	return cameraFrames;
 }
@@ -625,17 +608,20 @@ long part2(const std::map<std::pair<int, int>, CameraFrame> &rawBoard, int board
 	throw std::invalid_argument("No valid solution");
 }
 
-int main(int argc, char *argv[]) {
-	if (argc != 2) {
-		std::cerr << argv[0] << " <input_file>" << std::endl;
-		return 1;
-	}
-
-	auto input = readInput(argv[1]);
-	auto parsedInput = parseInput(input);
+void solve(PhaseRunner &runner, const MappedInput &input) {
+	auto parsedInput = runner.phase("parse", [&input]() { return parseInput(input.getBlocks()); });
 	int boardSize = calculateBoardSize(parsedInput);
-	auto board = findLinedUpArrangement(parsedInput);
+	auto board = runner.phase("arrange", [&parsedInput]() { return findLinedUpArrangement(parsedInput); });
+	runner.answers(
+		{"part1", "part2"},
+		[&board, boardSize]() { return part1(board, boardSize); },
+		[&board, boardSize]() { return part2(board, boardSize); });
+}
+
+}  // namespace day20
 
-	std::cout << part1(board, boardSize) << std::endl;
-	std::cout << part2(board, boardSize) << std::endl;
+#ifndef AOC_NO_MAIN
+int main(int argc, char *argv[]) {
+	return runSolver(argc, argv, day20::solve);
 }
+#endif
@@ -1,43 +1,39 @@
 #include <folly/String.h>
 
-#include <fstream>
+#include <algorithm>
 #include <functional>
 #include <iostream>
+#include <map>
 #include <numeric>
+#include <optional>
 #include <queue>
-#include <regex>
 #include <set>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "../common/input.hpp"
+#include "../common/pattern.hpp"
+#include "../common/solver.hpp"
+
+namespace day21 {
+
 // Pair of ingredients and allergens
 using IngredientLineItem = std::pair<std::vector<std::string>, std::vector<std::string>>;
-auto constexpr INGREDIENT_PATTERN = R"((.*) \(contains (.*)\))";
-
-std::vector<std::string> readInput(const std::string &filename) {
-	std::vector<std::string> input;
-	std::string line;
-	std::ifstream file(filename);
-	while (std::getline(file, line)) {
-		input.push_back(line);
-	}
-
-	return input;
-}
+constexpr char INGREDIENT_PATTERN[] = "{str} (contains {str})";
 
 /**
  * Split an input line into its components of both the foreign ingredient and the allergens
  * @param inputLine The input line
- * @return std::pair<std::string, std::string> The ingredients and allergens as a pair
+ * @return std::pair<std::string_view, std::string_view> The ingredients and allergens as a pair
  */
-std::pair<std::string, std::string> splitInputLine(const std::string &inputLine) {
-	std::regex pattern(INGREDIENT_PATTERN);
-	std::smatch matches;
-	if (!std::regex_match(inputLine, matches, pattern)) {
+std::pair<std::string_view, std::string_view> splitInputLine(std::string_view inputLine) {
+	auto matches = LinePattern<INGREDIENT_PATTERN>::match(inputLine);
+	if (!matches) {
 		throw std::invalid_argument("Invalid input line");
 	}
 
-	return std::make_pair(matches[1].str(), matches[2].str());
+	return std::make_pair(std::get<0>(*matches), std::get<1>(*matches));
 }
 
 /**
@@ -45,9 +41,9 @@ std::pair<std::string, std::string> splitInputLine(const std::string &inputLine)
  * @param input The puzzle input
  * @return std::vector<IngredientLineItem> The line items for the ingredients
  */
-std::vector<IngredientLineItem> parseInput(const std::vector<std::string> &input) {
+std::vector<IngredientLineItem> parseInput(const std::vector<std::string_view> &input) {
 	std::vector<IngredientLineItem> res;
-	std::transform(input.cbegin(), input.cend(), std::back_inserter(res), [](const std::string &inputLine) {
+	std::transform(input.cbegin(), input.cend(), std::back_inserter(res), [](std::string_view inputLine) {
 		auto lineComponents = splitInputLine(inputLine);
 		std::vector<std::string> unknownIngredients;
 		std::vector<std::string> allergens;
@@ -204,15 +200,18 @@ std::string part2(const std::vector<IngredientLineItem> &input) {
 	return generateCanonicalName(mappedIngredients);
 }
 
-int main(int argc, char *argv[]) {
-	if (argc != 2) {
-		std::cerr << argv[0] << " <input_file>" << std::endl;
-		return 1;
-	}
+void solve(PhaseRunner &runner, const MappedInput &input) {
+	auto parsedInput = runner.phase("parse", [&input]() { return parseInput(input.getLines()); });
+	runner.answers(
+		{"part1", "part2"},
+		[&parsedInput]() { return part1(parsedInput); },
+		[&parsedInput]() { return part2(parsedInput); });
+}
 
-	auto input = readInput(argv[1]);
-	auto parsedInput = parseInput(input);
+}  // namespace day21
 
-	std::cout << part1(parsedInput) << std::endl;
-	std::cout << part2(parsedInput) << std::endl;
+#ifndef AOC_NO_MAIN
+int main(int argc, char *argv[]) {
+	return runSolver(argc, argv, day21::solve);
 }
+#endif
@@ -1,43 +1,25 @@
-#include <fstream>
+#include <algorithm>
+#include <deque>
 #include <functional>
 #include <iostream>
 #include <numeric>
 #include <queue>
 #include <set>
 #include <string>
+#include <string_view>
 #include <vector>
 
-enum Player { PLAYER1, PLAYER2 };
-
-std::vector<std::string> readInput(const std::string &filename) {
-	std::vector<std::string> input;
-	std::string line;
-	std::ifstream file(filename);
-	while (std::getline(file, line)) {
-		input.push_back(line);
-	}
+#include "../common/input.hpp"
+#include "../common/integers.hpp"
+#include "../common/solver.hpp"
+#include "../common/trace.hpp"
 
-	return input;
-}
+namespace day22 {
 
-/**
- * Split the input between each player's decks
- *
- * @param input The puzzle input.
- *
- * @return std::pair<std::vector<std::string>, std::vector<std::string>> A pair of the puzzle grammar and the puzzle
- * test strings
- */
-std::pair<std::vector<std::string>, std::vector<std::string>> splitInput(const std::vector<std::string> &input) {
-	auto emptyLine = std::find(input.cbegin(), input.cend(), "");
-	auto beforeEmptyLine = std::vector<std::string>(input.cbegin(), emptyLine);
-	auto afterEmptyLine = std::vector<std::string>(emptyLine + 1, input.cend());
-	return std::pair<std::vector<std::string>, std::vector<std::string>>(
-		std::move(beforeEmptyLine), std::move(afterEmptyLine));
-}
+enum Player { PLAYER1, PLAYER2 };
 
 /**
- * Perform std::stoi on every element in the container, pushing the items to the output iterator.
+ * Parse every element in the container as an int, pushing the items to the output iterator.
  * @tparam Iterator The iterator for the input container
  * @tparam IntContainer The container to output to
  * @param begin The start of the range
@@ -46,19 +28,21 @@ std::pair<std::vector<std::string>, std::vector<std::string>> splitInput(const s
  */
 template <typename InputIterator, typename OutputIterator>
 void containerStoi(InputIterator begin, InputIterator end, OutputIterator out) {
-	std::transform(begin, end, out, [](const std::string &item) { return std::stoi(item); });
+	std::transform(begin, end, out, [](std::string_view item) { return parseInteger<int>(item); });
 }
 
 /**
  * Parse the decks from the puzzle input
- * @param input The puzzle input
+ * @param input The puzzle input, split into blocks (one per player)
  * @return std::pair<std::vector<int>, std::vector<int>> Both decks to play the game (player 1, player 2)
  */
-std::pair<std::vector<int>, std::vector<int>> parseDecks(const std::vector<std::string> &input) {
-	std::pair<std::vector<std::string>, std::vector<std::string>> inputComponents = splitInput(input);
+std::pair<std::vector<int>, std::vector<int>> parseDecks(const std::vector<std::vector<std::string_view>> &input) {
+	const std::vector<std::string_view> &player1Input = input.at(0);
+	const std::vector<std::string_view> &player2Input = input.at(1);
 	std::pair<std::vector<int>, std::vector<int>> decks;
-	containerStoi(inputComponents.first.cbegin() + 1, inputComponents.first.cend(), std::back_inserter(decks.first));
-	containerStoi(inputComponents.second.cbegin() + 1, inputComponents.second.cend(), std::back_inserter(decks.second));
+	// The first line of each block is the player's name, so it's skipped
+	containerStoi(player1Input.cbegin() + 1, player1Input.cend(), std::back_inserter(decks.first));
+	containerStoi(player2Input.cbegin() + 1, player2Input.cend(), std::back_inserter(decks.second));
 
 	return decks;
 }
@@ -106,10 +90,14 @@ int part1(const std::pair<std::vector<int>, std::vector<int>> &initialDecks) {
 	return calculateScore(winnerDeck.crbegin(), winnerDeck.crend());
 }
 
+// Traces the games of part 2 (each of which is a call of playGame), with --trace
+TracedFunction playGameTrace("playGame");
+
 int part2(const std::pair<std::vector<int>, std::vector<int>> &initialDecks) {
 	using DeckPair = std::pair<std::deque<int>, std::deque<int>>;
 	std::function<std::pair<Player, DeckPair>(DeckPair &)> playGame =
 		[&playGame](DeckPair &decks) -> std::pair<Player, std::pair<std::deque<int>, std::deque<int>>> {
+		RecursiveTraceSpan traceSpan(playGameTrace);
 		// Holds game states that have already been used, preventing their resuse within a single sub-game
 		std::set<DeckPair> usedDecks;
 		while (!decks.first.empty() && !decks.second.empty()) {
@@ -157,15 +145,18 @@ int part2(const std::pair<std::vector<int>, std::vector<int>> &initialDecks) {
 	return calculateScore(winningDeck.crbegin(), winningDeck.crend());
 }
 
-int main(int argc, char *argv[]) {
-	if (argc != 2) {
-		std::cerr << argv[0] << " <input_file>" << std::endl;
-		return 1;
-	}
+void solve(PhaseRunner &runner, const MappedInput &input) {
+	auto decks = runner.phase("parse", [&input]() { return parseDecks(input.getBlocks()); });
+	runner.answers(
+		{"part1", "part2"},
+		[&decks]() { return part1(decks); },
+		[&decks]() { return part2(decks); });
+}
 
-	auto input = readInput(argv[1]);
-	auto decks = parseDecks(input);
+}  // namespace day22
 
-	std::cout << part1(decks) << std::endl;
-	std::cout << part2(decks) << std::endl;
+#ifndef AOC_NO_MAIN
+int main(int argc, char *argv[]) {
+	return runSolver(argc, argv, day22::solve);
 }
+#endif
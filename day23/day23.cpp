@@ -3,12 +3,22 @@
 #include <boost/hana/any_of.hpp>
 #include <boost/hana/ext/std/tuple.hpp>
 #include <boost/hana/for_each.hpp>
-#include <fstream>
+#include <algorithm>
 #include <functional>
 #include <iostream>
+#include <memory>
 #include <numeric>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <tuple>
+#include <vector>
+
+#include "../common/arena.hpp"
+#include "../common/input.hpp"
+#include "../common/solver.hpp"
+
+namespace day23 {
 
 constexpr int P1_NUM_CRAB_TURNS = 100;
 constexpr int P2_NUM_CRAB_TURNS = 1E7;
@@ -105,7 +115,8 @@ class CupGraph {
 	 * @param end The item to end at
 	 */
 	template <typename IntIter>
-	CupGraph(IntIter start, IntIter end) {
+	CupGraph(IntIter start, IntIter end)
+		: arena(std::make_unique<HugePageArena>()), neighbors(neighbor_map_type::allocator_type(*this->arena)) {
 		if (start == end) {
 			return;
 		}
@@ -120,6 +131,10 @@ class CupGraph {
 		this->neighbors.insert({*(end - 1), *start});
 	};
 
+	CupGraph(CupGraph &&) = default;
+	// Assigning would replace the arena (freeing the old one) before the map could give its nodes back to it
+	CupGraph &operator=(CupGraph &&) = delete;
+
 	/**
 	 * Get an iterator for a cycle starting at the given element. This will be the *LAST* item returned by the range
 	 * (i.e. the first item is the neighbor of this item)
@@ -189,27 +204,24 @@ class CupGraph {
 	}
 
  private:
-	typedef boost::bimap<boost::bimaps::unordered_set_of<int>, boost::bimaps::unordered_set_of<int>> neighbor_map_type;
+	typedef boost::bimap<
+		boost::bimaps::unordered_set_of<int>,
+		boost::bimaps::unordered_set_of<int>,
+		ArenaAllocator<std::pair<int, int>>>
+		neighbor_map_type;
+	// A million cups take millions of nodes and buckets, which every move hops between at random, so they're kept on
+	// huge pages. Each move frees and then allocates three nodes of the same size, which the arena reuses. It lives on
+	// the heap, so that moving the graph doesn't leave the map's allocator pointing at the old one.
+	std::unique_ptr<HugePageArena> arena;
 	neighbor_map_type neighbors;
 };
 
-std::vector<std::string> readInput(const std::string &filename) {
-	std::vector<std::string> input;
-	std::string line;
-	std::ifstream file(filename);
-	while (std::getline(file, line)) {
-		input.push_back(line);
-	}
-
-	return input;
-}
-
 /**
  * Make a vector of the cups on the given input line
  * @param inputLine The single-line puzzle input
  * @return std::vector<int> The cups on the single line
  */
-std::vector<int> makeCupList(const std::string &inputLine) {
+std::vector<int> makeCupList(std::string_view inputLine) {
 	std::vector<int> cups;
 	std::transform(inputLine.cbegin(), inputLine.cend(), std::back_inserter(cups), [](char rawNum) {
 		if (rawNum < '0' || rawNum > '9') {
@@ -345,7 +357,7 @@ std::string makeFullCupLabel(const CupGraph &graph) {
 	return output;
 }
 
-std::string part1(const std::string &inputLine) {
+std::string part1(std::string_view inputLine) {
 	std::vector<int> cups = makeCupList(inputLine);
 	CupGraph graph(cups.cbegin(), cups.cend());
 	runGame(cups.front(), graph, P1_NUM_CRAB_TURNS);
@@ -353,7 +365,7 @@ std::string part1(const std::string &inputLine) {
 	return makeFullCupLabel(graph);
 }
 
-long part2(const std::string &inputLine) {
+long part2(std::string_view inputLine) {
 	std::vector<int> cups = makeCupList(inputLine);
 	// Generate the items needed for part 2. We could maybe do something smart in the graph and generate these
 	// as-needed, but it's more complexity than needed. I think I can live without the 4MB of RAM :)
@@ -374,13 +386,18 @@ long part2(const std::string &inputLine) {
 	return n1 * n2;
 }
 
-int main(int argc, char *argv[]) {
-	if (argc != 2) {
-		std::cerr << argv[0] << " <input_file>" << std::endl;
-		return 1;
-	}
+void solve(PhaseRunner &runner, const MappedInput &input) {
+	auto lines = runner.phase("parse", [&input]() { return input.getLines(); });
+	runner.answers(
+		{"part1", "part2"},
+		[&lines]() { return part1(lines.at(0)); },
+		[&lines]() { return part2(lines.at(0)); });
+}
+
+}  // namespace day23
 
-	auto input = readInput(argv[1]);
-	std::cout << part1(input.at(0)) << std::endl;
-	std::cout << part2(input.at(0)) << std::endl;
+#ifndef AOC_NO_MAIN
+int main(int argc, char *argv[]) {
+	return runSolver(argc, argv, day23::solve);
 }
+#endif
@@ -1,16 +1,23 @@
-#include <fstream>
-#include <functional>
+#include <algorithm>
 #include <iostream>
+#include <map>
 #include <numeric>
-#include <regex>
 #include <string>
+#include <string_view>
 #include <tuple>
+#include <vector>
+
+#include "../common/automaton.hpp"
+#include "../common/input.hpp"
+#include "../common/solver.hpp"
+#include "../common/stream.hpp"
+
+namespace day24 {
 
 enum Direction { EAST, WEST, SOUTH_EAST, SOUTH_WEST, NORTH_WEST, NORTH_EAST };
 
-constexpr auto DIRECTION_PATTERN = R"(e|w|se|sw|nw|ne)";
 constexpr int NUM_DAYS = 100;
-const std::map<std::string, Direction> INPUT_TO_DIRECTION{
+const std::map<std::string_view, Direction> INPUT_TO_DIRECTION{
 	std::make_pair("e", EAST),
 	std::make_pair("w", WEST),
 	std::make_pair("se", SOUTH_EAST),
@@ -30,33 +37,19 @@ const std::map<Direction, std::pair<int, int>> DIRECTION_TO_DELTA{
 	std::make_pair(NORTH_EAST, std::make_pair(-1, 1)),
 };
 
-std::vector<std::string> readInput(const std::string &filename) {
-	std::vector<std::string> input;
-	std::string line;
-	std::ifstream file(filename);
-	while (std::getline(file, line)) {
-		input.push_back(line);
-	}
-
-	return input;
-}
-
 /**
  * Parse a single line of input
  * @param inputLine The line to parse
  * @return std::vector<Direction> A vector of the directions on each line.
  */
-std::vector<Direction> parseInputLine(const std::string &inputLine) {
-	std::regex directionPattern(DIRECTION_PATTERN);
+std::vector<Direction> parseInputLine(std::string_view inputLine) {
 	std::vector<Direction> res;
-	std::transform(
-		std::sregex_iterator(inputLine.cbegin(), inputLine.cend(), directionPattern),
-		std::sregex_iterator(),
-		std::back_inserter(res),
-		[](const std::smatch &match) {
-			std::string directionStr = match.str();
-			return INPUT_TO_DIRECTION.at(directionStr);
-		});
+	// The directions run together without separators, but only the north and south ones are two characters long
+	for (std::size_t cursor = 0; cursor < inputLine.size();) {
+		std::size_t length = (inputLine[cursor] == 'n' || inputLine[cursor] == 's') ? 2 : 1;
+		res.push_back(INPUT_TO_DIRECTION.at(inputLine.substr(cursor, length)));
+		cursor += length;
+	}
 
 	return res;
 }
@@ -66,7 +59,7 @@ std::vector<Direction> parseInputLine(const std::string &inputLine) {
  * @param input The full puzzle input
  * @return std::vector<std::vector<Direction>> The parsed puzzle input, which is each line as a vector of directions.
  */
-std::vector<std::vector<Direction>> parseInput(const std::vector<std::string> &input) {
+std::vector<std::vector<Direction>> parseInput(const std::vector<std::string_view> &input) {
 	std::vector<std::vector<Direction>> res;
 	std::transform(input.cbegin(), input.cend(), std::back_inserter(res), parseInputLine);
 
@@ -88,6 +81,16 @@ std::pair<int, int> getPositionFromDirections(InputIterator start, InputIterator
 	});
 }
 
+/**
+ * Flip the tile at the end of a sequence of directions
+ * @param tiles A map of positions to whether or not the tiles are flipped (i.e. black)
+ * @param sequence The directions to the tile to flip
+ */
+void flipTile(std::map<std::pair<int, int>, bool> &tiles, const std::vector<Direction> &sequence) {
+	std::pair<int, int> pos = getPositionFromDirections(sequence.cbegin(), sequence.cend());
+	tiles[pos] = !tiles[pos];
+}
+
 /**
  * Given the puzzle input, get the tiles that are flipped.
  * @param input The parsed puzzle input
@@ -96,8 +99,7 @@ std::pair<int, int> getPositionFromDirections(InputIterator start, InputIterator
 std::map<std::pair<int, int>, bool> getFlippedTiles(const std::vector<std::vector<Direction>> &input) {
 	std::map<std::pair<int, int>, bool> flipped;
 	for (const std::vector<Direction> &sequence : input) {
-		std::pair<int, int> pos = getPositionFromDirections(sequence.cbegin(), sequence.cend());
-		flipped[pos] = !flipped[pos];
+		flipTile(flipped, sequence);
 	}
 
 	return flipped;
@@ -108,82 +110,90 @@ std::map<std::pair<int, int>, bool> getFlippedTiles(const std::vector<std::vecto
  * @param tiles The tiles on the board
  * @return int The number of flipped tiles
  */
-int countFlippedTiles(std::map<std::pair<int, int>, bool> &tiles) {
+int countFlippedTiles(const std::map<std::pair<int, int>, bool> &tiles) {
 	return std::count_if(tiles.cbegin(), tiles.cend(), [](auto entry) { return entry.second; });
 }
 
-/**
- * Get the neighbors of a given position
- * @param position The position to get the neighbor of
- * @return std::vector<std::pair<int, int>> The neighbors
- */
-std::vector<std::pair<int, int>> getNeighbors(const std::pair<int, int> &position) {
-	std::vector<std::pair<int, int>> res;
-
-	std::transform(
-		DIRECTION_TO_DELTA.cbegin(),
-		DIRECTION_TO_DELTA.cend(),
-		std::back_inserter(res),
-		[&position](const auto &entry) {
-			const std::pair<int, int> &delta = entry.second;
-			return std::make_pair(position.first + delta.first, position.second + delta.second);
-		});
-
-	return res;
-}
-
 int part1(const std::vector<std::vector<Direction>> &input) {
 	auto flipped = getFlippedTiles(input);
 
 	return countFlippedTiles(flipped);
 }
 
-int part2(const std::vector<std::vector<Direction>> &input) {
-	std::map<std::pair<int, int>, bool> flipped = getFlippedTiles(input);
-	std::map<std::pair<int, int>, bool> next = getFlippedTiles(input);
-	for (int i = 0; i < NUM_DAYS; i++) {
-		// Ensure all entries have their neighbors in the map
-		// If this is not true, the number of neighbors will not be run correctly.
-		for (const auto &entry : next) {
-			for (const auto &neighbor : getNeighbors(entry.first)) {
-				// Emplace will not overwrite existing elements
-				flipped.emplace(neighbor, false);
-			}
+/**
+ * Run the tiles through every day of the exhibit
+ * @param flipped The tiles that are flipped at the start
+ * @return int The number of flipped tiles after the last day
+ */
+int countFlippedTilesAfterExhibit(const std::map<std::pair<int, int>, bool> &flipped) {
+	// The automaton works in axial coordinates, where the neighbors of a tile are all adjacent along both axes. Every
+	// position has an even sum of components, so these are always whole.
+	std::vector<std::pair<int, int>> blackTiles;
+	for (const auto &entry : flipped) {
+		if (entry.second) {
+			const std::pair<int, int> &position = entry.first;
+			blackTiles.emplace_back(
+				(position.first + position.second) / 2, (position.first - position.second) / 2);
 		}
+	}
 
-		for (auto &entry : flipped) {
-			auto neighbors = getNeighbors(entry.first);
-			int numFlippedNeighbors =
-				std::count_if(neighbors.cbegin(), neighbors.cend(), [&flipped](const std::pair<int, int> &pos) {
-					auto posIt = flipped.find(pos);
-					return posIt == flipped.end() ? false : posIt->second;
-				});
-
-			bool nextState = entry.second;
-			if (entry.second && (numFlippedNeighbors == 0 || numFlippedNeighbors > 2)) {
-				nextState = false;
-			} else if (!entry.second && numFlippedNeighbors == 2) {
-				nextState = true;
-			}
-
-			next[entry.first] = nextState;
-		}
+	if (blackTiles.empty()) {
+		return 0;
+	}
 
-		std::swap(flipped, next);
+	// The black tiles can spread at most one tile in each direction per day, so leaving that much room on each side
+	// means that none of them can ever reach the edge of the grid
+	auto [minFirst, maxFirst] = std::minmax_element(
+		blackTiles.cbegin(), blackTiles.cend(), [](const auto &a, const auto &b) { return a.first < b.first; });
+	auto [minSecond, maxSecond] = std::minmax_element(
+		blackTiles.cbegin(), blackTiles.cend(), [](const auto &a, const auto &b) { return a.second < b.second; });
+	std::pair<int, int> origin(minFirst->first - NUM_DAYS, minSecond->second - NUM_DAYS);
+	CellularAutomaton<2> automaton(
+		{maxFirst->first - origin.first + NUM_DAYS + 1, maxSecond->second - origin.second + NUM_DAYS + 1},
+		Topology<2>::hex(),
+		AutomatonRule({2}, {1, 2}));
+	for (const auto &tile : blackTiles) {
+		automaton.setAlive({tile.first - origin.first, tile.second - origin.second});
 	}
 
-	return countFlippedTiles(flipped);
+	for (int i = 0; i < NUM_DAYS; i++) {
+		automaton.step();
+	}
+
+	return automaton.countAlive();
 }
 
-int main(int argc, char *argv[]) {
-	if (argc != 2) {
-		std::cerr << argv[0] << " <input_file>" << std::endl;
-		return 1;
-	}
+int part2(const std::vector<std::vector<Direction>> &input) {
+	return countFlippedTilesAfterExhibit(getFlippedTiles(input));
+}
 
-	auto input = readInput(argv[1]);
-	auto parsedInput = parseInput(input);
+void solve(PhaseRunner &runner, const MappedInput &input) {
+	auto parsedInput = runner.phase("parse", [&input]() { return parseInput(input.getLines()); });
+	runner.answers(
+		{"part1", "part2"},
+		[&parsedInput]() { return part1(parsedInput); },
+		[&parsedInput]() { return part2(parsedInput); });
+}
 
-	std::cout << part1(parsedInput) << std::endl;
-	std::cout << part2(parsedInput) << std::endl;
+void solveStream(PhaseRunner &runner, LineStream &stream) {
+	// Only the tiles need to be kept, not the directions to them, so the memory this takes grows with the floor rather
+	// than the input
+	auto flipped = runner.phase("stream", [&stream]() {
+		std::map<std::pair<int, int>, bool> flipped;
+		stream.forEachLine([&flipped](std::string_view line) { flipTile(flipped, parseInputLine(line)); });
+
+		return flipped;
+	});
+	runner.answers(
+		{"part1", "part2"},
+		[&flipped]() { return countFlippedTiles(flipped); },
+		[&flipped]() { return countFlippedTilesAfterExhibit(flipped); });
+}
+
+}  // namespace day24
+
+#ifndef AOC_NO_MAIN
+int main(int argc, char *argv[]) {
+	return runSolver(argc, argv, day24::solve, day24::solveStream);
 }
+#endif
@@ -1,34 +1,47 @@
+#include <array>
 #include <cassert>
-#include <fstream>
+#include <charconv>
 #include <functional>
 #include <iostream>
 #include <numeric>
 #include <regex>
 #include <string>
+#include <string_view>
 #include <tuple>
+#include <vector>
+
+#include "../common/embedded.hpp"
+#include "../common/input.hpp"
+#include "../common/solver.hpp"
+
+namespace day25 {
 
 constexpr int DIVIDEND = 20201227;
 constexpr int START_SUBJECT_NUMBER = 7;
 
-std::vector<std::string> readInput(const std::string &filename) {
-	std::vector<std::string> input;
-	std::string line;
-	std::ifstream file(filename);
-	while (std::getline(file, line)) {
-		input.push_back(line);
+/**
+ * Parse a single public key
+ * @param rawKey The key from the input
+ * @return long The public key
+ */
+long parseKey(std::string_view rawKey) {
+	long key;
+	auto parseResult = std::from_chars(rawKey.data(), rawKey.data() + rawKey.size(), key);
+	if (parseResult.ec != std::errc()) {
+		throw std::invalid_argument("Invalid public key");
 	}
 
-	return input;
+	return key;
 }
 
 /**
  * @param int The puzzle input
  * @return std::pair<long, long> Each public key
  */
-std::pair<long, long> parseInput(const std::vector<std::string> &input) {
+std::pair<long, long> parseInput(const std::vector<std::string_view> &input) {
 	assert(input.size() == 2);
 
-	return std::make_pair(std::stol(input.at(0)), std::stol(input.at(1)));
+	return std::make_pair(parseKey(input.at(0)), parseKey(input.at(1)));
 }
 
 /**
@@ -38,7 +51,7 @@ std::pair<long, long> parseInput(const std::vector<std::string> &input) {
  * @param initValue The initial value to use
  * @return long The transform
  */
-long performTransform(int subjectNumber, int numLoops, int initValue = 1) {
+constexpr long performTransform(int subjectNumber, int numLoops, int initValue = 1) {
 	long res = initValue;
 	for (int i = 0; i < numLoops; i++) {
 		res *= subjectNumber;
@@ -54,7 +67,7 @@ long performTransform(int subjectNumber, int numLoops, int initValue = 1) {
  * @param target The target number to stop at
  * @return int THe loop size
  */
-int findLoopSize(int subjectNumber, int target) {
+constexpr int findLoopSize(int subjectNumber, int target) {
 	long value = 1;
 	for (int loopSize = 1;; loopSize++) {
 		value = performTransform(subjectNumber, 1, value);
@@ -64,20 +77,44 @@ int findLoopSize(int subjectNumber, int target) {
 	}
 }
 
-long part1(const std::pair<int, int> &publicKeys) {
+constexpr long part1(const std::pair<int, int> &publicKeys) {
 	int cardLoopSize = findLoopSize(START_SUBJECT_NUMBER, publicKeys.first);
 
 	return performTransform(publicKeys.second, cardLoopSize);
 }
 
-int main(int argc, char *argv[]) {
-	if (argc != 2) {
-		std::cerr << argv[0] << " <input_file>" << std::endl;
-		return 1;
-	}
+void solve(PhaseRunner &runner, const MappedInput &input) {
+	auto parsedInput = runner.phase("parse", [&input]() { return parseInput(input.getLines()); });
+	runner.answer("part1", [&parsedInput]() { return part1(parsedInput); });
+}
 
-	auto input = readInput(argv[1]);
-	auto parsedInput = parseInput(input);
+/**
+ * Solve an embedded input at compile time. The loop size can run to millions, so this needs the compiler's limit on
+ * the iterations of a constexpr loop raised to match.
+ * @param input The puzzle input
+ * @return std::array<long, 1> The answer to part 1
+ */
+constexpr std::array<long, 1> solveConstexpr(std::string_view input) {
+	auto [rawCardKey, rawDoorKey] = splitLinesConstexpr<2>(input);
+	std::pair<int, int> publicKeys(parseIntegerConstexpr<int>(rawCardKey), parseIntegerConstexpr<int>(rawDoorKey));
+
+	return {part1(publicKeys)};
+}
+
+}  // namespace day25
 
-	std::cout << part1(parsedInput) << std::endl;
+#ifndef AOC_NO_MAIN
+#ifdef AOC_EMBEDDED_INPUT
+#include AOC_EMBEDDED_INPUT
+
+int main() {
+	// The answer is found while compiling, so all that's left is to print it
+	constexpr auto answers = day25::solveConstexpr(EMBEDDED_INPUT);
+	return printEmbeddedAnswers(answers);
+}
+#else
+int main(int argc, char *argv[]) {
+	return runSolver(argc, argv, day25::solve);
 }
+#endif
+#endif
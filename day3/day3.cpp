@@ -1,69 +1,416 @@
-#include <execution>
-#include <fstream>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
 #include <iostream>
-#include <numeric>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 #include <vector>
 
+#include "../common/input.hpp"
+#include "../common/integers.hpp"
+#include "../common/solver.hpp"
+
+namespace day3 {
+
 constexpr char TREE_CHAR = '#';
+constexpr char OPEN_CHAR = '.';
+// Answers the number of trees on every slope in a file (one "right,down" per line) against a single input, in place of
+// the two parts
+constexpr auto SLOPES_FLAG = "--slopes";
+// How many bytes of rows a batched pass covers at a time, so that every slope probes them while they're in L1 cache
+constexpr std::size_t BLOCK_SIZE = 32 * 1024;
+constexpr std::size_t WORD_BITS = 64;
+// How many tiles of a row are packed into bits at once
+constexpr std::size_t LANE_WIDTH = 32;
 
-std::vector<std::string> readInput(const std::string &filename) {
-	std::vector<std::string> input;
-	std::string line;
-	std::ifstream file(filename);
-	while (std::getline(file, line)) {
-		input.push_back(line);
+/**
+ * Find the trees in a lane of a row, and anything in it that isn't a tile
+ * @param lane The start of the lane
+ * @param size The size of the lane, which must be at most LANE_WIDTH
+ * @param invalid Has the bit of each byte of the lane that isn't a tile set in it
+ * @return std::uint32_t A mask with the bit of each tree set
+ */
+inline std::uint32_t findTreesScalar(const char *lane, std::size_t size, std::uint32_t &invalid) {
+	std::uint32_t trees = 0;
+	for (std::size_t i = 0; i < size; i++) {
+		trees |= static_cast<std::uint32_t>(lane[i] == TREE_CHAR) << i;
+		invalid |= static_cast<std::uint32_t>(lane[i] != TREE_CHAR && lane[i] != OPEN_CHAR) << i;
 	}
 
-	return input;
+	return trees;
+}
+
+#if defined(__x86_64__)
+/**
+ * Find the trees in a lane of a row, and anything in it that isn't a tile, with AVX2
+ * @param lane The start of the lane, which must have LANE_WIDTH bytes that are safe to read
+ * @param size The size of the lane, past which the bytes are ignored
+ * @param invalid Has the bit of each byte of the lane that isn't a tile set in it
+ * @return std::uint32_t A mask with the bit of each tree set
+ */
+__attribute__((target("avx2"))) inline std::uint32_t findTreesAVX2(
+	const char *lane, std::size_t size, std::uint32_t &invalid) {
+	__m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lane));
+	__m256i isTree = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(TREE_CHAR));
+	__m256i isOpen = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(OPEN_CHAR));
+	auto trees = static_cast<std::uint32_t>(_mm256_movemask_epi8(isTree));
+	auto open = static_cast<std::uint32_t>(_mm256_movemask_epi8(isOpen));
+	std::uint32_t inLane = size < LANE_WIDTH ? (std::uint32_t{1} << size) - 1 : ~std::uint32_t{0};
+	invalid |= ~(trees | open) & inLane;
+
+	return trees & inLane;
 }
+#endif
 
 /**
- * Find the number of trees that move along a path
- * @param input The input for the puzzle
- * @param xDelta The number of tiles to move right each step
- * @param yDelta The number of tiles to move down each step
- * @return int The number of trees encountered along this path
+ * A slope down the grid, as how far each step goes right and down
  */
-int findNumTrees(const std::vector<std::string> &input, int xDelta, int yDelta = 1) {
-	int xCursor = 0;
-	int numTrees = 0;
-	// I want to use an iterator here, but I don't have a way to cleanly make sure I don't blow through the end :(
-	for (int i = 0; i < input.size(); i += yDelta) {
-		const std::string &row = input.at(i);
-		numTrees += (row.at(xCursor) == TREE_CHAR);
-		xCursor = (xCursor + xDelta) % row.length();
+class Slope {
+ public:
+	/**
+	 * @param right How many tiles each step goes right, which may be negative, to go left
+	 * @param down How many rows each step goes down
+	 * @throws std::invalid_argument if down isn't positive
+	 */
+	Slope(long right, long down) : right(right), down(down) {
+		if (down < 1) {
+			throw std::invalid_argument("A slope must go down");
+		}
 	}
 
-	return numTrees;
+	/**
+	 * Parse a slope from a line of a slopes file
+	 * @param line How far each step goes right and down, separated by a comma
+	 * @return Slope The slope
+	 * @throws std::invalid_argument if the line isn't a valid slope
+	 */
+	static Slope parse(std::string_view line) {
+		std::vector<long> steps = parseIntegers<long>(line);
+		if (steps.size() != 2) {
+			throw std::invalid_argument("Invalid slope: " + std::string(line));
+		}
+
+		return Slope(steps[0], steps[1]);
+	}
+
+	long getRight() const {
+		return this->right;
+	}
+
+	long getDown() const {
+		return this->down;
+	}
+
+ private:
+	long right;
+	long down;
+};
+
+/**
+ * The map of trees, with each row packed into bits (one for each tile, which is set if the tile has a tree), so that a
+ * row of the puzzle's width is a single word
+ */
+class TreeGrid {
+ public:
+	/**
+	 * Parse the grid from an input, straight from its text. When the machine supports AVX2, the tiles are packed into
+	 * bits 32 at a time.
+	 * @param text The rows of the grid, one per line, which may end in CRLF
+	 * @return TreeGrid The grid
+	 * @throws std::invalid_argument if the rows aren't all the same, nonzero, width, or have anything but trees and
+	 * open squares
+	 */
+	static TreeGrid parse(std::string_view text) {
+#if defined(__x86_64__)
+		static const bool hasAVX2 = __builtin_cpu_supports("avx2");
+		if (hasAVX2) {
+			return parseAVX2(text);
+		}
+#endif
+
+		return parseWith<findTreesScalar>(text);
+	}
+
+	std::size_t getWidth() const {
+		return this->width;
+	}
+
+	std::size_t getHeight() const {
+		return this->height;
+	}
+
+	bool hasTree(std::size_t row, std::size_t column) const {
+		return this->rows[row * this->wordsPerRow + column / WORD_BITS] >> column % WORD_BITS & 1;
+	}
+
+	/**
+	 * Count the trees on each of many slopes, which each start at the top left, and wrap around to the left edge as
+	 * they go past the right one. They're all answered in a single pass down the rows, a block at a time: the slopes
+	 * are grouped by how far they go down, so that each group visits the same rows of a block, and every slope probes
+	 * a block while it's in cache.
+	 * @param slopes The slopes
+	 * @return std::vector<std::uint64_t> The number of trees on each slope, in the order given
+	 */
+	std::vector<std::uint64_t> countTrees(const std::vector<Slope> &slopes) const {
+		std::vector<std::uint64_t> numTrees(slopes.size(), 0);
+		if (this->height == 0) {
+			return numTrees;
+		}
+
+		// A step down past the last row never lands on anything but the first, however far it goes
+		std::map<std::size_t, SlopeGroup> groups;
+		for (std::size_t i = 0; i < slopes.size(); i++) {
+			std::size_t down = std::min<std::size_t>(slopes[i].getDown(), this->height);
+			long width = static_cast<long>(this->width);
+			groups[down].add(i, static_cast<std::size_t>((slopes[i].getRight() % width + width) % width));
+		}
+
+		std::size_t rowsPerBlock = std::max<std::size_t>(BLOCK_SIZE / (this->wordsPerRow * sizeof(std::uint64_t)), 1);
+		for (std::size_t blockStart = 0; blockStart < this->height; blockStart += rowsPerBlock) {
+			std::size_t blockEnd = std::min(blockStart + rowsPerBlock, this->height);
+			for (auto &[down, group] : groups) {
+				// The first row of the block that the group lands on
+				std::size_t firstRow = (blockStart + down - 1) / down * down;
+				group.visitRows(*this, firstRow, blockEnd, down);
+			}
+		}
+
+		for (const auto &[down, group] : groups) {
+			group.collectTrees(numTrees);
+		}
+
+		return numTrees;
+	}
+
+ private:
+	// The slopes that go down the same number of rows, and where each of them is, as a structure of arrays
+	class SlopeGroup {
+	 public:
+		/**
+		 * @param index The index of the slope among all those being counted
+		 * @param right How far each step goes right, which must be less than the width of the grid
+		 */
+		void add(std::size_t index, std::size_t right) {
+			this->indices.push_back(index);
+			this->rights.push_back(right);
+			this->columns.push_back(0);
+			this->numTrees.push_back(0);
+		}
+
+		/**
+		 * Move every slope of the group down through some of the rows of a grid, probing each row it lands on. Each
+		 * slope goes through all of the rows in turn, so that where it is stays in registers, and the rows stay in
+		 * cache for the next slope.
+		 * @param grid The grid
+		 * @param firstRow The first row that the group's slopes land on
+		 * @param end The row to stop before
+		 * @param down How many rows each step goes down
+		 */
+		void visitRows(const TreeGrid &grid, std::size_t firstRow, std::size_t end, std::size_t down) {
+			const std::uint64_t *rows = grid.rows.data();
+			std::size_t wordsPerRow = grid.wordsPerRow;
+			std::size_t width = grid.width;
+			for (std::size_t i = 0; i < this->columns.size(); i++) {
+				std::size_t column = this->columns[i];
+				std::size_t right = this->rights[i];
+				std::uint64_t numTrees = 0;
+				for (std::size_t row = firstRow; row < end; row += down) {
+					numTrees += rows[row * wordsPerRow + column / WORD_BITS] >> column % WORD_BITS & 1;
+					column += right;
+					column = column >= width ? column - width : column;
+				}
+
+				this->columns[i] = column;
+				this->numTrees[i] += numTrees;
+			}
+		}
+
+		/**
+		 * @param numTrees Where to write the number of trees on each slope, by its index
+		 */
+		void collectTrees(std::vector<std::uint64_t> &numTrees) const {
+			for (std::size_t i = 0; i < this->indices.size(); i++) {
+				numTrees[this->indices[i]] = this->numTrees[i];
+			}
+		}
+
+	 private:
+		std::vector<std::size_t> indices;
+		std::vector<std::size_t> rights;
+		std::vector<std::size_t> columns;
+		std::vector<std::uint64_t> numTrees;
+	};
+
+	std::size_t width = 0;
+	std::size_t height = 0;
+	std::size_t wordsPerRow = 0;
+	std::vector<std::uint64_t> rows;
+
+	/**
+	 * Parse the grid, a lane of tiles at a time. This is always inlined into its callers, so that it gets compiled for
+	 * whatever instruction set each of them targets.
+	 * @tparam findTrees Finds the trees in a lane, given its size, and may read all LANE_WIDTH bytes of it
+	 * @param text The rows of the grid, one per line, which may end in CRLF
+	 * @return TreeGrid The grid
+	 * @throws std::invalid_argument if the rows aren't all the same, nonzero, width, or have anything but trees and
+	 * open squares
+	 */
+	template <std::uint32_t (*findTrees)(const char *, std::size_t, std::uint32_t &)>
+	__attribute__((always_inline)) static TreeGrid parseWith(std::string_view text) {
+		TreeGrid grid;
+		// A trailing newline (or blank line) doesn't make an empty row
+		while (!text.empty() && (text.back() == '\n' || text.back() == '\r')) {
+			text.remove_suffix(1);
+		}
+		if (text.empty()) {
+			return grid;
+		}
+
+		// Rows end in whatever the first one does, so that CRLF inputs are read like any other
+		std::size_t firstNewline = std::min(text.find('\n'), text.size());
+		std::string_view lineEnd = firstNewline > 0 && text[firstNewline - 1] == '\r' ? "\r\n" : "\n";
+		grid.width = firstNewline - (lineEnd.size() - 1);
+		if (grid.width == 0) {
+			throw std::invalid_argument("The grid has no columns");
+		}
+
+		grid.wordsPerRow = (grid.width + WORD_BITS - 1) / WORD_BITS;
+		// Every row is the same width, so this is exact for a valid grid
+		std::size_t rowStride = grid.width + lineEnd.size();
+		grid.rows.reserve((text.size() / rowStride + 1) * grid.wordsPerRow);
+		std::uint32_t invalid = 0;
+		for (std::size_t rowStart = 0; rowStart < text.size(); rowStart += rowStride) {
+			std::size_t rowEnd = rowStart + grid.width;
+			if (rowEnd > text.size() || (rowEnd < text.size() && text.substr(rowEnd, lineEnd.size()) != lineEnd)) {
+				throw std::invalid_argument("Every row of the grid must be the same width");
+			}
+
+			for (std::size_t wordStart = rowStart; wordStart < rowEnd; wordStart += WORD_BITS) {
+				std::uint64_t word = 0;
+				for (std::size_t laneStart = wordStart; laneStart < std::min(wordStart + WORD_BITS, rowEnd);
+					 laneStart += LANE_WIDTH) {
+					std::size_t laneSize = std::min(LANE_WIDTH, rowEnd - laneStart);
+					// A full lane reads past a short row into the rows after it, but it must not read past the text
+					std::uint32_t trees = laneStart + LANE_WIDTH <= text.size()
+											  ? findTrees(text.data() + laneStart, laneSize, invalid)
+											  : findTreesScalar(text.data() + laneStart, laneSize, invalid);
+					word |= static_cast<std::uint64_t>(trees) << (laneStart - wordStart);
+				}
+
+				grid.rows.push_back(word);
+			}
+
+			grid.height++;
+		}
+
+		if (invalid != 0) {
+			throw std::invalid_argument("Invalid tile in the grid");
+		}
+
+		return grid;
+	}
+
+#if defined(__x86_64__)
+	__attribute__((target("avx2"))) static TreeGrid parseAVX2(std::string_view text) {
+		return parseWith<findTreesAVX2>(text);
+	}
+#endif
+};
+
+/**
+ * Parse a file of slopes
+ * @param text The slopes, one per line
+ * @return std::vector<Slope> The slopes, in order
+ * @throws std::invalid_argument if any line isn't a valid slope
+ */
+std::vector<Slope> parseSlopes(std::string_view text) {
+	std::vector<Slope> slopes;
+	for (std::string_view line : MappedInput::splitLines(text)) {
+		slopes.push_back(Slope::parse(line));
+	}
+
+	return slopes;
 }
 
-int part1(const std::vector<std::string> &input) {
-	return findNumTrees(input, 3);
+/**
+ * Count the trees on many slopes, and write one line for each slope, in order, with how far it goes right and down,
+ * and the number of trees on it, separated by tabs
+ * @param os The stream to write to
+ * @param grid The grid
+ * @param slopes The slopes
+ */
+void answerSlopes(std::ostream &os, const TreeGrid &grid, const std::vector<Slope> &slopes) {
+	std::vector<std::uint64_t> numTrees = grid.countTrees(slopes);
+	for (std::size_t i = 0; i < slopes.size(); i++) {
+		os << slopes[i].getRight() << '\t' << slopes[i].getDown() << '\t' << numTrees[i] << '\n';
+	}
+
+	os.flush();
 }
 
-long part2(const std::vector<std::string> &input) {
-	// deltas in the x and y directions respectively
-	std::vector<std::pair<int, int>> deltas{
-		std::pair<int, int>(1, 1),
-		std::pair<int, int>(3, 1),
-		std::pair<int, int>(5, 1),
-		std::pair<int, int>(7, 1),
-		std::pair<int, int>(1, 2),
-	};
+std::uint64_t part1(const TreeGrid &grid) {
+	return grid.countTrees({Slope(3, 1)}).front();
+}
+
+std::uint64_t part2(const TreeGrid &grid) {
+	std::vector<Slope> slopes{Slope(1, 1), Slope(3, 1), Slope(5, 1), Slope(7, 1), Slope(1, 2)};
+	std::uint64_t product = 1;
+	for (std::uint64_t numTrees : grid.countTrees(slopes)) {
+		product *= numTrees;
+	}
+
+	return product;
+}
 
-	return std::reduce(
-		std::execution::par, deltas.begin(), deltas.end(), 1L, [&](long total, std::pair<int, int> step_deltas) {
-			return total * findNumTrees(input, step_deltas.first, step_deltas.second);
-		});
+void solve(PhaseRunner &runner, const MappedInput &input) {
+	TreeGrid grid = runner.phase("parse", [&input]() { return TreeGrid::parse(input.getContents()); });
+	runner.answers(
+		{"part1", "part2"},
+		[&grid]() { return part1(grid); },
+		[&grid]() { return part2(grid); });
 }
 
+}  // namespace day3
+
+#ifndef AOC_NO_MAIN
 int main(int argc, char *argv[]) {
-	if (argc != 2) {
-		std::cerr << argv[0] << " <input_file>" << std::endl;
+	std::vector<char *> remainingArgs{argv[0]};
+	std::optional<std::string> slopesFilename;
+	for (int i = 1; i < argc; i++) {
+		if (argv[i] == std::string_view(day3::SLOPES_FLAG) && i + 1 < argc) {
+			slopesFilename = argv[++i];
+		} else {
+			remainingArgs.push_back(argv[i]);
+		}
+	}
+
+	if (!slopesFilename) {
+		return runSolver(argc, argv, day3::solve);
+	}
+
+	try {
+		RunOptions options = RunOptions::parse(remainingArgs.size(), remainingArgs.data());
+		if (options.getPositional().size() != 1 || options.getWithTimings() || options.getCacheDirectory()
+			|| options.getTraceFilename()) {
+			throw std::invalid_argument(std::string(day3::SLOPES_FLAG) + " takes a single input file, and no options");
+		}
+
+		// The grid is parsed once, and every slope is counted in the same pass over it
+		day3::TreeGrid grid = day3::TreeGrid::parse(MappedInput(options.getPositional().front()).getContents());
+		day3::answerSlopes(std::cout, grid, day3::parseSlopes(MappedInput(*slopesFilename).getContents()));
+	} catch (const std::exception &e) {
+		std::cerr << e.what() << std::endl;
+		std::cerr << argv[0] << " " << day3::SLOPES_FLAG << " <slopes_file> <input_file>" << std::endl;
 		return 1;
 	}
 
-	auto input = readInput(argv[1]);
-	std::cout << part1(input) << std::endl;
-	std::cout << part2(input) << std::endl;
+	return 0;
 }
+#endif
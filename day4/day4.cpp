@@ -1,16 +1,22 @@
 #include <folly/String.h>
 
-#include <boost/algorithm/string.hpp>
-#include <fstream>
+#include <algorithm>
+#include <functional>
 #include <iostream>
 #include <iterator>
 #include <map>
-#include <regex>
 #include <set>
-#include <sstream>
-#include <streambuf>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 #include <vector>
 
+#include "../common/input.hpp"
+#include "../common/pattern.hpp"
+#include "../common/solver.hpp"
+
+namespace day4 {
+
 // Forward declarations of validators are needed for FIELD_VALIDATORS
 // Technically this might go in a .hpp file but eh, this is a single file solution...
 bool isValidBirthYear(int year);
@@ -24,8 +30,9 @@ bool isValidPassportNumber(const std::string &height);
 // cid is not required
 const std::set<std::string> REQUIRED_FIELDS{"byr", "iyr", "eyr", "hgt", "hcl", "ecl", "pid"};
 const std::set<std::string> VALID_EYE_COLORS{"amb", "blu", "brn", "gry", "grn", "hzl", "oth"};
-const std::string PASSPORT_DELIM = "\n\n";
-const std::string PASSPORT_FIELD_DELIM = ":";
+constexpr char PASSPORT_FIELD_PATTERN[] = "{str}:{str}";
+constexpr int HAIR_COLOR_LENGTH = 6;
+constexpr int PASSPORT_NUMBER_LENGTH = 9;
 const auto FIELD_VALIDATORS = std::map<std::string, std::function<bool(const std::string &)>>{
 	{"byr", [](const std::string &value) { return isValidBirthYear(std::stoi(value)); }},
 	{"iyr", [](const std::string &value) { return isValidIssueYear(std::stoi(value)); }},
@@ -37,13 +44,6 @@ const auto FIELD_VALIDATORS = std::map<std::string, std::function<bool(const std
 	{"cid", [](const std::string &value) { return true; }},
 };
 
-std::string readInput(const std::string &filename) {
-	std::vector<std::string> input;
-	std::string line;
-	std::ifstream file(filename);
-	return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
-}
-
 /**
  * Check if the given passport has all of the required fields
  * @param passport The passport to check
@@ -68,41 +68,29 @@ bool hasRequiredFields(const std::map<std::string, std::string> &passport) {
 	return missingFields.empty();
 }
 
-/**
- * Get each individual passport as a vector of strings
- * @param input The passport raw from the file
- * @return std::vector<std::string> All of the passports as strings
- */
-std::vector<std::string> getPassportStrings(const std::string &input) {
-	std::vector<std::string> passports;
-	folly::split(PASSPORT_DELIM, input, passports);
-	for (std::string &passport : passports) {
-		boost::algorithm::trim(passport);
-		std::replace(passport.begin(), passport.end(), '\n', ' ');
-	}
-
-	return passports;
-}
-
 /**
  * Make a vector of maps of all of the passports
- * @param input The raw input from the file
+ * @param passports The passports from the input, each as the lines of its block
  * @return std::vector<std::map<std::string, std::string>> All of the passports, turned into a vector of key -> value
  * form
  */
-std::vector<std::map<std::string, std::string>> makePassportMaps(const std::string &input) {
-	std::vector<std::string> passports = getPassportStrings(input);
+std::vector<std::map<std::string, std::string>> makePassportMaps(
+	const std::vector<std::vector<std::string_view>> &passports) {
 	std::vector<std::map<std::string, std::string>> passportMaps;
-	for (const std::string &passport : passports) {
-		std::vector<std::string> entries;
-		folly::split(" ", passport, entries);
-
+	for (const std::vector<std::string_view> &passport : passports) {
 		// Make a map of all of the entries in this pasport
 		std::map<std::string, std::string> passportMap;
-		for (const std::string &entry : entries) {
-			std::vector<std::string> parts;
-			folly::split(PASSPORT_FIELD_DELIM, entry, parts);
-			passportMap.insert(std::pair<std::string, std::string>(parts.at(0), parts.at(1)));
+		for (std::string_view passportLine : passport) {
+			std::vector<std::string> entries;
+			folly::split(" ", passportLine, entries, true);
+			for (const std::string &entry : entries) {
+				auto parts = LinePattern<PASSPORT_FIELD_PATTERN>::match(entry);
+				if (!parts) {
+					throw std::invalid_argument("Invalid passport field");
+				}
+
+				passportMap.emplace(std::get<0>(*parts), std::get<1>(*parts));
+			}
 		}
 
 		passportMaps.push_back(passportMap);
@@ -137,8 +125,10 @@ bool isValidHeight(const std::string &height) {
 }
 
 bool isValidHairColor(const std::string &color) {
-	std::regex expression("#[0-9a-f]{6}");
-	return std::regex_match(color, expression);
+	return color.size() == HAIR_COLOR_LENGTH + 1 && color.front() == '#' &&
+		   std::all_of(color.cbegin() + 1, color.cend(), [](char c) {
+			   return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f');
+		   });
 }
 
 bool isValidEyeColor(const std::string &color) {
@@ -146,8 +136,8 @@ bool isValidEyeColor(const std::string &color) {
 }
 
 bool isValidPassportNumber(const std::string &num) {
-	std::regex expression("[0-9]{9}");
-	return std::regex_match(num, expression);
+	return num.size() == PASSPORT_NUMBER_LENGTH &&
+		   std::all_of(num.cbegin(), num.cend(), [](char c) { return c >= '0' && c <= '9'; });
 }
 
 bool isFieldValid(const std::string &fieldName, const std::string &value) {
@@ -189,14 +179,18 @@ int part2(const std::vector<std::map<std::string, std::string>> &passports) {
 	return count;
 }
 
-int main(int argc, char *argv[]) {
-	if (argc != 2) {
-		std::cerr << argv[0] << " <input_file>" << std::endl;
-		return 1;
-	}
+void solve(PhaseRunner &runner, const MappedInput &input) {
+	auto passports = runner.phase("parse", [&input]() { return makePassportMaps(input.getBlocks()); });
+	runner.answers(
+		{"part1", "part2"},
+		[&passports]() { return part1(passports); },
+		[&passports]() { return part2(passports); });
+}
 
-	std::string input = readInput(argv[1]);
-	auto passports = makePassportMaps(input);
-	std::cout << part1(passports) << std::endl;
-	std::cout << part2(passports) << std::endl;
+}  // namespace day4
+
+#ifndef AOC_NO_MAIN
+int main(int argc, char *argv[]) {
+	return runSolver(argc, argv, day4::solve);
 }
+#endif
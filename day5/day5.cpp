@@ -1,11 +1,18 @@
 #include <algorithm>
+#include <array>
 #include <execution>
-#include <fstream>
 #include <iostream>
 #include <numeric>
 #include <string_view>
 #include <vector>
 
+#include "../common/embedded.hpp"
+#include "../common/input.hpp"
+#include "../common/solver.hpp"
+#include "../common/stream.hpp"
+
+namespace day5 {
+
 // The maximum row of the plane
 constexpr int MAX_ROW = 127;
 constexpr int MAX_COL = 7;
@@ -13,17 +20,7 @@ constexpr char FRONT_CHAR = 'F';
 constexpr char BACK_CHAR = 'B';
 constexpr char RIGHT_CHAR = 'R';
 constexpr char LEFT_CHAR = 'L';
-
-std::vector<std::string> readInput(const std::string &filename) {
-	std::vector<std::string> input;
-	std::string line;
-	std::ifstream file(filename);
-	while (std::getline(file, line)) {
-		input.push_back(line);
-	}
-
-	return input;
-}
+constexpr int NUM_SEATS = (MAX_ROW + 1) * (MAX_COL + 1);
 
 /**
  * Get the position of a row or a column from a string spec.
@@ -33,7 +30,7 @@ std::vector<std::string> readInput(const std::string &filename) {
  * @param initMax The initial maximum value for the unit being checked (row or column).
  * @return int The row/column position from the spec.
  */
-int getPosFromSpec(std::string_view spec, char bottomHalfChar, char topHalfChar, int initMax) {
+constexpr int getPosFromSpec(std::string_view spec, char bottomHalfChar, char topHalfChar, int initMax) {
 	int max = initMax;
 	int min = 0;
 	for (char candidate : spec) {
@@ -52,7 +49,7 @@ int getPosFromSpec(std::string_view spec, char bottomHalfChar, char topHalfChar,
  * @param seatSpec The specification for the seat
  * @return int The index at which rows stop being specified
  */
-int getColumnSplitPoint(std::string_view seatSpec) {
+constexpr int getColumnSplitPoint(std::string_view seatSpec) {
 	int rightPosition = seatSpec.find(RIGHT_CHAR);
 	int leftPosition = seatSpec.find(LEFT_CHAR);
 	if (rightPosition == std::string_view::npos) {
@@ -69,7 +66,7 @@ int getColumnSplitPoint(std::string_view seatSpec) {
  * @param seatSpec The specification for the seat specification
  * @return int The seatID given by seatSpec
  */
-int parseSeatID(std::string_view seatSpec) {
+constexpr int parseSeatID(std::string_view seatSpec) {
 	int columnSplitPoint = getColumnSplitPoint(seatSpec);
 	std::string_view rowSpec = seatSpec.substr(0, columnSplitPoint);
 	std::string_view colSpec = seatSpec.substr(columnSplitPoint);
@@ -102,16 +99,16 @@ typename std::iterator_traits<Iter>::value_type findMissingNumber(Iter begin, It
 	throw std::invalid_argument("No missing number in iterator");
 }
 
-int part1(const std::vector<std::string> &input) {
-	return std::accumulate(input.cbegin(), input.cend(), 0, [](int max, const std::string &row) {
+int part1(const std::vector<std::string_view> &input) {
+	return std::accumulate(input.cbegin(), input.cend(), 0, [](int max, std::string_view row) {
 		int seatId = parseSeatID(row);
 		return std::max(seatId, max);
 	});
 }
 
-int part2(const std::vector<std::string> &input) {
+int part2(const std::vector<std::string_view> &input) {
 	std::vector<int> ids;
-	std::transform(input.cbegin(), input.cend(), std::inserter(ids, ids.begin()), [](const std::string &input) {
+	std::transform(input.cbegin(), input.cend(), std::inserter(ids, ids.begin()), [](std::string_view input) {
 		return parseSeatID(input);
 	});
 	std::sort(ids.begin(), ids.end());
@@ -119,13 +116,95 @@ int part2(const std::vector<std::string> &input) {
 	return findMissingNumber(ids.begin(), ids.end());
 }
 
-int main(int argc, char *argv[]) {
-	if (argc != 2) {
-		std::cerr << argv[0] << " <input_file>" << std::endl;
-		return 1;
+/**
+ * Keeps track of the seats that have been seen so far, so that both parts can be answered without keeping every seat
+ * spec around. Everything it does can be done at compile time.
+ */
+class SeatTracker {
+ public:
+	/**
+	 * Mark a seat as taken
+	 * @param seatSpec The specification of the seat
+	 */
+	constexpr void add(std::string_view seatSpec) {
+		int seatID = parseSeatID(seatSpec);
+		this->seen.at(seatID) = true;
+		this->minSeatID = std::min(seatID, this->minSeatID);
+		this->maxSeatID = std::max(seatID, this->maxSeatID);
+	}
+
+	constexpr int getMaxSeatID() const {
+		return this->maxSeatID;
+	}
+
+	/**
+	 * Find the first seat after the lowest taken seat that isn't taken, as findMissingNumber would
+	 * @return int The ID of the missing seat
+	 * @throws invalid_argument if there is no missing seat
+	 */
+	constexpr int findMissingSeatID() const {
+		for (int seatID = this->minSeatID + 1; seatID <= this->maxSeatID; seatID++) {
+			if (!this->seen[seatID]) {
+				return seatID;
+			}
+		}
+
+		throw std::invalid_argument("No missing seat");
 	}
 
-	auto input = readInput(argv[1]);
-	std::cout << part1(input) << std::endl;
-	std::cout << part2(input) << std::endl;
+ private:
+	std::array<bool, NUM_SEATS> seen{};
+	int minSeatID = NUM_SEATS;
+	int maxSeatID = 0;
+};
+
+void solve(PhaseRunner &runner, const MappedInput &input) {
+	auto lines = runner.phase("parse", [&input]() { return input.getLines(); });
+	runner.answers(
+		{"part1", "part2"},
+		[&lines]() { return part1(lines); },
+		[&lines]() { return part2(lines); });
+}
+
+void solveStream(PhaseRunner &runner, LineStream &stream) {
+	auto tracker = runner.phase("stream", [&stream]() {
+		SeatTracker tracker;
+		stream.forEachLine([&tracker](std::string_view seatSpec) { tracker.add(seatSpec); });
+
+		return tracker;
+	});
+	runner.answers(
+		{"part1", "part2"},
+		[&tracker]() { return tracker.getMaxSeatID(); },
+		[&tracker]() { return tracker.findMissingSeatID(); });
+}
+
+/**
+ * Solve both parts of an embedded input at compile time, as solveStream would
+ * @param input The puzzle input
+ * @return std::array<int, 2> The answer to each part
+ */
+constexpr std::array<int, 2> solveConstexpr(std::string_view input) {
+	SeatTracker tracker;
+	forEachLineConstexpr(input, [&tracker](std::string_view seatSpec) { tracker.add(seatSpec); });
+
+	return {tracker.getMaxSeatID(), tracker.findMissingSeatID()};
+}
+
+}  // namespace day5
+
+#ifndef AOC_NO_MAIN
+#ifdef AOC_EMBEDDED_INPUT
+#include AOC_EMBEDDED_INPUT
+
+int main() {
+	// Both answers are found while compiling, so all that's left is to print them
+	constexpr auto answers = day5::solveConstexpr(EMBEDDED_INPUT);
+	return printEmbeddedAnswers(answers);
+}
+#else
+int main(int argc, char *argv[]) {
+	return runSolver(argc, argv, day5::solve, day5::solveStream);
 }
+#endif
+#endif
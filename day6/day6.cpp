@@ -1,52 +1,21 @@
-#include <folly/String.h>
-
 #include <algorithm>
 #include <execution>
-#include <fstream>
 #include <iostream>
 #include <numeric>
 #include <set>
 #include <string_view>
 #include <vector>
 
-std::vector<std::string> readInput(const std::string &filename) {
-	std::vector<std::string> input;
-	std::string line;
-	std::ifstream file(filename);
-	while (std::getline(file, line)) {
-		input.push_back(line);
-	}
-
-	return input;
-}
-
-/**
- * Separate the inputs into groups - each inner vector is a list of lines within that group (separated by newlines)
- * @param input The puzzle input
- * @return std::vector<std::vector<std::string>> The inputs grouped by newlines
- */
-std::vector<std::vector<std::string>> getGroups(const std::vector<std::string> &input) {
-	std::vector<std::vector<std::string>> groups;
-	std::vector<std::string> currentGroup;
-	for (std::string line : input) {
-		if (line.length() == 0) {
-			groups.push_back(currentGroup);
-			currentGroup.clear();
-			continue;
-		}
+#include "../common/input.hpp"
+#include "../common/solver.hpp"
 
-		currentGroup.push_back(line);
-	}
+namespace day6 {
 
-	groups.push_back(currentGroup);
-	return groups;
-}
-
-int part1(const std::vector<std::vector<std::string>> &groups) {
+int part1(const std::vector<std::vector<std::string_view>> &groups) {
 	int total = 0;
-	for (const std::vector<std::string> &group : groups) {
+	for (const std::vector<std::string_view> &group : groups) {
 		std::set<char> groupAnswers;
-		for (const std::string &personAnswers : group) {
+		for (std::string_view personAnswers : group) {
 			std::for_each(personAnswers.cbegin(), personAnswers.cend(), [&groupAnswers](char answer) {
 				groupAnswers.insert(answer);
 			});
@@ -57,7 +26,7 @@ int part1(const std::vector<std::vector<std::string>> &groups) {
 	return total;
 }
 
-int part2(const std::vector<std::vector<std::string>> &groups) {
+int part2(const std::vector<std::vector<std::string_view>> &groups) {
 	int total = 0;
 	// Make a set of all possible answers, from a to z.
 	std::set<char> allPossibleAnswers;
@@ -65,14 +34,14 @@ int part2(const std::vector<std::vector<std::string>> &groups) {
 		allPossibleAnswers.insert(i);
 	}
 
-	for (const std::vector<std::string> &group : groups) {
+	for (const std::vector<std::string_view> &group : groups) {
 		// Not technically needed for the problem but it would be incorrect if this happened :) total would add 26.
 		if (group.size() == 0) {
 			continue;
 		}
 		// Copy all possible answers so we can produce a set intersection with them
 		std::set<char> commonAnswers(allPossibleAnswers);
-		for (const std::string &rawPersonAnswers : group) {
+		for (std::string_view rawPersonAnswers : group) {
 			// Get a set of this person's answers
 			std::set<char> personAnswers;
 			std::for_each(rawPersonAnswers.cbegin(), rawPersonAnswers.cend(), [&personAnswers](char answer) {
@@ -97,14 +66,18 @@ int part2(const std::vector<std::vector<std::string>> &groups) {
 	return total;
 }
 
-int main(int argc, char *argv[]) {
-	if (argc != 2) {
-		std::cerr << argv[0] << " <input_file>" << std::endl;
-		return 1;
-	}
+void solve(PhaseRunner &runner, const MappedInput &input) {
+	auto groups = runner.phase("parse", [&input]() { return input.getBlocks(); });
+	runner.answers(
+		{"part1", "part2"},
+		[&groups]() { return part1(groups); },
+		[&groups]() { return part2(groups); });
+}
+
+}  // namespace day6
 
-	auto input = readInput(argv[1]);
-	auto groups = getGroups(input);
-	std::cout << part1(groups) << std::endl;
-	std::cout << part2(groups) << std::endl;
+#ifndef AOC_NO_MAIN
+int main(int argc, char *argv[]) {
+	return runSolver(argc, argv, day6::solve);
 }
+#endif
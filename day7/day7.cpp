@@ -2,17 +2,23 @@
 
 #include <algorithm>
 #include <execution>
-#include <fstream>
 #include <iostream>
 #include <map>
 #include <numeric>
-#include <regex>
 #include <set>
+#include <stack>
 #include <string_view>
 #include <vector>
 
-auto constexpr LINE_PATTERN = R"((.*) bags? contain (.*)\.)";
-auto constexpr BAG_PATTERN = R"((\d) (.*) bags?)";
+#include "../common/input.hpp"
+#include "../common/pattern.hpp"
+#include "../common/solver.hpp"
+
+namespace day7 {
+
+constexpr char LINE_PATTERN[] = "{str} bags contain {str}.";
+constexpr char BAG_PATTERN[] = "{int} {str} bag";
+constexpr char PLURAL_BAG_PATTERN[] = "{int} {str} bags";
 auto constexpr NO_OTHER_BAGS = "no other bags";
 auto constexpr BAG_DELIM = ", ";
 auto constexpr DESIRED_BAG = "shiny gold";
@@ -45,31 +51,18 @@ class ContainedBag {
 // I would use a set for the value but I don't want to deal with hash functions right now
 using BagMap = std::map<std::string, std::vector<ContainedBag>>;
 
-std::vector<std::string> readInput(const std::string &filename) {
-	std::vector<std::string> input;
-	std::string line;
-	std::ifstream file(filename);
-	while (std::getline(file, line)) {
-		input.push_back(line);
-	}
-
-	return input;
-}
-
 /**
  * Parse the input line into a bag and its contents
  * @param line A line of input
  * @return std::pair<std::string, std::vector<ContainedBag>> A bag, and the bags it contains
  */
-std::pair<std::string, std::vector<ContainedBag>> parseInputLine(const std::string &line) {
-	std::regex lineExpression(LINE_PATTERN);
-	std::smatch lineMatches;
-	if (!std::regex_match(line, lineMatches, lineExpression)) {
+std::pair<std::string, std::vector<ContainedBag>> parseInputLine(std::string_view line) {
+	auto lineMatches = LinePattern<LINE_PATTERN>::match(line);
+	if (!lineMatches) {
 		throw new std::invalid_argument("Invalid input line");
 	}
 
-	std::string bagName = lineMatches[1];
-	std::string allUnparsedBags = lineMatches[2];
+	auto [bagName, allUnparsedBags] = *lineMatches;
 	std::vector<std::string> unparsedBags;
 	folly::split(BAG_DELIM, allUnparsedBags, unparsedBags);
 	std::vector<ContainedBag> containedBags;
@@ -80,14 +73,16 @@ std::pair<std::string, std::vector<ContainedBag>> parseInputLine(const std::stri
 		}
 
 		// Check for some quantity of bags contained
-		std::regex bagExpression(BAG_PATTERN);
-		std::smatch bagMatches;
-		if (!std::regex_match(unparsedBag, bagMatches, bagExpression)) {
+		auto bagMatches = LinePattern<PLURAL_BAG_PATTERN>::match(unparsedBag);
+		if (!bagMatches) {
+			bagMatches = LinePattern<BAG_PATTERN>::match(unparsedBag);
+		}
+		if (!bagMatches) {
 			throw new std::invalid_argument("Invalid bagspec");
 		}
 
-		ContainedBag containedBag(bagMatches[2], std::stoi(bagMatches[1]));
-		containedBags.push_back(containedBag);
+		auto [quantity, color] = *bagMatches;
+		containedBags.emplace_back(std::string(color), quantity);
 	}
 
 	return std::pair<std::string, std::vector<ContainedBag>>(bagName, containedBags);
@@ -98,9 +93,9 @@ std::pair<std::string, std::vector<ContainedBag>> parseInputLine(const std::stri
  * @param input The input for the puzzle
  * @return BagMap A map of bags to their children
  */
-BagMap makeBagMap(const std::vector<std::string> &input) {
+BagMap makeBagMap(const std::vector<std::string_view> &input) {
 	std::map<std::string, std::vector<ContainedBag>> bags;
-	std::transform(input.cbegin(), input.cend(), std::inserter(bags, bags.begin()), [](const std::string &line) {
+	std::transform(input.cbegin(), input.cend(), std::inserter(bags, bags.begin()), [](std::string_view line) {
 		return parseInputLine(line);
 	});
 
@@ -178,16 +173,19 @@ int recursivePart2(const BagMap &bagMap, const std::string &toVisit = DESIRED_BA
 	});
 }
 
-int main(int argc, char *argv[]) {
-	if (argc != 2) {
-		std::cerr << argv[0] << " <input_file>" << std::endl;
-		return 1;
-	}
+void solve(PhaseRunner &runner, const MappedInput &input) {
+	auto bagMap = runner.phase("parse", [&input]() { return makeBagMap(input.getLines()); });
+	runner.answers(
+		{"part1", "part2", "recursivePart2"},
+		[&bagMap]() { return part1(bagMap); },
+		[&bagMap]() { return part2(bagMap); },
+		[&bagMap]() { return recursivePart2(bagMap); });
+}
 
-	auto input = readInput(argv[1]);
+}  // namespace day7
 
-	auto bagMap = makeBagMap(input);
-	std::cout << part1(bagMap) << std::endl;
-	std::cout << part2(bagMap) << std::endl;
-	std::cout << recursivePart2(bagMap) << std::endl;
+#ifndef AOC_NO_MAIN
+int main(int argc, char *argv[]) {
+	return runSolver(argc, argv, day7::solve);
 }
+#endif
@@ -2,7 +2,6 @@
 
 #include <algorithm>
 #include <execution>
-#include <fstream>
 #include <iostream>
 #include <map>
 #include <numeric>
@@ -11,6 +10,11 @@
 #include <string_view>
 #include <vector>
 
+#include "../common/input.hpp"
+#include "../common/solver.hpp"
+
+namespace day8 {
+
 constexpr auto ACCUMULATOR_INSTRUCTION = "acc";
 constexpr auto JUMP_INSTRUCTION = "jmp";
 constexpr auto NOP_INSTRUCTION = "nop";
@@ -40,26 +44,15 @@ class ProgramLine {
 	int value;
 };
 
-std::vector<std::string> readInput(const std::string &filename) {
-	std::vector<std::string> input;
-	std::string line;
-	std::ifstream file(filename);
-	while (std::getline(file, line)) {
-		input.push_back(line);
-	}
-
-	return input;
-}
-
 /**
  * Convert the input to ProgramLines
  * @param input The puzzle input
  * @return std::vector<ProgramLine> The input as ProgramLines
  */
-std::vector<ProgramLine> parseProgramLines(const std::vector<std::string> &input) {
+std::vector<ProgramLine> parseProgramLines(const std::vector<std::string_view> &input) {
 	std::vector<ProgramLine> lines;
 	lines.reserve(input.size());
-	std::transform(input.cbegin(), input.cend(), std::back_inserter(lines), [](const std::string &line) {
+	std::transform(input.cbegin(), input.cend(), std::back_inserter(lines), [](std::string_view line) {
 		std::vector<std::string> lineComponents;
 		folly::split(" ", line, lineComponents);
 		if (lineComponents.size() > 2) {
@@ -130,15 +123,18 @@ int part2(const std::vector<ProgramLine> &lines) {
 	throw new std::invalid_argument("No solution in input");
 }
 
-int main(int argc, char *argv[]) {
-	if (argc != 2) {
-		std::cerr << argv[0] << " <input_file>" << std::endl;
-		return 1;
-	}
+void solve(PhaseRunner &runner, const MappedInput &input) {
+	auto programLines = runner.phase("parse", [&input]() { return parseProgramLines(input.getLines()); });
+	runner.answers(
+		{"part1", "part2"},
+		[&programLines]() { return part1(programLines); },
+		[&programLines]() { return part2(programLines); });
+}
 
-	auto input = readInput(argv[1]);
-	auto programLines = parseProgramLines(input);
+}  // namespace day8
 
-	std::cout << part1(programLines) << std::endl;
-	std::cout << part2(programLines) << std::endl;
+#ifndef AOC_NO_MAIN
+int main(int argc, char *argv[]) {
+	return runSolver(argc, argv, day8::solve);
 }
+#endif
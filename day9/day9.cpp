@@ -1,8 +1,5 @@
-#include <folly/String.h>
-
 #include <algorithm>
 #include <execution>
-#include <fstream>
 #include <iostream>
 #include <map>
 #include <numeric>
@@ -11,32 +8,21 @@
 #include <string_view>
 #include <vector>
 
-constexpr int PREAMBLE_SIZE = 25;
+#include "../common/input.hpp"
+#include "../common/integers.hpp"
+#include "../common/solver.hpp"
 
-std::vector<std::string> readInput(const std::string &filename) {
-	std::vector<std::string> input;
-	std::string line;
-	std::ifstream file(filename);
-	while (std::getline(file, line)) {
-		input.push_back(line);
-	}
+namespace day9 {
 
-	return input;
-}
+constexpr int PREAMBLE_SIZE = 25;
 
 /**
- * Convert a vector of strings to a vector of numbers
+ * Convert the input to a vector of numbers
  * @param input The input for the puzzle
  * @return std::vector<long> The puzzle input as numbers
  */
-std::vector<long> convertInputToNumbers(const std::vector<std::string> &input) {
-	std::vector<long> converted;
-	converted.reserve(input.size());
-	std::transform(input.cbegin(), input.cend(), std::back_inserter(converted), [](const std::string &line) {
-		return std::stol(line);
-	});
-
-	return converted;
+std::vector<long> convertInputToNumbers(std::string_view input) {
+	return parseIntegers<long>(input);
 }
 
 long part1(const std::vector<long> &numbers) {
@@ -78,16 +64,16 @@ long part2(const std::vector<long> &numbers, long desired) {
 	throw std::invalid_argument("No solution in input");
 }
 
-int main(int argc, char *argv[]) {
-	if (argc != 2) {
-		std::cerr << argv[0] << " <input_file>" << std::endl;
-		return 1;
-	}
+void solve(PhaseRunner &runner, const MappedInput &input) {
+	auto numbers = runner.phase("parse", [&input]() { return convertInputToNumbers(input.getContents()); });
+	auto part1Answer = runner.answer("part1", [&numbers]() { return part1(numbers); });
+	runner.answer("part2", [&numbers, part1Answer]() { return part2(numbers, part1Answer); });
+}
 
-	auto input = readInput(argv[1]);
-	auto numbers = convertInputToNumbers(input);
+}  // namespace day9
 
-	auto part1Answer = part1(numbers);
-	std::cout << part1Answer << std::endl;
-	std::cout << part2(numbers, part1Answer) << std::endl;
+#ifndef AOC_NO_MAIN
+int main(int argc, char *argv[]) {
+	return runSolver(argc, argv, day9::solve);
 }
+#endif
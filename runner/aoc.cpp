@@ -0,0 +1,76 @@
+#include <charconv>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../common/solver.hpp"
+#include "../common/solvers.hpp"
+
+/**
+ * Find the solvers for a day. Most days have just one, but some (i.e. day 17) have a separate solver for each part.
+ * @param day The day to find the solvers for
+ * @return std::vector<SolveFunction> The solvers for the day, in the order they should be run
+ */
+std::vector<SolveFunction> findDaySolvers(int day) {
+	std::string dayName = "day" + std::to_string(day);
+	std::vector<SolveFunction> daySolvers;
+	for (const auto &solver : SOLVERS) {
+		const std::string &solverName = solver.first;
+		if (solverName == dayName || solverName.rfind(dayName + "p", 0) == 0) {
+			daySolvers.push_back(solver.second);
+		}
+	}
+
+	return daySolvers;
+}
+
+/**
+ * Find the stream solver for a day
+ * @param day The day to find the stream solver for
+ * @return StreamSolveFunction The stream solver, or nullptr if the day can't stream its input
+ */
+StreamSolveFunction findDayStreamSolver(int day) {
+	std::string dayName = "day" + std::to_string(day);
+	for (const auto &solver : STREAM_SOLVERS) {
+		if (solver.first == dayName) {
+			return solver.second;
+		}
+	}
+
+	return nullptr;
+}
+
+int main(int argc, char *argv[]) {
+	std::optional<RunOptions> options;
+	try {
+		options = RunOptions::parse(argc, argv);
+	} catch (const std::exception &e) {
+		std::cerr << e.what() << std::endl;
+	}
+
+	if (!options || options->getPositional().size() < 2) {
+		std::cerr << argv[0] << " [" << TIMINGS_FLAG << "] [" << ALLOCATIONS_FLAG << "] [" << COUNTERS_FLAG << "] ["
+				  << CONCURRENT_FLAG << "] [" << JOBS_FLAG << " n] [" << CACHE_FLAG << " directory] [" << TRACE_FLAG
+				  << " file [" << TRACE_DEPTH_FLAG << " n] [" << TRACE_SAMPLE_FLAG << " n]] <day> "
+				  << "<input_file|input_directory|" << STDIN_INPUT << ">..." << std::endl;
+		return 1;
+	}
+
+	std::string_view rawDay(options->getPositional().front());
+	int day;
+	auto parseResult = std::from_chars(rawDay.data(), rawDay.data() + rawDay.size(), day);
+	std::vector<SolveFunction> daySolvers;
+	if (parseResult.ec == std::errc() && parseResult.ptr == rawDay.data() + rawDay.size()) {
+		daySolvers = findDaySolvers(day);
+	}
+	if (daySolvers.empty()) {
+		std::cerr << "No solver for day " << rawDay << std::endl;
+		return 1;
+	}
+
+	std::vector<std::string> paths(options->getPositional().cbegin() + 1, options->getPositional().cend());
+
+	return runInputs(daySolvers, "day" + std::to_string(day), paths, *options, findDayStreamSolver(day));
+}